@@ -28,6 +28,7 @@ protected:
   std::unique_ptr<jfs::core::SolverResponse>
   fuzz(jfs::core::Query& q, bool produceModel,
        std::shared_ptr<jfs::fuzzingCommon::FuzzingAnalysisInfo> info) override;
+  bool checksConstraintsByCost() const override;
 
 public:
   CXXFuzzingSolver(
@@ -10,10 +10,12 @@
 //===----------------------------------------------------------------------===//
 #ifndef JFS_CXX_FUZZING_BACKEND_FUZZING_SOLVER_OPTIONS_H
 #define JFS_CXX_FUZZING_BACKEND_FUZZING_SOLVER_OPTIONS_H
+#include "jfs/CXXFuzzingBackend/CXXProgramBuilderOptions.h"
 #include "jfs/CXXFuzzingBackend/ClangOptions.h"
 #include "jfs/Core/SolverOptions.h"
 #include "jfs/FuzzingCommon/LibFuzzerOptions.h"
 #include <memory>
+#include <string>
 
 namespace jfs {
 namespace cxxfb {
@@ -23,11 +25,13 @@ private:
   // Options
   std::unique_ptr<ClangOptions> clangOpt;
   std::unique_ptr<jfs::fuzzingCommon::LibFuzzerOptions> libFuzzerOpt;
+  std::unique_ptr<CXXProgramBuilderOptions> programBuilderOpt;
 
 public:
   CXXFuzzingSolverOptions(
       std::unique_ptr<ClangOptions> clangOpt,
-      std::unique_ptr<jfs::fuzzingCommon::LibFuzzerOptions> libFuzzerOpt);
+      std::unique_ptr<jfs::fuzzingCommon::LibFuzzerOptions> libFuzzerOpt,
+      std::unique_ptr<CXXProgramBuilderOptions> programBuilderOpt);
   static bool classof(const SolverOptions* so) {
     return so->getKind() == CXX_FUZZING_SOLVER_KIND;
   }
@@ -38,10 +42,42 @@ public:
   jfs::fuzzingCommon::LibFuzzerOptions* getLibFuzzerOptions() {
     return libFuzzerOpt.get();
   }
+  // FIXME: Not const for the same reason as `getLibFuzzerOptions()`.
+  CXXProgramBuilderOptions* getCXXProgramBuilderOptions() {
+    return programBuilderOpt.get();
+  }
+  const CXXProgramBuilderOptions* getCXXProgramBuilderOptions() const {
+    return programBuilderOpt.get();
+  }
 
   // public for convenience.
   bool redirectClangOutput;
   bool redirectLibFuzzerOutput;
+  // Number of fuzzers to run concurrently. Each worker uses a different
+  // seed and they share a corpus directory. The first worker to find
+  // the target wins and the others are cancelled.
+  unsigned numFuzzingWorkers;
+  // If true workers also use different mutation depth and cross over
+  // settings.
+  bool varyFuzzingWorkerStrategy;
+  // Directory of the persistent compiled program cache. Empty disables the
+  // cache.
+  std::string programCacheDir;
+  // Pipe the program to Clang rather than writing it to the working
+  // directory and put the compiled program on a memory-backed file system.
+  bool pipeSourceToClang;
+  // Before fuzzing, give Z3 this many milliseconds to find a model of the
+  // query without its floating point constraints and add the model to the
+  // corpus. 0 disables this.
+  unsigned relaxedModelSeedTimeout;
+  // Fuzz for this many seconds with a program that counts how many inputs
+  // each constraint rejects, then rebuild the program with the constraints
+  // that reject the most inputs for their cost checked first and continue
+  // fuzzing from the corpus found so far. 0 disables this.
+  unsigned profileWarmUpTime;
+  // Also collect a Clang PGO profile during the warm up and use it to
+  // optimize the rebuilt program.
+  bool profileWarmUpPGO;
 };
 }
 }
@@ -180,25 +180,41 @@ public:
 };
 
 // This is a hack
-// CXXGenericStatement
+// CXXGenericStatement. Can also be used for declarations at the top level of a
+// program.
 class CXXGenericStatement : public CXXStatement {
 private:
   std::string statement;
 
 public:
-  CXXGenericStatement(CXXCodeBlock* parent, llvm::StringRef statement);
+  CXXGenericStatement(CXXDecl* parent, llvm::StringRef statement);
   void print(llvm::raw_ostream&) const override;
 };
 
+class CXXProgram;
+using CXXProgramRef = std::shared_ptr<CXXProgram>;
+
 class CXXProgram : public CXXDecl {
 private:
   typedef std::vector<CXXDeclRef> declStorageTy;
   declStorageTy decls;
+  // Additional translation units that can be compiled separately and then
+  // linked with this one.
+  std::vector<CXXProgramRef> translationUnits;
 
 public:
   CXXProgram() : CXXDecl(nullptr) {}
+  // Prints this program and its additional translation units as a single
+  // source file.
   void print(llvm::raw_ostream&) const override;
+  // Prints just the declarations in this translation unit.
+  void printTranslationUnit(llvm::raw_ostream&) const;
   void appendDecl(CXXDeclRef);
+  void prependDecl(CXXDeclRef);
+  void appendTranslationUnit(CXXProgramRef);
+  const std::vector<CXXProgramRef>& getTranslationUnits() const {
+    return translationUnits;
+  }
   // Iterators
   declStorageTy::const_iterator cbegin() const { return decls.cbegin(); }
   declStorageTy::const_iterator cend() const { return decls.cend(); }
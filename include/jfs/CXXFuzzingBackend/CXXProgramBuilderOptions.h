@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_CXX_FUZZING_BACKEND_CXX_PROGRAM_BUILDER_OPTIONS_H
+#define JFS_CXX_FUZZING_BACKEND_CXX_PROGRAM_BUILDER_OPTIONS_H
+#include "llvm/Support/raw_ostream.h"
+
+namespace jfs {
+namespace cxxfb {
+
+struct CXXProgramBuilderOptions {
+  // How the generated program reports that all constraints are satisfied.
+  enum class FuzzingTargetTy {
+    // Call `abort()`. Used by standalone fuzzing binaries.
+    ABORT,
+    // Call `jfs_libfuzzer_target_found(data, size)`. Used when the program is
+    // built as a shared object and loaded by JFS's copy of LibFuzzer.
+    LIBFUZZER_CALLBACK,
+  };
+  FuzzingTargetTy fuzzingTarget;
+  // Read bitvector (and hence floating point) constants from a table loaded
+  // at fuzzer start up rather than compiling them into the program. Queries
+  // that only differ in their constants then produce identical programs.
+  bool liftConstants;
+  // When greater than one the constraints are split into this many functions,
+  // each in its own translation unit, so they can be compiled concurrently.
+  unsigned numConstraintPartitions;
+  // Define `LLVMFuzzerCustomMutator()` and `LLVMFuzzerCustomCrossOver()` so
+  // that LibFuzzer mutates the input one free variable at a time using
+  // mutations suited to the variable's sort.
+  bool customMutator;
+  // Collect the constants used by the constraints and encode them as
+  // LibFuzzer dictionary entries (see `CXXProgramBuilderPass::getDictionary()`).
+  bool buildDictionary;
+  // Before each constraint that is a bitvector or floating point comparison,
+  // record how far the input is from satisfying it (absolute difference for
+  // bitvectors, ULPs for floats) in LibFuzzer extra counters. Inputs that get
+  // a comparison closer than before are then kept in the corpus.
+  bool distanceFeedback;
+  // Pass the raw bits of the operands of floating point comparisons to
+  // SanitizerCoverage's `trace-cmp` hooks, which can't see them otherwise.
+  bool traceFloatComparisons;
+  // Evaluate every constraint instead of returning at the first one that is
+  // not satisfied. Which constraints are satisfied, and how many, are
+  // recorded in LibFuzzer extra counters so that inputs satisfying more (or
+  // different) constraints are kept in the corpus.
+  bool countSatisfiedConstraints;
+  // Check constraints that are cheap to evaluate and likely to be false
+  // first rather than in query order.
+  bool orderConstraintsByCost;
+  // Count, for each constraint, how many inputs it was the first constraint
+  // not to be satisfied by and write the counts out when the program exits
+  // (see `SMTLIB/RejectionProfile.h`). Ignored when
+  // `countSatisfiedConstraints` is true because then no constraint rejects
+  // an input on its own.
+  bool recordRejections;
+  // Decode each free variable from the buffer right before the first
+  // constraint that uses it rather than all of them up front, so inputs
+  // rejected by early constraints don't pay for decoding the rest.
+  bool lazyDecoding;
+
+  CXXProgramBuilderOptions();
+  void dump() const;
+  void print(llvm::raw_ostream& os) const;
+};
+}
+}
+#endif
@@ -10,9 +10,12 @@
 //===----------------------------------------------------------------------===//
 #ifndef JFS_CXX_FUZZING_BACKEND_CXX_PROGRAM_BUILDER_PASS_H
 #define JFS_CXX_FUZZING_BACKEND_CXX_PROGRAM_BUILDER_PASS_H
+#include "jfs/CXXFuzzingBackend/CXXProgramBuilderOptions.h"
 #include "jfs/Core/JFSContext.h"
+#include "jfs/Core/Z3Node.h"
 #include "jfs/FuzzingCommon/FuzzingAnalysisInfo.h"
 #include "jfs/Transform/QueryPass.h"
+#include <vector>
 
 namespace jfs {
 namespace cxxfb {
@@ -25,14 +28,25 @@ private:
   std::unique_ptr<CXXProgramBuilderPassImpl> impl;
 
 public:
+  // If `options` is nullptr then the default options are used.
   CXXProgramBuilderPass(
       std::shared_ptr<jfs::fuzzingCommon::FuzzingAnalysisInfo> info,
-      jfs::core::JFSContext& ctx);
+      const CXXProgramBuilderOptions* options, jfs::core::JFSContext& ctx);
   ~CXXProgramBuilderPass();
   bool run(jfs::core::Query& q) override;
   virtual llvm::StringRef getName() override;
   // FIXME: Should be a const CXXProgram
   std::shared_ptr<CXXProgram> getProgram();
+  // Values of the constants lifted out of the program. Empty unless
+  // `CXXProgramBuilderOptions::liftConstants` is set.
+  const std::vector<uint64_t>& getConstantTable() const;
+  // LibFuzzer dictionary entries for the constants used by the constraints.
+  // Empty unless `CXXProgramBuilderOptions::buildDictionary` is set.
+  const std::vector<std::vector<uint8_t>>& getDictionary() const;
+  // The constraints in the order that the program checks them. This is the
+  // order of the counts written when
+  // `CXXProgramBuilderOptions::recordRejections` is set.
+  const std::vector<jfs::core::Z3ASTHandle>& getConstraintOrder() const;
 };
 }
 }
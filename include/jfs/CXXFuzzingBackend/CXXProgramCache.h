@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_CXX_FUZZING_BACKEND_CXX_PROGRAM_CACHE_H
+#define JFS_CXX_FUZZING_BACKEND_CXX_PROGRAM_CACHE_H
+#include "jfs/CXXFuzzingBackend/CXXProgram.h"
+#include "jfs/CXXFuzzingBackend/CXXProgramBuilderOptions.h"
+#include "jfs/CXXFuzzingBackend/ClangOptions.h"
+#include "jfs/Core/JFSContext.h"
+#include "llvm/ADT/StringRef.h"
+#include <string>
+
+namespace jfs {
+namespace cxxfb {
+
+// Persistent on-disk cache of compiled fuzzing programs.
+//
+// Entries are content addressed. The key is a hash of the printed program,
+// the Clang options and the program builder options (which select the
+// runtime variant) so structurally identical queries share a binary.
+// Entries are never invalidated so the cache directory must be cleared if
+// the runtime is rebuilt without changing the JFS version.
+class CXXProgramCache {
+private:
+  std::string cacheDir;
+  jfs::core::JFSContext& ctx;
+  std::string getPathForKey(llvm::StringRef key) const;
+
+public:
+  // `cacheDir` is created if it does not exist.
+  CXXProgramCache(llvm::StringRef cacheDir, jfs::core::JFSContext& ctx);
+  std::string computeKey(const CXXProgram* program,
+                         const ClangOptions* clangOptions,
+                         const CXXProgramBuilderOptions* pbOptions) const;
+  // On a hit the cached binary is placed at `outputFile` and its size in
+  // bytes is returned. Returns 0 on a miss.
+  uint64_t lookup(llvm::StringRef key, llvm::StringRef outputFile);
+  // Add the compiled binary at `outputFile` to the cache. Returns true on
+  // success.
+  bool insert(llvm::StringRef key, llvm::StringRef outputFile);
+  llvm::StringRef getCacheDir() const { return cacheDir; }
+};
+}
+}
+#endif
@@ -36,6 +36,13 @@ public:
   bool compile(const CXXProgram* program, llvm::StringRef sourceFile,
                llvm::StringRef outputFile, const ClangOptions* options,
                llvm::StringRef stdOutFile, llvm::StringRef stdErrFile);
+  // Merge the raw Clang PGO profile `rawProfileFile` into `profileFile` so
+  // that it can be used as `ClangOptions::profileInstrUseFile`. Uses the
+  // `llvm-profdata` next to Clang. Returns false if the profile could not be
+  // merged, which is not treated as an error.
+  bool mergeProfile(llvm::StringRef rawProfileFile, llvm::StringRef profileFile,
+                    const ClangOptions* options, llvm::StringRef stdOutFile,
+                    llvm::StringRef stdErrFile);
   void cancel() override;
 };
 }
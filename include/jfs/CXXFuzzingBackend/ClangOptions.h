@@ -25,18 +25,33 @@ struct ClangOptions {
   std::string pathToRuntimeDir;
   std::string pathToRuntimeIncludeDir;
   std::string pathToLibFuzzerLib;
+  // Helper linked against a shared build of LibFuzzer that loads and fuzzes
+  // the program when `buildSharedObject` is true.
+  std::string pathToLibFuzzerInProcessDriver;
+  // Build the fuzzing target as a shared object that is loaded by
+  // `pathToLibFuzzerInProcessDriver` rather than as a standalone executable.
+  bool buildSharedObject;
   enum class OptimizationLevel { O0, O1, O2, O3 };
   OptimizationLevel optimizationLevel;
   bool debugSymbols;
   bool useASan;
   bool useUBSan;
   bool useJFSRuntimeAsserts;
+  // Pass the runtime's precompiled header to clang if one matching these
+  // options exists.
+  bool usePrecompiledHeader;
   enum class SanitizerCoverageTy {
     TRACE_PC_GUARD,
     TRACE_CMP,
     // TODO: Add more
   };
   std::vector<SanitizerCoverageTy> sanitizerCoverageOptions;
+  // Instrument the program to write a Clang PGO profile to this path when it
+  // exits (`-fprofile-instr-generate=`). Not used when empty.
+  std::string profileInstrGenerateFile;
+  // Optimize the program using this merged Clang PGO profile
+  // (`-fprofile-instr-use=`). Not used when empty.
+  std::string profileInstrUseFile;
   enum class LibFuzzerBuildType {
     REL_WITH_DEB_INFO,
   };
@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_CXX_FUZZING_BACKEND_JFS_CXX_FUZZING_DICTIONARY_STAT_H
+#define JFS_CXX_FUZZING_BACKEND_JFS_CXX_FUZZING_DICTIONARY_STAT_H
+#include "jfs/Support/JFSStat.h"
+
+namespace jfs {
+namespace cxxfb {
+class JFSCXXFuzzingDictionaryStat : public jfs::support::JFSStat {
+public:
+  JFSCXXFuzzingDictionaryStat(llvm::StringRef name);
+  virtual ~JFSCXXFuzzingDictionaryStat();
+  void printYAML(llvm::ScopedPrinter& os) const override;
+  static bool classof(const JFSStat* s) {
+    return s->getKind() == CXX_FUZZING_DICTIONARY;
+  }
+
+  // FIXME: Should not be public
+  uint64_t numEntries = 0;
+  // Entries LibFuzzer used at least once. Taken from the fuzzer that found
+  // the target when there are several workers.
+  uint64_t numUsedEntries = 0;
+};
+}
+}
+#endif
@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_CXX_FUZZING_BACKEND_JFS_CXX_FUZZING_WORKERS_STAT_H
+#define JFS_CXX_FUZZING_BACKEND_JFS_CXX_FUZZING_WORKERS_STAT_H
+#include "jfs/Support/JFSStat.h"
+#include <vector>
+
+namespace jfs {
+namespace cxxfb {
+class JFSCXXFuzzingWorkersStat : public jfs::support::JFSStat {
+public:
+  struct WorkerStat {
+    uint64_t seed = 0;
+    uint64_t mutationDepth = 0;
+    bool crossOver = false;
+    uint64_t numExecutedUnits = 0;
+    uint64_t numUsedDictionaryEntries = 0;
+    // Name of the `LibFuzzerResponse::ResponseTy` outcome.
+    std::string outcome;
+  };
+  JFSCXXFuzzingWorkersStat(llvm::StringRef name);
+  virtual ~JFSCXXFuzzingWorkersStat();
+  void printYAML(llvm::ScopedPrinter& os) const override;
+  static bool classof(const JFSStat* s) {
+    return s->getKind() == CXX_FUZZING_WORKERS;
+  }
+
+  // FIXME: Should not be public
+  std::vector<WorkerStat> workers;
+  // Index into `workers` of the worker that found the target. -1 if no worker
+  // found the target.
+  int64_t winningWorker = -1;
+};
+}
+}
+#endif
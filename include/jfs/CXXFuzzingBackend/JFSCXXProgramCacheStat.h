@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_CXX_FUZZING_BACKEND_JFS_CXX_PROGRAM_CACHE_STAT_H
+#define JFS_CXX_FUZZING_BACKEND_JFS_CXX_PROGRAM_CACHE_STAT_H
+#include "jfs/Support/JFSStat.h"
+
+namespace jfs {
+namespace cxxfb {
+class JFSCXXProgramCacheStat : public jfs::support::JFSStat {
+public:
+  JFSCXXProgramCacheStat(llvm::StringRef name);
+  virtual ~JFSCXXProgramCacheStat();
+  void printYAML(llvm::ScopedPrinter& os) const override;
+  static bool classof(const JFSStat* s) {
+    return s->getKind() == CXX_PROGRAM_CACHE;
+  }
+
+  // FIXME: Should not be public
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  // Size of the cached binaries that did not need to be compiled.
+  uint64_t bytesSaved = 0;
+};
+}
+}
+#endif
@@ -30,6 +30,9 @@ public:
   uint64_t numFreeVars = 0;
   uint64_t bufferWidth = 0;
   uint64_t numEqualitySets = 0;
+  uint64_t numDictionaryEntries = 0;
+  uint64_t numDistanceComparisons = 0;
+  uint64_t numExtraCounters = 0;
 };
 }
 }
@@ -0,0 +1,47 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_CORE_PORTFOLIO_SOLVER_H
+#define JFS_CORE_PORTFOLIO_SOLVER_H
+#include "jfs/Core/Solver.h"
+#include <memory>
+
+namespace jfs {
+namespace core {
+
+class PortfolioSolverImpl;
+
+// Runs several solvers concurrently on the same query. The first definitive
+// (i.e. SAT or UNSAT) response wins and the other solvers are cancelled.
+//
+// Z3 contexts are not thread safe so at most one solver may use the
+// portfolio's context. Other solvers must be created with their own context
+// which is handed over to the portfolio in `addSolver()`. Queries are
+// translated into those contexts before any solver starts.
+class PortfolioSolver : public Solver {
+private:
+  const std::unique_ptr<PortfolioSolverImpl> impl;
+
+public:
+  PortfolioSolver(std::unique_ptr<SolverOptions> options, JFSContext& ctx);
+  ~PortfolioSolver();
+  // `solverCtx` must be the context `solver` was created with or nullptr
+  // if `solver` uses the portfolio's context.
+  void addSolver(std::unique_ptr<Solver> solver,
+                 std::unique_ptr<JFSContext> solverCtx);
+  std::unique_ptr<SolverResponse> solve(const Query& q,
+                                        bool produceModel) override;
+  llvm::StringRef getName() const override;
+  void cancel() override;
+};
+}
+}
+
+#endif
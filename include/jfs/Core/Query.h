@@ -31,6 +31,8 @@ public:
   // to accidently be called.
   Query(const Query&&) = delete;
   Query& operator=(const Query&) = delete;
+  // The free variables used by the constraints, sorted by name.
+  std::vector<Z3FuncDeclHandle> getFreeVariables() const;
   void dump() const;
   void print(llvm::raw_ostream& os) const;
   JFSContext& getContext() const { return ctx; }
@@ -22,6 +22,7 @@ namespace core {
 
 
 class Model {
+public:
   virtual Z3ASTHandle getAssignment(Z3FuncDeclHandle) = 0;
 };
 
@@ -19,7 +19,12 @@ namespace core {
 class SolverOptions {
   // START: LLVM RTTI boilerplate code
 public:
-  enum SolverOptionKind { SOLVER_OPTIONS_KIND, CXX_FUZZING_SOLVER_KIND };
+  enum SolverOptionKind {
+    SOLVER_OPTIONS_KIND,
+    CXX_FUZZING_SOLVER_KIND,
+    LLVM_FUZZING_SOLVER_KIND,
+    Z3_SOLVER_KIND
+  };
 
 private:
   const SolverOptionKind kind;
@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_FUZZING_COMMON_BUFFER_ASSIGNMENT_MODEL_H
+#define JFS_FUZZING_COMMON_BUFFER_ASSIGNMENT_MODEL_H
+#include "jfs/Core/Solver.h"
+#include "jfs/Core/Z3Node.h"
+#include "jfs/Core/Z3NodeMap.h"
+#include "jfs/FuzzingCommon/FuzzingAnalysisInfo.h"
+#include <stdint.h>
+#include <vector>
+
+namespace jfs {
+namespace fuzzingCommon {
+
+// Model built from an input that the fuzzing program reported satisfies the
+// constraints. The free variables are decoded from the input the same way
+// the program decodes them (see `BufferElement`). Variables that were
+// removed by the `EqualityExtractionPass` take the value of their equality
+// set and bounded variables that aren't in the buffer take the low end of
+// their interval. Any other variable (e.g. one simplified away) is
+// unconstrained and is given the zero value of its sort.
+class BufferAssignmentModel : public jfs::core::Model {
+private:
+  jfs::core::Z3FuncDeclMap<jfs::core::Z3ASTHandle> assignments;
+  void decodeBuffer(const BufferAssignment& ba,
+                    const std::vector<uint8_t>& input);
+  void addConstantAssignments(const ConstantAssignment& ca);
+  void addIntervals(const BvIntervalExtractionPass& bie);
+  void addEqualities(const EqualityExtractionPass& eep);
+
+public:
+  // `input` must be at least `(ba.computeWidth() + 7) / 8` bytes long
+  // where `ba` is the buffer assignment in `info`.
+  BufferAssignmentModel(const FuzzingAnalysisInfo& info,
+                        const std::vector<uint8_t>& input);
+  ~BufferAssignmentModel();
+  jfs::core::Z3ASTHandle getAssignment(jfs::core::Z3FuncDeclHandle) override;
+};
+}
+}
+#endif
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_FUZZING_COMMON_BV_INTERVAL_EXTRACTION_PASS_H
+#define JFS_FUZZING_COMMON_BV_INTERVAL_EXTRACTION_PASS_H
+#include "jfs/Core/Query.h"
+#include "jfs/Core/Z3Node.h"
+#include "jfs/Core/Z3NodeMap.h"
+#include "jfs/FuzzingCommon/EqualityExtractionPass.h"
+#include "jfs/Transform/QueryPass.h"
+#include <stdint.h>
+#include <utility>
+
+namespace jfs {
+namespace fuzzingCommon {
+
+// Finds constraints that bound a bitvector free variable by a constant
+// (e.g. `(bvule x #x000003e8)`), intersects them into an unsigned interval
+// for each variable and removes them from the query. The fuzzing buffer
+// then stores each variable as an offset into its interval so every value
+// decoded satisfies the removed constraints.
+//
+// Unlike `BvBoundPropagationPass` this only pattern matches the constraints
+// and doesn't ask Z3 to propagate bounds.
+class BvIntervalExtractionPass : public jfs::transform::QueryPass {
+private:
+  const EqualityExtractionPass& eep;
+
+public:
+  // Inclusive unsigned bounds [first, second].
+  typedef std::pair<uint64_t, uint64_t> IntervalTy;
+  // TODO: Put this behind an interface once we know what the requirements
+  // are.
+  jfs::core::Z3ASTMap<IntervalTy> intervals;
+  BvIntervalExtractionPass(const EqualityExtractionPass&);
+  ~BvIntervalExtractionPass() {}
+  bool run(jfs::core::Query& q) override;
+  virtual llvm::StringRef getName() override;
+};
+}
+}
+
+#endif
@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_FUZZING_COMMON_CONSTRAINT_ORDERING_H
+#define JFS_FUZZING_COMMON_CONSTRAINT_ORDERING_H
+#include "jfs/Core/Z3Node.h"
+#include <vector>
+
+namespace jfs {
+namespace fuzzingCommon {
+
+// Return `constraints` in the order a fuzzing program should check them in.
+// Constraints that are cheap to evaluate and likely to be false for a
+// random input come first so that most inputs are rejected early.
+//
+// A constraint's cost is the sum of the estimated costs of its operations in
+// the runtime. Operations shared with other constraints are only computed
+// once so their cost is split between the constraints that use them. The
+// chance of a constraint being false is estimated from its top-level boolean
+// structure. Constraints are sorted by cost divided by that chance, which is
+// the optimal order for independent checks.
+std::vector<jfs::core::Z3ASTHandle>
+orderConstraintsByCost(const std::vector<jfs::core::Z3ASTHandle>& constraints);
+
+// Like above but `probabilitiesOfTrue[i]` is the measured chance of
+// `constraints[i]` being true (e.g. from a profile of a fuzzing run). It is
+// used instead of the estimate unless it is negative.
+std::vector<jfs::core::Z3ASTHandle>
+orderConstraintsByCost(const std::vector<jfs::core::Z3ASTHandle>& constraints,
+                       const std::vector<double>& probabilitiesOfTrue);
+}
+}
+#endif
@@ -0,0 +1,33 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_FUZZING_COMMON_CONSTRAINT_ORDERING_PASS_H
+#define JFS_FUZZING_COMMON_CONSTRAINT_ORDERING_PASS_H
+#include "jfs/Core/Query.h"
+#include "jfs/Transform/QueryPass.h"
+
+namespace jfs {
+namespace fuzzingCommon {
+
+// This pass reorders the constraints of the query into the order a fuzzing
+// program checks them in (see `orderConstraintsByCost()`). Running it before
+// FreeVariableToBufferAssignmentPass means layouts that follow the
+// constraints (e.g. constraint locality) match the order checks happen in.
+class ConstraintOrderingPass : public jfs::transform::QueryPass {
+public:
+  ConstraintOrderingPass() {}
+  ~ConstraintOrderingPass() {}
+  bool run(jfs::core::Query& q) override;
+  virtual llvm::StringRef getName() override;
+};
+}
+}
+
+#endif
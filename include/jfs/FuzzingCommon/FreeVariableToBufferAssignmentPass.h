@@ -14,6 +14,7 @@
 #include "jfs/Core/Z3Node.h"
 #include "jfs/Core/Z3NodeMap.h"
 #include "jfs/Core/Z3NodeSet.h"
+#include "jfs/FuzzingCommon/BvIntervalExtractionPass.h"
 #include "jfs/FuzzingCommon/EqualityExtractionPass.h"
 #include "jfs/Transform/QueryPass.h"
 #include <vector>
@@ -22,10 +23,42 @@ namespace jfs {
 namespace fuzzingCommon {
 
 class BufferElement {
+private:
+  unsigned bitOffset;
+  unsigned liveLowBit;
+  unsigned liveBitWidth; // Zero means every bit is live.
+  bool narrowed;
+  uint64_t intervalLow;
+  uint64_t intervalHigh;
+  friend class BufferAssignment;
+
 public:
   const jfs::core::Z3ASTHandle declApp;
   BufferElement(const jfs::core::Z3ASTHandle declApp);
+  // Number of bits the element takes up in the buffer. This is less than
+  // `getSortBitWidth()` when the element has dead bits or an interval.
   unsigned getBitWidth() const;
+  unsigned getSortBitWidth() const;
+  // Only bits [lowBit, highBit] of the variable can affect the constraints.
+  // Just those are stored in the buffer and the rest are taken to be zero.
+  void setLiveBits(unsigned lowBit, unsigned highBit);
+  unsigned getLiveLowBit() const { return liveLowBit; }
+  bool hasDeadBits() const {
+    return liveBitWidth > 0 && liveBitWidth != getSortBitWidth();
+  }
+  // The variable is known to be in [low, high] (unsigned). The buffer stores
+  // the offset from `low` using just enough bits to reach `high`. Offsets
+  // past `high` wrap around. Takes precedence over live bits.
+  void setInterval(uint64_t low, uint64_t high);
+  bool hasInterval() const { return narrowed; }
+  uint64_t getIntervalLow() const { return intervalLow; }
+  uint64_t getIntervalHigh() const { return intervalHigh; }
+  // Offset of the first bit in the buffer. Only valid once the element has
+  // been added to a `BufferAssignment`.
+  unsigned getBitOffset() const { return bitOffset; }
+  // The alignment (in bits) that makes the element cheap to decode and keeps
+  // it from sharing bytes with other elements.
+  unsigned getNaturalBitAlignment() const;
   // FIXME: put this behind an interface once we know the requirements
   std::vector<jfs::core::Z3ASTHandle> equalities;
   void print(llvm::raw_ostream&) const;
@@ -39,12 +72,20 @@ class BufferAssignment {
 private:
   typedef std::vector<BufferElement> ChunksTy;
   ChunksTy chunks;
+  // First bit after the padding reserved for the last element.
+  unsigned paddedEnd;
 
 public:
-  BufferAssignment() {}
+  BufferAssignment() : paddedEnd(0) {}
   ~BufferAssignment() {}
-  void appendElement(BufferElement&);
+  // Place `el` at the first offset after the last element (and its padding)
+  // that is a multiple of `bitAlignment` and reserve bits up to the next
+  // multiple of `bitAlignment` after it so no later element shares them.
+  void appendElement(BufferElement& el, unsigned bitAlignment = 1);
+  // Width of the buffer including padding between elements.
   unsigned computeWidth() const;
+  // Width of the buffer if the elements were packed without padding.
+  unsigned computePackedWidth() const;
   ChunksTy::const_iterator cbegin() const { return chunks.begin(); }
   ChunksTy::const_iterator cend() const { return chunks.end(); }
   ChunksTy::const_iterator begin() const { return cbegin(); }
@@ -65,12 +106,17 @@ public:
 class FreeVariableToBufferAssignmentPass : public jfs::transform::QueryPass {
 private:
   const EqualityExtractionPass& eep;
+  const BvIntervalExtractionPass& biep;
 
 public:
-  FreeVariableToBufferAssignmentPass(const EqualityExtractionPass&);
+  FreeVariableToBufferAssignmentPass(const EqualityExtractionPass&,
+                                     const BvIntervalExtractionPass&);
   ~FreeVariableToBufferAssignmentPass() {}
   bool run(jfs::core::Query& q) override;
   virtual llvm::StringRef getName() override;
+  // Return true if the layout is chosen to follow the order of the
+  // constraints so it should be recomputed if they are reordered.
+  bool layoutDependsOnConstraintOrder() const;
   // TODO: Put these behind an interface
   std::shared_ptr<BufferAssignment> bufferAssignment;
   // FIXME: It's debatable whether we actually need this. The
@@ -10,6 +10,8 @@
 //===----------------------------------------------------------------------===//
 #ifndef JFS_FUZZING_COMMON_FUZZING_ANALYSIS_INFO_H
 #define JFS_FUZZING_COMMON_FUZZING_ANALYSIS_INFO_H
+#include "jfs/FuzzingCommon/BvIntervalExtractionPass.h"
+#include "jfs/FuzzingCommon/ConstraintOrderingPass.h"
 #include "jfs/FuzzingCommon/EqualityExtractionPass.h"
 #include "jfs/FuzzingCommon/FreeVariableToBufferAssignmentPass.h"
 #include "jfs/Transform/QueryPassManager.h"
@@ -23,9 +25,12 @@ namespace fuzzingCommon {
 class FuzzingAnalysisInfo {
 public:
   std::shared_ptr<EqualityExtractionPass> equalityExtraction;
+  std::shared_ptr<BvIntervalExtractionPass> bvIntervalExtraction;
+  // Only added when the fuzzing program checks constraints in cost order.
+  std::shared_ptr<ConstraintOrderingPass> constraintOrdering;
   std::shared_ptr<FreeVariableToBufferAssignmentPass> freeVariableAssignment;
   void addTo(jfs::transform::QueryPassManager& pm);
-  FuzzingAnalysisInfo();
+  FuzzingAnalysisInfo(bool orderConstraintsByCost = false);
   ~FuzzingAnalysisInfo();
 };
 }
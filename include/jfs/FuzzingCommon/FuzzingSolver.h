@@ -27,6 +27,9 @@ protected:
   virtual std::unique_ptr<jfs::core::SolverResponse>
   fuzz(jfs::core::Query& q, bool produceModel,
        std::shared_ptr<FuzzingAnalysisInfo> info) = 0;
+  // Return true if `fuzz()` checks the constraints in the order given by
+  // `orderConstraintsByCost()` rather than the order of the query.
+  virtual bool checksConstraintsByCost() const { return false; }
   std::unique_ptr<WorkingDirectoryManager> wdm;
 
 public:
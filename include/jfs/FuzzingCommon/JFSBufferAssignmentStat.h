@@ -0,0 +1,41 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_FUZZING_COMMON_JFS_BUFFER_ASSIGNMENT_STAT_H
+#define JFS_FUZZING_COMMON_JFS_BUFFER_ASSIGNMENT_STAT_H
+#include "jfs/Support/JFSStat.h"
+
+namespace jfs {
+namespace fuzzingCommon {
+class JFSBufferAssignmentStat : public jfs::support::JFSStat {
+public:
+  JFSBufferAssignmentStat(llvm::StringRef name);
+  virtual ~JFSBufferAssignmentStat();
+  void printYAML(llvm::ScopedPrinter& os) const override;
+  static bool classof(const JFSStat* s) {
+    return s->getKind() == BUFFER_ASSIGNMENT;
+  }
+
+  // FIXME: Should not be public
+  uint64_t numElements = 0;
+  // Includes padding added to align elements.
+  uint64_t widthInBits = 0;
+  uint64_t packedWidthInBits = 0;
+  // Bits of free variables that can't affect the constraints and so aren't
+  // stored in the buffer.
+  uint64_t numDeadBits = 0;
+  // Elements stored as an offset into the interval their bounds allow and the
+  // bits that saves.
+  uint64_t numNarrowedElements = 0;
+  uint64_t numNarrowedBits = 0;
+};
+}
+}
+#endif
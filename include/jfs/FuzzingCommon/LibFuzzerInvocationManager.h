@@ -15,6 +15,8 @@
 #include "jfs/Support/ICancellable.h"
 #include "llvm/ADT/StringRef.h"
 #include <memory>
+#include <stdint.h>
+#include <vector>
 
 namespace jfs {
 namespace fuzzingCommon {
@@ -29,8 +31,16 @@ struct LibFuzzerResponse {
   ResponseTy outcome;
   LibFuzzerResponse();
   ~LibFuzzerResponse();
-  // TODO: Add stuff here to gain access to the
-  // input that hit the target if relevant.
+  // The input that hit the target. Only populated when `outcome` is
+  // `TARGET_FOUND` and the fuzzer was run via `fuzzSharedObject()`.
+  std::vector<uint8_t> input;
+  // Number of inputs LibFuzzer executed. Only populated when
+  // `LibFuzzerOptions::printFinalStats` is true and LibFuzzer's output was
+  // redirected to a file. Zero otherwise.
+  uint64_t numExecutedUnits;
+  // Number of `-dict` entries LibFuzzer used at least once. Populated under
+  // the same conditions as `numExecutedUnits`.
+  uint64_t numUsedDictionaryEntries;
 };
 
 class LibFuzzerInvocationManagerImpl;
@@ -46,6 +56,15 @@ public:
   std::unique_ptr<LibFuzzerResponse> fuzz(const LibFuzzerOptions* options,
                                           llvm::StringRef stdOutFile,
                                           llvm::StringRef stdErrFile);
+  // Run LibFuzzer against `options->targetBinary` which must be a shared
+  // object that defines `LLVMFuzzerTestOneInput`. `driver` is
+  // `LLVMFuzzerJFSInProcessDriver` which loads the shared object into the
+  // shared build of LibFuzzer. `options->artifactDir` is not used and
+  // `options->corpusDir` is optional. Seeds and the input that was found are
+  // passed through a socket rather than files.
+  std::unique_ptr<LibFuzzerResponse>
+  fuzzSharedObject(const LibFuzzerOptions* options, llvm::StringRef driver,
+                   llvm::StringRef stdOutFile, llvm::StringRef stdErrFile);
 };
 }
 }
@@ -12,6 +12,7 @@
 #define JFS_FUZZING_COMMON_LIBFUZZER_OPTIONS_H
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 namespace jfs {
 namespace fuzzingCommon {
@@ -25,7 +26,11 @@ struct LibFuzzerOptions {
   uint64_t mutationDepth; // Corresponds to `-mutate_depth=<N>`
   bool crossOver;         // Corresponds to `-cross_over` option
   uint64_t maxLength;     // Corresponds to `-max_len=<N>` option (bytes).
+  // Corresponds to `-max_total_time=<N>` option (seconds). Not passed when 0.
+  // Running out of time is not an error.
+  uint64_t maxTotalTime;
   bool useCmp;            // Corresponds to `-use_cmp` option
+  bool printFinalStats;   // Corresponds to `-print_final_stats` option
   bool handleSIGABRT;
   bool handleSIGBUS;
   bool handleSIGFPE;
@@ -37,13 +42,24 @@ struct LibFuzzerOptions {
 
   bool addAllZeroMaxLengthSeed;
   bool addAllOneMaxLengthSeed;
+  // Add seeds built from special values of each free variable's sort.
+  bool addSortAwareSeeds;
+  // Seeds to add in addition to the all zeros and all ones seeds. They
+  // should be `maxLength` bytes long.
+  std::vector<std::vector<uint8_t>> extraSeeds;
 
   std::string targetBinary;
   std::string artifactDir;
   std::string corpusDir;
+  // Corresponds to `-dict=<path>` option. Not passed when empty.
+  std::string dictionaryFile;
+  // Extra arguments for the fuzzing target, read in its
+  // `LLVMFuzzerInitialize()`. They must start with `--` so that LibFuzzer
+  // ignores them.
+  std::vector<std::string> targetArgs;
 
-  // TODO: We should support LibFuzzer jobs/workers. This
-  // will require a vector of seeds rather than a single seed
+  // NOTE: Multiple workers are handled by running several fuzzers with
+  // their own copy of these options (see `CXXFuzzingSolver`).
   LibFuzzerOptions();
 };
 }
@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_FUZZING_COMMON_RELAXED_MODEL_SEED_GENERATOR_H
+#define JFS_FUZZING_COMMON_RELAXED_MODEL_SEED_GENERATOR_H
+#include "jfs/Core/JFSContext.h"
+#include "jfs/Core/Query.h"
+#include "jfs/FuzzingCommon/FreeVariableToBufferAssignmentPass.h"
+#include "jfs/Support/ICancellable.h"
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace jfs {
+namespace fuzzingCommon {
+
+class RelaxedModelSeedGeneratorImpl;
+
+// Builds a seed from a Z3 model of a relaxed version of a query so that the
+// fuzzer starts close to a solution. The query is relaxed by dropping the
+// constraints that involve floating point terms, which are typically the
+// ones Z3 struggles with.
+class RelaxedModelSeedGenerator : public jfs::support::ICancellable {
+private:
+  const std::unique_ptr<RelaxedModelSeedGeneratorImpl> impl;
+
+public:
+  RelaxedModelSeedGenerator(jfs::core::JFSContext& ctx);
+  ~RelaxedModelSeedGenerator();
+  void cancel() override;
+  // Try to solve the relaxed version of `q` in `timeoutInMs` milliseconds.
+  // On success the model is encoded into `seed` using the layout of `ba`
+  // and true is returned. Returns false if nothing could be relaxed to
+  // (i.e. every constraint involves floating point terms) or Z3 did not
+  // find a model in time.
+  bool generate(const jfs::core::Query& q, const BufferAssignment& ba,
+                unsigned timeoutInMs, std::vector<uint8_t>& seed);
+};
+}
+}
+#endif
@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_FUZZING_COMMON_SEED_GENERATOR_H
+#define JFS_FUZZING_COMMON_SEED_GENERATOR_H
+#include "jfs/FuzzingCommon/FreeVariableToBufferAssignmentPass.h"
+#include "llvm/ADT/APInt.h"
+#include <stdint.h>
+#include <vector>
+
+namespace jfs {
+namespace fuzzingCommon {
+
+typedef std::vector<std::vector<uint8_t>> SeedListTy;
+
+// Build seeds for the fuzzing corpus from special values of each free
+// variable's sort (e.g. NaN/Inf/-0 for floats and INT_MIN/INT_MAX for
+// bitvectors). Seeds are laid out as described by `ba` and are
+// `(ba.computeWidth() + 7) / 8` bytes long. At most `maxNumSeeds` distinct
+// seeds are returned.
+SeedListTy generateSortAwareSeeds(const BufferAssignment& ba,
+                                  size_t maxNumSeeds = 64);
+
+// Write `value` into `seed` for a variable starting at `bitOffset`. Bits are
+// numbered from the least significant bit of the first byte, the same as
+// `makeBitVectorFrom()` in the runtime.
+void writeBitsToSeed(std::vector<uint8_t>& seed, unsigned bitOffset,
+                     const llvm::APInt& value);
+}
+}
+#endif
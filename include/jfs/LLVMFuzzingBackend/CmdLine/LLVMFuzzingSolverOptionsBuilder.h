@@ -0,0 +1,30 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_LLVM_FUZZING_BACKEND_CMDLINE_LLVM_FUZZING_SOLVER_OPTIONS_BUILDER_H
+#define JFS_LLVM_FUZZING_BACKEND_CMDLINE_LLVM_FUZZING_SOLVER_OPTIONS_BUILDER_H
+#include "jfs/FuzzingCommon/LibFuzzerOptions.h"
+#include "jfs/LLVMFuzzingBackend/LLVMFuzzingSolverOptions.h"
+#include "llvm/ADT/StringRef.h"
+#include <memory>
+
+namespace jfs {
+namespace llvmfb {
+namespace cl {
+
+std::unique_ptr<jfs::llvmfb::LLVMFuzzingSolverOptions>
+buildLLVMFuzzingSolverOptionsFromCmdLine(
+    llvm::StringRef pathToExecutable,
+    std::unique_ptr<jfs::fuzzingCommon::LibFuzzerOptions> libFuzzerOptions);
+}
+}
+}
+
+#endif
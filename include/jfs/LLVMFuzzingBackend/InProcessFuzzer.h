@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_LLVM_FUZZING_BACKEND_IN_PROCESS_FUZZER_H
+#define JFS_LLVM_FUZZING_BACKEND_IN_PROCESS_FUZZER_H
+#include "jfs/Core/JFSContext.h"
+#include "jfs/FuzzingCommon/LibFuzzerOptions.h"
+#include "jfs/LLVMFuzzingBackend/JITManager.h"
+#include "jfs/Support/ICancellable.h"
+#include "llvm/ADT/StringRef.h"
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace jfs {
+namespace llvmfb {
+
+struct InProcessFuzzerResponse {
+  enum class ResponseTy {
+    TARGET_FOUND,
+    SINGLE_RUN_TARGET_NOT_FOUND,
+    MAX_RUNS_REACHED,
+    CANCELLED,
+    FUZZER_FAILED,
+  };
+  ResponseTy outcome;
+  uint64_t numRuns;
+  // The input that reached the target. Only valid if `outcome` is
+  // `TARGET_FOUND`.
+  std::vector<uint8_t> input;
+  InProcessFuzzerResponse();
+  ~InProcessFuzzerResponse();
+};
+
+class InProcessFuzzerImpl;
+
+// Fuzzes a JIT compiled entry point with LibFuzzer loaded into this process
+// as a shared library. There is no process boundary so an input can be tested
+// for the cost of a function call. LibFuzzer only supports one active fuzzer
+// per process so concurrent calls to `fuzz()` are serialized. Like the
+// `LLVMFuzzingSolver` that owns it, once cancelled the fuzzer stays cancelled
+// and every later call to `fuzz()` returns `CANCELLED` without fuzzing.
+class InProcessFuzzer : public jfs::support::ICancellable {
+private:
+  const std::unique_ptr<InProcessFuzzerImpl> impl;
+
+public:
+  InProcessFuzzer(jfs::core::JFSContext& ctx);
+  ~InProcessFuzzer();
+  void cancel() override;
+  // Load LibFuzzer from `path`. This must be done before compiling
+  // programs that call the SanitizerCoverage hooks. Returns false on
+  // failure.
+  bool loadLibFuzzer(llvm::StringRef path);
+  // `extraCounters` are `numExtraCounters` coverage counters written by
+  // `entryPoint`. `maxRuns` of 0 means keep going until cancelled.
+  std::unique_ptr<InProcessFuzzerResponse>
+  fuzz(JITManager::EntryPointTy entryPoint, uint8_t* extraCounters,
+       size_t numExtraCounters,
+       const jfs::fuzzingCommon::LibFuzzerOptions* options, uint64_t maxRuns);
+};
+}
+}
+#endif
@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_LLVM_FUZZING_BACKEND_JIT_MANAGER_H
+#define JFS_LLVM_FUZZING_BACKEND_JIT_MANAGER_H
+#include "jfs/Core/JFSContext.h"
+#include "llvm/ADT/StringRef.h"
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace llvm {
+class Module;
+}
+
+namespace jfs {
+namespace llvmfb {
+
+class JITManagerImpl;
+
+// Optimizes and compiles LLVM modules to native code in the current process.
+// Compiled code stays valid for the lifetime of the JITManager.
+class JITManager {
+private:
+  const std::unique_ptr<JITManagerImpl> impl;
+
+public:
+  typedef int (*EntryPointTy)(const uint8_t* data, size_t size);
+  JITManager(jfs::core::JFSContext& ctx);
+  ~JITManager();
+  // Returns nullptr on failure.
+  EntryPointTy compile(std::unique_ptr<llvm::Module> module,
+                       llvm::StringRef entryPointName,
+                       unsigned optimizationLevel);
+  // Address of an exported symbol defined by a compiled module. Returns
+  // nullptr on failure.
+  void* getSymbolAddress(llvm::StringRef name);
+};
+}
+}
+#endif
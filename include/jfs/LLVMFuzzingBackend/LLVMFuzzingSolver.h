@@ -0,0 +1,43 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_LLVM_FUZZING_BACKEND_LLVM_FUZZING_SOLVER_H
+#define JFS_LLVM_FUZZING_BACKEND_LLVM_FUZZING_SOLVER_H
+#include "jfs/FuzzingCommon/FuzzingSolver.h"
+
+namespace jfs {
+namespace llvmfb {
+
+class LLVMFuzzingSolverImpl;
+class LLVMFuzzingSolverOptions;
+
+// This solver lowers the query directly to LLVM IR, JIT compiles it
+// in-process and fuzzes it without spawning any external processes.
+class LLVMFuzzingSolver : public jfs::fuzzingCommon::FuzzingSolver {
+private:
+  std::unique_ptr<LLVMFuzzingSolverImpl> impl;
+
+protected:
+  std::unique_ptr<jfs::core::SolverResponse>
+  fuzz(jfs::core::Query& q, bool produceModel,
+       std::shared_ptr<jfs::fuzzingCommon::FuzzingAnalysisInfo> info) override;
+
+public:
+  LLVMFuzzingSolver(
+      std::unique_ptr<LLVMFuzzingSolverOptions> options,
+      std::unique_ptr<jfs::fuzzingCommon::WorkingDirectoryManager> wdm,
+      jfs::core::JFSContext& ctx);
+  ~LLVMFuzzingSolver();
+  llvm::StringRef getName() const override;
+  void cancel() override;
+};
+}
+}
+#endif
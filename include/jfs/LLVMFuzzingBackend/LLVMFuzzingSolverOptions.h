@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_LLVM_FUZZING_BACKEND_LLVM_FUZZING_SOLVER_OPTIONS_H
+#define JFS_LLVM_FUZZING_BACKEND_LLVM_FUZZING_SOLVER_OPTIONS_H
+#include "jfs/Core/JFSContext.h"
+#include "jfs/Core/SolverOptions.h"
+#include "jfs/FuzzingCommon/LibFuzzerOptions.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+#include <string>
+
+namespace jfs {
+namespace llvmfb {
+
+class LLVMFuzzingSolverOptions : public jfs::core::SolverOptions {
+private:
+  // Options
+  std::unique_ptr<jfs::fuzzingCommon::LibFuzzerOptions> libFuzzerOpt;
+
+public:
+  // If `pathToExecutable` is not empty then the paths to the bitcode runtime
+  // and LibFuzzer will be inferred assuming that `pathToExecutable` is the
+  // absolute path to the `jfs` binary.
+  LLVMFuzzingSolverOptions(
+      llvm::StringRef pathToExecutable,
+      std::unique_ptr<jfs::fuzzingCommon::LibFuzzerOptions> libFuzzerOpt);
+  static bool classof(const SolverOptions* so) {
+    return so->getKind() == LLVM_FUZZING_SOLVER_KIND;
+  }
+  // FIXME: The fuzzer options are shared with the CXXFuzzingBackend. Options
+  // that only make sense for a separate process (e.g. `targetBinary`,
+  // `corpusDir` and the signal handling ones) are ignored by the in-process
+  // fuzzer.
+  jfs::fuzzingCommon::LibFuzzerOptions* getLibFuzzerOptions() {
+    return libFuzzerOpt.get();
+  }
+  void print(llvm::raw_ostream& os) const;
+  bool checkPaths(jfs::core::JFSContext& ctx) const;
+
+  // public for convenience.
+  // Absolute path to the SMTLIB runtime compiled to LLVM bitcode.
+  std::string pathToRuntimeBitcode;
+  // Absolute path to LibFuzzer built as a shared library. It is loaded into
+  // JFS to fuzz the JIT compiled program.
+  std::string pathToLibFuzzerSharedLib;
+  // Optimization level (0-3) applied to the module before it is JIT compiled.
+  unsigned optimizationLevel;
+  // Report the operands of bitvector comparisons to LibFuzzer so it can
+  // mutate using the compared values.
+  bool traceComparisons;
+  // Maximum number of inputs to try. 0 means no limit.
+  uint64_t maxRuns;
+};
+}
+}
+
+#endif
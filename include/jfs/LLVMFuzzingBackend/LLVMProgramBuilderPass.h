@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_LLVM_FUZZING_BACKEND_LLVM_PROGRAM_BUILDER_PASS_H
+#define JFS_LLVM_FUZZING_BACKEND_LLVM_PROGRAM_BUILDER_PASS_H
+#include "jfs/Core/JFSContext.h"
+#include "jfs/FuzzingCommon/FuzzingAnalysisInfo.h"
+#include "jfs/Transform/QueryPass.h"
+#include <memory>
+
+namespace llvm {
+class Module;
+}
+
+namespace jfs {
+namespace llvmfb {
+
+class LLVMProgramBuilderPassImpl;
+
+// Lowers the query directly to LLVM IR. The program is emitted into
+// `runtimeModule` (the SMTLIB runtime loaded from bitcode) so that calls into
+// the runtime resolve to definitions the optimizer can inline.
+//
+// The emitted entry point has the signature
+//
+// `int jfs_jit_test_one_input(const uint8_t* data, size_t size)`
+//
+// and returns 1 iff `data` satisfies all the constraints. How far each input
+// gets through the constraints is recorded in the exported byte array
+// `jfs_extra_counters` which is meant to be handed to LibFuzzer as extra
+// coverage counters. If `traceComparisons` is true the operands of bitvector
+// comparisons are also passed to SanitizerCoverage's
+// `__sanitizer_cov_trace_cmp8()` hook.
+class LLVMProgramBuilderPass : public jfs::transform::QueryPass {
+private:
+  std::unique_ptr<LLVMProgramBuilderPassImpl> impl;
+
+public:
+  LLVMProgramBuilderPass(
+      std::shared_ptr<jfs::fuzzingCommon::FuzzingAnalysisInfo> info,
+      std::unique_ptr<llvm::Module> runtimeModule, jfs::core::JFSContext& ctx,
+      bool traceComparisons = false);
+  ~LLVMProgramBuilderPass();
+  bool run(jfs::core::Query& q) override;
+  virtual llvm::StringRef getName() override;
+  // Transfers ownership of the built module to the caller.
+  std::unique_ptr<llvm::Module> takeModule();
+  static llvm::StringRef getEntryPointName();
+  static llvm::StringRef getExtraCountersName();
+  // Size of `jfs_extra_counters` in bytes. Only valid once the pass has run.
+  unsigned getNumExtraCounters() const;
+};
+}
+}
+#endif
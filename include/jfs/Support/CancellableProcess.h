@@ -12,6 +12,8 @@
 #define JFS_SUPPORT_CANCELLABLE_PROCESS_H
 #include "jfs/Support/ICancellable.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -30,13 +32,18 @@ private:
   const std::unique_ptr<CancellableProcessImpl> impl;
 
 public:
+  // Called with a stream connected to the stdin of the launched process.
+  using StdinWriterTy = std::function<void(llvm::raw_ostream&)>;
   CancellableProcess();
   ~CancellableProcess();
   void cancel() override;
   // Return values >= 0 is program exit code.
   // Negative value indicates failure.
+  // If `stdinWriter` is set the process's stdin is a pipe that
+  // `stdinWriter` writes to and the stdin entry of `redirects` is ignored.
   int execute(llvm::StringRef program, std::vector<const char*>& args,
-              std::vector<llvm::StringRef>& redirects);
+              std::vector<llvm::StringRef>& redirects,
+              StdinWriterTy stdinWriter = nullptr);
 };
 }
 }
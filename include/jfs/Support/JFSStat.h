@@ -24,7 +24,15 @@ namespace support {
 
 class JFSStat {
 public:
-  enum JFSStatKind { SINGLE_TIMER, AGGREGATE_TIMER, CXX_PROGRAM };
+  enum JFSStatKind {
+    SINGLE_TIMER,
+    AGGREGATE_TIMER,
+    CXX_PROGRAM,
+    CXX_FUZZING_WORKERS,
+    CXX_PROGRAM_CACHE,
+    CXX_FUZZING_DICTIONARY,
+    BUFFER_ASSIGNMENT
+  };
 
 private:
   const JFSStatKind kind;
@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_Z3BACKEND_Z3_SOLVER_OPTIONS_H
+#define JFS_Z3BACKEND_Z3_SOLVER_OPTIONS_H
+#include "jfs/Core/SolverOptions.h"
+
+namespace jfs {
+namespace z3Backend {
+
+class Z3SolverOptions : public jfs::core::SolverOptions {
+public:
+  Z3SolverOptions()
+      : jfs::core::SolverOptions(Z3_SOLVER_KIND), timeoutInMs(0) {}
+  static bool classof(const SolverOptions* so) {
+    return so->getKind() == Z3_SOLVER_KIND;
+  }
+
+  // public for convenience.
+  // Give up (i.e. respond unknown) after this many milliseconds. 0 means no
+  // timeout.
+  unsigned timeoutInMs;
+};
+}
+}
+
+#endif
@@ -11,20 +11,38 @@
 #include "jfs/CXXFuzzingBackend/CXXFuzzingSolver.h"
 #include "jfs/CXXFuzzingBackend/CXXFuzzingSolverOptions.h"
 #include "jfs/CXXFuzzingBackend/CXXProgramBuilderPass.h"
+#include "jfs/CXXFuzzingBackend/CXXProgramCache.h"
 #include "jfs/CXXFuzzingBackend/ClangInvocationManager.h"
 #include "jfs/CXXFuzzingBackend/ClangOptions.h"
+#include "jfs/CXXFuzzingBackend/JFSCXXFuzzingDictionaryStat.h"
+#include "jfs/CXXFuzzingBackend/JFSCXXFuzzingWorkersStat.h"
+#include "jfs/CXXFuzzingBackend/JFSCXXProgramCacheStat.h"
 #include "jfs/Core/IfVerbose.h"
 #include "jfs/Core/JFSTimerMacros.h"
+#include "jfs/FuzzingCommon/ConstraintOrdering.h"
 #include "jfs/FuzzingCommon/LibFuzzerInvocationManager.h"
+#include "jfs/FuzzingCommon/RelaxedModelSeedGenerator.h"
+#include "jfs/FuzzingCommon/SeedGenerator.h"
 #include "jfs/FuzzingCommon/SortConformanceCheckPass.h"
 #include "jfs/FuzzingCommon/WorkingDirectoryManager.h"
+#include "jfs/Support/ErrorMessages.h"
+#include "jfs/Support/StatisticsManager.h"
 #include "jfs/Transform/QueryPass.h"
 #include "jfs/Transform/QueryPassManager.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <atomic>
+#include <limits>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 using namespace jfs::core;
 using namespace jfs::fuzzingCommon;
@@ -45,6 +63,23 @@ llvm::cl::opt<bool> DebugStopAfterCompilation(
 namespace jfs {
 namespace cxxfb {
 
+namespace {
+const char* getOutcomeName(LibFuzzerResponse::ResponseTy outcome) {
+  switch (outcome) {
+  case LibFuzzerResponse::ResponseTy::TARGET_FOUND:
+    return "TARGET_FOUND";
+  case LibFuzzerResponse::ResponseTy::SINGLE_RUN_TARGET_NOT_FOUND:
+    return "SINGLE_RUN_TARGET_NOT_FOUND";
+  case LibFuzzerResponse::ResponseTy::CANCELLED:
+    return "CANCELLED";
+  case LibFuzzerResponse::ResponseTy::UNKNOWN:
+    return "UNKNOWN";
+  default:
+    llvm_unreachable("Unhandled LibFuzzerResponse");
+  }
+}
+}
+
 class CXXFuzzingSolverResponse : public SolverResponse {
 public:
   CXXFuzzingSolverResponse(SolverResponse::SolverSatisfiability sat)
@@ -64,14 +99,19 @@ class CXXFuzzingSolverImpl {
   CXXFuzzingSolverOptions* options;
   ClangInvocationManager cim;
   LibFuzzerInvocationManager lim;
+  RelaxedModelSeedGenerator rmsg;
+  std::mutex workersMutex; // protects `workers`
+  // Fuzzers used when running more than one worker.
+  std::vector<std::unique_ptr<LibFuzzerInvocationManager>> workers;
   WorkingDirectoryManager* wdm;
+  std::unique_ptr<CXXProgramCache> programCache;
 
 public:
   friend class CXXFuzzingSolver;
   CXXFuzzingSolverImpl(JFSContext& ctx, CXXFuzzingSolverOptions* options,
                        WorkingDirectoryManager* wdm)
       : cancelled(false), ctx(ctx), options(options), cim(ctx), lim(ctx),
-        wdm(wdm) {
+        rmsg(ctx), wdm(wdm) {
     assert(this->wdm != nullptr);
     assert(this->options != nullptr);
     // Check paths
@@ -79,10 +119,32 @@ public:
     if (!clangPathsOkay) {
       ctx.raiseFatalError("One or more Clang paths do not exist");
     }
+    if (options->programCacheDir.size() > 0) {
+      programCache.reset(new CXXProgramCache(options->programCacheDir, ctx));
+    }
   }
   ~CXXFuzzingSolverImpl() {}
 
   llvm::StringRef getName() { return "CXXFuzzingSolver"; }
+
+  // Returns a directory on a memory-backed file system that is removed on
+  // destruction or nullptr if there isn't one available.
+  std::unique_ptr<WorkingDirectoryManager> makeMemoryBackedDirectory() {
+    // FIXME: This is Linux specific
+    llvm::StringRef sharedMemoryDir = "/dev/shm";
+    if (!llvm::sys::fs::is_directory(sharedMemoryDir) ||
+        llvm::sys::fs::access(sharedMemoryDir,
+                              llvm::sys::fs::AccessMode::Write)) {
+      IF_VERB(ctx, ctx.getWarningStream()
+                       << "(warning \"" << sharedMemoryDir
+                       << "\" is not a writable directory. Using the working "
+                          "directory for the compiled program)\n");
+      return nullptr;
+    }
+    return WorkingDirectoryManager::makeInDirectory(
+        sharedMemoryDir, "jfs-compile", ctx, /*deleteOnDestruction=*/true,
+        /*maxN=*/std::numeric_limits<uint16_t>::max());
+  }
   void cancel() {
     cancelled = true;
     // Cancel any active passes
@@ -94,8 +156,159 @@ public:
     }
     // Cancel active Clang invocation
     cim.cancel();
+    // Cancel active Z3 invocation
+    rmsg.cancel();
     // Cancel active LibFuzzer invocation
     lim.cancel();
+    {
+      std::lock_guard<std::mutex> lock(workersMutex);
+      for (const auto& worker : workers) {
+        worker->cancel();
+      }
+    }
+  }
+
+  std::unique_ptr<LibFuzzerResponse>
+  runFuzzer(LibFuzzerInvocationManager* manager, const LibFuzzerOptions* lfo,
+            bool inProcess, llvm::StringRef stdOutFile,
+            llvm::StringRef stdErrFile) {
+    if (inProcess) {
+      return manager->fuzzSharedObject(
+          lfo, options->getClangOptions()->pathToLibFuzzerInProcessDriver,
+          stdOutFile, stdErrFile);
+    }
+    return manager->fuzz(lfo, stdOutFile, stdErrFile);
+  }
+
+  // Run `options->numFuzzingWorkers` fuzzers concurrently. The first to find
+  // the target wins and the rest are cancelled.
+  std::unique_ptr<LibFuzzerResponse>
+  fuzzWithWorkers(const LibFuzzerOptions* lfo, bool inProcess) {
+    const unsigned numWorkers = options->numFuzzingWorkers;
+    assert(numWorkers > 1);
+    std::vector<LibFuzzerOptions> workerOptions(numWorkers, *lfo);
+    std::vector<std::string> stdOutFiles;
+    std::vector<std::string> stdErrFiles;
+    for (unsigned index = 0; index < numWorkers; ++index) {
+      LibFuzzerOptions& wo = workerOptions[index];
+      // A seed of 0 makes LibFuzzer pick a random seed so the workers
+      // will differ anyway.
+      if (lfo->seed != 0) {
+        wo.seed = lfo->seed + index;
+      }
+      if (options->varyFuzzingWorkerStrategy) {
+        // Cycle between the requested, a deeper and a shallower mutation
+        // depth and alternate cross over.
+        switch (index % 3) {
+        case 1:
+          wo.mutationDepth = lfo->mutationDepth * 2;
+          break;
+        case 2:
+          wo.mutationDepth = std::max<uint64_t>(1, lfo->mutationDepth / 2);
+          break;
+        default:
+          break;
+        }
+        if (index % 2 == 1) {
+          wo.crossOver = !lfo->crossOver;
+        }
+      }
+      if (!inProcess && index > 0) {
+        // Seeds are written to the shared corpus directory so only the first
+        // worker needs to add them. The others pick them up when they reload
+        // the corpus.
+        wo.addAllZeroMaxLengthSeed = false;
+        wo.addAllOneMaxLengthSeed = false;
+        wo.extraSeeds.clear();
+      }
+      // Needed for the per worker stats.
+      wo.printFinalStats = true;
+      // Always redirect. The interleaved output of several fuzzers isn't
+      // useful and the stats are read back from these files.
+      std::string prefix = "libfuzzer.worker" + std::to_string(index);
+      stdOutFiles.push_back(
+          wdm->getPathToFileInDirectory(prefix + ".stdout.txt"));
+      stdErrFiles.push_back(
+          wdm->getPathToFileInDirectory(prefix + ".stderr.txt"));
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(workersMutex);
+      for (unsigned index = 0; index < numWorkers; ++index) {
+        workers.push_back(std::unique_ptr<LibFuzzerInvocationManager>(
+            new LibFuzzerInvocationManager(ctx)));
+      }
+      // `cancel()` might have been called before the workers existed.
+      if (cancelled) {
+        for (const auto& worker : workers) {
+          worker->cancel();
+        }
+      }
+    }
+
+    std::mutex winnerMutex; // protects `winner`
+    int winner = -1;
+    std::vector<std::unique_ptr<LibFuzzerResponse>> responses(numWorkers);
+    std::vector<std::thread> threads;
+    for (unsigned index = 0; index < numWorkers; ++index) {
+      threads.emplace_back([&, index]() {
+        auto response =
+            runFuzzer(workers[index].get(), &(workerOptions[index]), inProcess,
+                      stdOutFiles[index], stdErrFiles[index]);
+        bool won = false;
+        if (response->outcome == LibFuzzerResponse::ResponseTy::TARGET_FOUND) {
+          std::lock_guard<std::mutex> lock(winnerMutex);
+          if (winner == -1) {
+            winner = index;
+            won = true;
+          }
+        }
+        responses[index] = std::move(response);
+        if (won) {
+          IF_VERB(ctx, ctx.getDebugStream() << "(" << getName() << " worker "
+                                            << index << " found target)\n");
+          std::lock_guard<std::mutex> lock(workersMutex);
+          for (unsigned other = 0; other < workers.size(); ++other) {
+            if (other != index) {
+              workers[other]->cancel();
+            }
+          }
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    {
+      std::lock_guard<std::mutex> lock(workersMutex);
+      workers.clear();
+    }
+
+    if (ctx.getStats() != nullptr) {
+      std::unique_ptr<JFSCXXFuzzingWorkersStat> stat(
+          new JFSCXXFuzzingWorkersStat("CXXFuzzingSolverWorkers"));
+      for (unsigned index = 0; index < numWorkers; ++index) {
+        JFSCXXFuzzingWorkersStat::WorkerStat ws;
+        ws.seed = workerOptions[index].seed;
+        ws.mutationDepth = workerOptions[index].mutationDepth;
+        ws.crossOver = workerOptions[index].crossOver;
+        ws.numExecutedUnits = responses[index]->numExecutedUnits;
+        ws.numUsedDictionaryEntries =
+            responses[index]->numUsedDictionaryEntries;
+        ws.outcome = getOutcomeName(responses[index]->outcome);
+        stat->workers.push_back(ws);
+      }
+      stat->winningWorker = winner;
+      ctx.getStats()->append(std::move(stat));
+    }
+
+    if (winner != -1) {
+      return std::move(responses[winner]);
+    }
+    std::unique_ptr<LibFuzzerResponse> response(new LibFuzzerResponse());
+    response->outcome = cancelled ? LibFuzzerResponse::ResponseTy::CANCELLED
+                                  : LibFuzzerResponse::ResponseTy::UNKNOWN;
+    return response;
   }
 
   // FIXME: Should be const Query.
@@ -159,14 +372,6 @@ public:
     return p->predicateAlwaysHeld();
   }
 
-  std::unique_ptr<jfs::core::SolverResponse>
-  fuzz(jfs::core::Query &q, bool produceModel,
-       std::shared_ptr<FuzzingAnalysisInfo> info) {
-    assert(ctx == q.getContext());
-    if (produceModel) {
-      ctx.getErrorStream() << "(error model generation not supported)\n";
-      return nullptr;
-    }
 #define CHECK_CANCELLED()                                                      \
   if (cancelled) {                                                             \
     IF_VERB(ctx, ctx.getDebugStream() << "(" << getName() << " cancelled)\n"); \
@@ -174,19 +379,11 @@ public:
         new CXXFuzzingSolverResponse(SolverResponse::UNKNOWN));                \
   }
 
-    // Check types are supported
-    if (!sortsAreSupported(q)) {
-      IF_VERB(ctx, ctx.getDebugStream() << "(unsupported sorts)\n");
-      return std::unique_ptr<SolverResponse>(
-          new CXXFuzzingSolverResponse(SolverResponse::UNKNOWN));
-    }
-
-    // Cancellation point
-    CHECK_CANCELLED();
-
-    // Generate program
+  std::shared_ptr<CXXProgramBuilderPass>
+  buildProgram(Query& q, std::shared_ptr<FuzzingAnalysisInfo> info,
+               const CXXProgramBuilderOptions* pbo) {
     QueryPassManager pm;
-    auto pbp = std::make_shared<CXXProgramBuilderPass>(info, ctx);
+    auto pbp = std::make_shared<CXXProgramBuilderPass>(info, pbo, ctx);
 
     {
       // Make the pass cancellable
@@ -198,33 +395,158 @@ public:
     {
       // Pass is done. Remove from the set of cancellable passes
       std::lock_guard<std::mutex> lock(cancellablePassesMutex);
-      cancellablePasses.insert(pbp.get());
+      cancellablePasses.erase(pbp.get());
     }
+    return pbp;
+  }
 
-    // Cancellation point
+  // Write the constants lifted out of the program built by `pbp` to
+  // `fileName` in the working directory and set `path` to it.
+  bool writeConstantTable(const CXXProgramBuilderPass* pbp,
+                          llvm::StringRef fileName, std::string& path) {
+    path = wdm->getPathToFileInDirectory(fileName);
+    std::error_code ec;
+    llvm::raw_fd_ostream constantTableStream(path, ec, llvm::sys::fs::F_None);
+    if (ec) {
+      ctx.getErrorStream()
+          << jfs::support::getMessageForFailedOpenFileForWriting(path, ec);
+      return false;
+    }
+    const std::vector<uint64_t>& constantTable = pbp->getConstantTable();
+    constantTableStream.write(
+        reinterpret_cast<const char*>(constantTable.data()),
+        constantTable.size() * sizeof(uint64_t));
+    IF_VERB(ctx, ctx.getDebugStream() << "(" << getName() << " lifted "
+                                      << constantTable.size()
+                                      << " constants)\n");
+    return true;
+  }
+
+  // Write the dictionary of the constants used by the constraints, if there
+  // is one, and set `path` to it.
+  bool writeDictionary(const CXXProgramBuilderPass* pbp, std::string& path) {
+    const std::vector<std::vector<uint8_t>>& dictionary = pbp->getDictionary();
+    if (dictionary.size() == 0)
+      return true;
+    path = wdm->getPathToFileInDirectory("fuzzer.dict");
+    std::error_code ec;
+    llvm::raw_fd_ostream dictionaryStream(path, ec, llvm::sys::fs::F_Text);
+    if (ec) {
+      ctx.getErrorStream()
+          << jfs::support::getMessageForFailedOpenFileForWriting(path, ec);
+      return false;
+    }
+    // One quoted entry per line with every byte escaped.
+    for (const auto& entry : dictionary) {
+      dictionaryStream << "\"";
+      for (uint8_t byte : entry) {
+        dictionaryStream << "\\x" << llvm::hexdigit(byte >> 4, true)
+                         << llvm::hexdigit(byte & 0xf, true);
+      }
+      dictionaryStream << "\"\n";
+    }
+    IF_VERB(ctx, ctx.getDebugStream() << "(" << getName() << " wrote "
+                                      << dictionary.size()
+                                      << " dictionary entries)\n");
+    return true;
+  }
+
+  // Read the counts written by a program built with
+  // `CXXProgramBuilderOptions::recordRejections`.
+  bool readRejectionProfile(llvm::StringRef path, size_t numConstraints,
+                            std::vector<uint64_t>& counts) {
+    auto bufferOrError = llvm::MemoryBuffer::getFile(path);
+    if (!bufferOrError) {
+      IF_VERB(ctx, ctx.getWarningStream()
+                       << "(warning failed to read rejection profile \""
+                       << path << "\")\n");
+      return false;
+    }
+    llvm::SmallVector<llvm::StringRef, 16> lines;
+    bufferOrError.get()->getBuffer().split(lines, '\n', /*MaxSplit=*/-1,
+                                           /*KeepEmpty=*/false);
+    counts.clear();
+    for (llvm::StringRef line : lines) {
+      uint64_t count = 0;
+      if (line.trim().getAsInteger(/*Radix=*/10, count))
+        break;
+      counts.push_back(count);
+    }
+    // One count per constraint followed by the number of inputs checked.
+    if (counts.size() != numConstraints + 1) {
+      IF_VERB(ctx, ctx.getWarningStream()
+                       << "(warning rejection profile \"" << path
+                       << "\" is malformed)\n");
+      return false;
+    }
+    return true;
+  }
+
+  // Fuzz for `options->profileWarmUpTime` seconds with a program that counts
+  // how many inputs each constraint rejects. The inputs LibFuzzer keeps are
+  // left in `lfo->corpusDir`. Returns a response if fuzzing should stop (e.g.
+  // the target was found). Otherwise sets `profiledOrder` to the order the
+  // constraints should be checked in, if the profile could be read, and sets
+  // `profileFile` to a Clang PGO profile of the program, if one was
+  // requested and collected.
+  std::unique_ptr<SolverResponse>
+  warmUp(Query& q, std::shared_ptr<FuzzingAnalysisInfo> info, bool inProcess,
+         const LibFuzzerOptions* lfo,
+         std::vector<Z3ASTHandle>& profiledOrder, std::string& profileFile) {
+    JFS_SM_TIMER(profile_warm_up, ctx);
+    CXXProgramBuilderOptions warmUpOptions =
+        *(options->getCXXProgramBuilderOptions());
+    warmUpOptions.recordRejections = true;
+    auto pbp = buildProgram(q, info, &warmUpOptions);
     CHECK_CANCELLED();
 
-    // Build program
-    // FIXME: We should teach ClangInvocationManager to pipe the program
-    // directly
-    // to Clang so we don't need to write it disk and then immediatly read it
-    // back.
-    std::string outputFilePath;
+    LibFuzzerOptions warmUpLfo(*lfo);
+    warmUpLfo.maxTotalTime = options->profileWarmUpTime;
+    warmUpLfo.targetArgs.clear();
+    if (warmUpOptions.liftConstants) {
+      std::string constantTablePath;
+      if (!writeConstantTable(pbp.get(), "warmup.constants.bin",
+                              constantTablePath)) {
+        return std::unique_ptr<SolverResponse>(
+            new CXXFuzzingSolverResponse(SolverResponse::UNKNOWN));
+      }
+      warmUpLfo.targetArgs.push_back("--jfs_constants=" + constantTablePath);
+    }
+    if (!writeDictionary(pbp.get(), warmUpLfo.dictionaryFile)) {
+      return std::unique_ptr<SolverResponse>(
+          new CXXFuzzingSolverResponse(SolverResponse::UNKNOWN));
+    }
+    std::string rejectionProfilePath =
+        wdm->getPathToFileInDirectory("warmup.rejections.txt");
+    warmUpLfo.targetArgs.push_back("--jfs_rejection_profile=" +
+                                   rejectionProfilePath);
+
+    // Build the warm up program
+    ClangOptions warmUpClangOptions(*(options->getClangOptions()));
+    std::string rawProfilePath;
+    if (options->profileWarmUpPGO) {
+      rawProfilePath = wdm->getPathToFileInDirectory("warmup.profraw");
+      warmUpClangOptions.profileInstrGenerateFile = rawProfilePath;
+    }
+    std::string clangStdOutFile;
+    std::string clangStdErrFile;
+    if (options->redirectClangOutput) {
+      clangStdOutFile =
+          wdm->getPathToFileInDirectory("clang.warmup.stdout.txt");
+      clangStdErrFile =
+          wdm->getPathToFileInDirectory("clang.warmup.stderr.txt");
+    }
     {
       JFS_SM_TIMER(compile, ctx);
-      std::string sourceFilePath = wdm->getPathToFileInDirectory("program.cpp");
-      outputFilePath = wdm->getPathToFileInDirectory("fuzzer");
-      std::string clangStdOutFile;
-      std::string clangStdErrFile;
-      if (options->redirectClangOutput) {
-        // When being quiet redirect to files
-        clangStdOutFile = wdm->getPathToFileInDirectory("clang.stdout.txt");
-        clangStdErrFile = wdm->getPathToFileInDirectory("clang.stderr.txt");
-      }
+      warmUpLfo.targetBinary = wdm->getPathToFileInDirectory(
+          inProcess ? "warmup.fuzzer.so" : "warmup.fuzzer");
       bool compileSuccess = cim.compile(
-          /*program=*/pbp->getProgram().get(), /*sourceFile=*/sourceFilePath,
-          /*outputFile=*/outputFilePath,
-          /*clangOptions=*/options->getClangOptions(),
+          /*program=*/pbp->getProgram().get(),
+          /*sourceFile=*/options->pipeSourceToClang
+              ? ""
+              : wdm->getPathToFileInDirectory("warmup.program.cpp"),
+          /*outputFile=*/warmUpLfo.targetBinary,
+          /*clangOptions=*/&warmUpClangOptions,
           /*stdOutFile=*/clangStdOutFile,
           /*stdErrFile=*/clangStdErrFile);
       if (!compileSuccess) {
@@ -232,32 +554,132 @@ public:
             new CXXFuzzingSolverResponse(SolverResponse::UNKNOWN));
       }
     }
-    // Cancellation point
     CHECK_CANCELLED();
 
-    if (DebugStopAfterCompilation) {
-      // For debugging it can be useful to check that JFS can successfully
-      // run and compile the fuzzing program without actually fuzzing.
-      IF_VERB(ctx, ctx.getDebugStream() << "(DebugStopAfterCompilation)\n");
+    // Fuzz
+    if (!inProcess) {
+      warmUpLfo.artifactDir =
+          wdm->makeNewDirectoryInDirectory("warmup.artifacts");
+    }
+    std::string libFuzzerStdOutFile;
+    std::string libFuzzerStdErrFile;
+    if (options->redirectLibFuzzerOutput) {
+      libFuzzerStdOutFile =
+          wdm->getPathToFileInDirectory("libfuzzer.warmup.stdout.txt");
+      libFuzzerStdErrFile =
+          wdm->getPathToFileInDirectory("libfuzzer.warmup.stderr.txt");
+    }
+    auto fuzzingResponse = runFuzzer(&lim, &warmUpLfo, inProcess,
+                                     libFuzzerStdOutFile, libFuzzerStdErrFile);
+    IF_VERB(ctx, ctx.getDebugStream()
+                     << "(" << getName() << " warm up outcome "
+                     << getOutcomeName(fuzzingResponse->outcome) << ")\n");
+    if (fuzzingResponse->outcome ==
+        LibFuzzerResponse::ResponseTy::TARGET_FOUND) {
       return std::unique_ptr<SolverResponse>(
-          new CXXFuzzingSolverResponse(SolverResponse::UNKNOWN));
+          new CXXFuzzingSolverResponse(SolverResponse::SAT));
     }
+    CHECK_CANCELLED();
 
-    // Set LibFuzzer options
-    JFS_SM_TIMER(fuzz, ctx);
-    LibFuzzerOptions* lfo = options->getLibFuzzerOptions();
+    // Reorder the constraints using how often each one rejected the inputs
+    // that reached it.
+    const std::vector<Z3ASTHandle>& warmUpOrder = pbp->getConstraintOrder();
+    std::vector<uint64_t> counts;
+    if (readRejectionProfile(rejectionProfilePath, warmUpOrder.size(),
+                             counts)) {
+      uint64_t numReached = counts.back();
+      std::vector<double> probabilitiesOfTrue(warmUpOrder.size(), -1.0);
+      for (size_t index = 0; index < warmUpOrder.size(); ++index) {
+        // Constraints that no input reached keep their estimate.
+        if (numReached == 0)
+          break;
+        probabilitiesOfTrue[index] =
+            1.0 - (static_cast<double>(counts[index]) / numReached);
+        numReached -= std::min(numReached, counts[index]);
+      }
+      profiledOrder = orderConstraintsByCost(warmUpOrder, probabilitiesOfTrue);
+      size_t numMoved = 0;
+      for (size_t index = 0; index < profiledOrder.size(); ++index) {
+        if (!profiledOrder[index].isStructurallyEqualTo(warmUpOrder[index]))
+          ++numMoved;
+      }
+      IF_VERB(ctx, ctx.getDebugStream()
+                       << "(" << getName() << " warm up checked "
+                       << counts.back() << " inputs and reordered " << numMoved
+                       << " of " << profiledOrder.size()
+                       << " constraints)\n");
+    }
+
+    if (options->profileWarmUpPGO) {
+      std::string mergedProfilePath =
+          wdm->getPathToFileInDirectory("warmup.profdata");
+      if (llvm::sys::fs::exists(rawProfilePath) &&
+          cim.mergeProfile(rawProfilePath, mergedProfilePath,
+                           options->getClangOptions(), clangStdOutFile,
+                           clangStdErrFile)) {
+        profileFile = mergedProfilePath;
+      }
+      CHECK_CANCELLED();
+    }
+    return nullptr;
+  }
+
+  // Set the LibFuzzer options that depend on the buffer layout.
+  void setBufferOptions(Query& q, const FuzzingAnalysisInfo& info,
+                        LibFuzzerOptions* lfo) {
+    const BufferAssignment& ba =
+        *(info.freeVariableAssignment->bufferAssignment);
     // FIXME: We've already computed this earlier so we should cache it
     // somewhere.
-    lfo->maxLength =
-        (info->freeVariableAssignment->bufferAssignment->computeWidth() + 7) /
-        8;
-    lfo->targetBinary = outputFilePath;
-    std::string corpusDir = wdm->makeNewDirectoryInDirectory("corpus");
-    lfo->corpusDir = corpusDir;
-    std::string artifactDir = wdm->makeNewDirectoryInDirectory("artifacts");
-    lfo->artifactDir = artifactDir;
-    std::string libFuzzerStdOutFile;
-    std::string libFuzzerStdErrFile;
+    lfo->maxLength = (ba.computeWidth() + 7) / 8;
+    lfo->extraSeeds.clear();
+    if (lfo->addSortAwareSeeds && lfo->maxLength > 0) {
+      lfo->extraSeeds = generateSortAwareSeeds(ba);
+    }
+    if (options->relaxedModelSeedTimeout > 0 && lfo->maxLength > 0 &&
+        !cancelled) {
+      JFS_SM_TIMER(relaxed_model_seed, ctx);
+      std::vector<uint8_t> seed;
+      if (rmsg.generate(q, ba, options->relaxedModelSeedTimeout, seed)) {
+        // Try it first.
+        lfo->extraSeeds.insert(lfo->extraSeeds.begin(), seed);
+      }
+    }
+  }
+
+  std::unique_ptr<jfs::core::SolverResponse>
+  fuzz(jfs::core::Query &q, bool produceModel,
+       std::shared_ptr<FuzzingAnalysisInfo> info) {
+    assert(ctx == q.getContext());
+    if (produceModel) {
+      ctx.getErrorStream() << "(error model generation not supported)\n";
+      return nullptr;
+    }
+
+    // Check types are supported
+    if (!sortsAreSupported(q)) {
+      IF_VERB(ctx, ctx.getDebugStream() << "(unsupported sorts)\n");
+      return std::unique_ptr<SolverResponse>(
+          new CXXFuzzingSolverResponse(SolverResponse::UNKNOWN));
+    }
+
+    // Cancellation point
+    CHECK_CANCELLED();
+
+    // When building a shared object the fuzzing target is reported back
+    // through JFS's copy of LibFuzzer rather than by crashing.
+    bool inProcess = options->getClangOptions()->buildSharedObject;
+    CXXProgramBuilderOptions* pbo = options->getCXXProgramBuilderOptions();
+    pbo->fuzzingTarget =
+        inProcess
+            ? CXXProgramBuilderOptions::FuzzingTargetTy::LIBFUZZER_CALLBACK
+            : CXXProgramBuilderOptions::FuzzingTargetTy::ABORT;
+
+    // Set LibFuzzer options that don't depend on the program.
+    LibFuzzerOptions* lfo = options->getLibFuzzerOptions();
+    setBufferOptions(q, *info, lfo);
+    // Cancellation point
+    CHECK_CANCELLED();
     lfo->useCmp = false;
     // FIXME: This is O(N). We should probably change sanitizerCoverageOptions
     // to be a set.
@@ -267,6 +689,11 @@ public:
         options->getClangOptions()->sanitizerCoverageOptions.end()) {
       lfo->useCmp = true;
     }
+    // Traced floating point comparisons are only useful if LibFuzzer
+    // mutates using the compared values.
+    if (options->getCXXProgramBuilderOptions()->traceFloatComparisons) {
+      lfo->useCmp = true;
+    }
     // FIXME: The fact that our fuzzing target is `abort()` is really fragile.
     lfo->handleSIGABRT =
         true; // Our target is an `abort()` so we want to catch this.
@@ -282,16 +709,223 @@ public:
     lfo->handleSIGXFSZ =
         true; // This doesn't trigger LibFuzzer's error handler so this is fine.
 
-    if (options->redirectLibFuzzerOutput) {
-      // When being quiet redirect to files
-      libFuzzerStdOutFile =
-          wdm->getPathToFileInDirectory("libfuzzer.stdout.txt");
-      libFuzzerStdErrFile =
-          wdm->getPathToFileInDirectory("libfuzzer.stderr.txt");
+    // Warm up with a program that profiles the constraints and then build
+    // the program that is fuzzed from here on using the profile.
+    std::string corpusDir;
+    Query* programQuery = &q;
+    std::unique_ptr<Query> profiledQuery;
+    const CXXProgramBuilderOptions* programOptions = pbo;
+    CXXProgramBuilderOptions profiledOptions(*pbo);
+    std::string profileFile;
+    bool relaidOut = false;
+    bool warmUpEnabled = options->profileWarmUpTime > 0 && lfo->maxLength > 0;
+    if (warmUpEnabled && pbo->countSatisfiedConstraints) {
+      // No constraint rejects an input on its own so there is nothing to
+      // profile.
+      IF_VERB(ctx, ctx.getWarningStream()
+                       << "(warning profile warm up is not supported when "
+                          "counting satisfied constraints)\n");
+      warmUpEnabled = false;
+    }
+    if (warmUpEnabled) {
+      corpusDir = wdm->makeNewDirectoryInDirectory("corpus");
+      lfo->corpusDir = corpusDir;
+      std::vector<Z3ASTHandle> profiledOrder;
+      auto response = warmUp(q, info, inProcess, lfo, profiledOrder,
+                             profileFile);
+      if (response)
+        return response;
+      if (profiledOrder.size() > 0) {
+        profiledQuery.reset(new Query(q));
+        profiledQuery->constraints = profiledOrder;
+        profiledOptions.orderConstraintsByCost = false;
+        programQuery = profiledQuery.get();
+        programOptions = &profiledOptions;
+        if (info->freeVariableAssignment->layoutDependsOnConstraintOrder()) {
+          // Keep the bytes used by the constraints that are now checked
+          // first at the start of the buffer. The inputs found during the
+          // warm up use the old layout so they are not reused.
+          info->freeVariableAssignment->run(*profiledQuery);
+          CHECK_CANCELLED();
+          setBufferOptions(*profiledQuery, *info, lfo);
+          CHECK_CANCELLED();
+          corpusDir = wdm->makeNewDirectoryInDirectory("relayout.corpus");
+          lfo->corpusDir = corpusDir;
+          relaidOut = true;
+        }
+      }
+    }
+
+    // Generate program
+    auto pbp = buildProgram(*programQuery, info, programOptions);
+
+    // Cancellation point
+    CHECK_CANCELLED();
+
+    // The lifted constants are read by the program when the fuzzer starts.
+    std::string constantTablePath;
+    if (pbo->liftConstants) {
+      if (!writeConstantTable(pbp.get(), "constants.bin", constantTablePath)) {
+        return std::unique_ptr<SolverResponse>(
+            new CXXFuzzingSolverResponse(SolverResponse::UNKNOWN));
+      }
+    }
+
+    // Dictionary of the constants used by the constraints.
+    std::string dictionaryPath;
+    if (!writeDictionary(pbp.get(), dictionaryPath)) {
+      return std::unique_ptr<SolverResponse>(
+          new CXXFuzzingSolverResponse(SolverResponse::UNKNOWN));
+    }
+    const std::vector<std::vector<uint8_t>>& dictionary = pbp->getDictionary();
+
+    // Build program
+    const ClangOptions* clangOptions = options->getClangOptions();
+    ClangOptions profiledClangOptions;
+    if (profileFile.size() > 0) {
+      profiledClangOptions = *clangOptions;
+      profiledClangOptions.profileInstrUseFile = profileFile;
+      clangOptions = &profiledClangOptions;
+    }
+    std::string outputFilePath;
+    // Holds the compiled program when piping the source to Clang. It must
+    // outlive fuzzing.
+    std::unique_ptr<WorkingDirectoryManager> memoryBackedDir;
+    {
+      JFS_SM_TIMER(compile, ctx);
+      std::string sourceFilePath;
+      const WorkingDirectoryManager* outputDir = wdm;
+      if (options->pipeSourceToClang) {
+        // Clang reads the program from stdin so nothing is written to the
+        // working directory.
+        memoryBackedDir = makeMemoryBackedDirectory();
+        if (memoryBackedDir)
+          outputDir = memoryBackedDir.get();
+      } else {
+        sourceFilePath = wdm->getPathToFileInDirectory("program.cpp");
+      }
+      outputFilePath = outputDir->getPathToFileInDirectory(
+          inProcess ? "fuzzer.so" : "fuzzer");
+      std::string clangStdOutFile;
+      std::string clangStdErrFile;
+      if (options->redirectClangOutput) {
+        // When being quiet redirect to files
+        clangStdOutFile = wdm->getPathToFileInDirectory("clang.stdout.txt");
+        clangStdErrFile = wdm->getPathToFileInDirectory("clang.stderr.txt");
+      }
+      std::string cacheKey;
+      uint64_t cachedSize = 0;
+      // The cache key doesn't cover the contents of a PGO profile.
+      bool useProgramCache = programCache && profileFile.size() == 0;
+      if (useProgramCache) {
+        cacheKey = programCache->computeKey(pbp->getProgram().get(),
+                                            clangOptions, programOptions);
+        cachedSize = programCache->lookup(cacheKey, outputFilePath);
+        if (ctx.getStats() != nullptr) {
+          std::unique_ptr<JFSCXXProgramCacheStat> stat(
+              new JFSCXXProgramCacheStat("CXXProgramCache"));
+          if (cachedSize > 0) {
+            stat->hits = 1;
+            stat->bytesSaved = cachedSize;
+          } else {
+            stat->misses = 1;
+          }
+          ctx.getStats()->append(std::move(stat));
+        }
+      }
+      if (cachedSize == 0) {
+        bool compileSuccess = cim.compile(
+            /*program=*/pbp->getProgram().get(),
+            /*sourceFile=*/sourceFilePath,
+            /*outputFile=*/outputFilePath,
+            /*clangOptions=*/clangOptions,
+            /*stdOutFile=*/clangStdOutFile,
+            /*stdErrFile=*/clangStdErrFile);
+        if (!compileSuccess) {
+          return std::unique_ptr<SolverResponse>(
+              new CXXFuzzingSolverResponse(SolverResponse::UNKNOWN));
+        }
+        if (useProgramCache) {
+          programCache->insert(cacheKey, outputFilePath);
+        }
+      }
+    }
+    // Cancellation point
+    CHECK_CANCELLED();
+
+    if (DebugStopAfterCompilation) {
+      // For debugging it can be useful to check that JFS can successfully
+      // run and compile the fuzzing program without actually fuzzing.
+      IF_VERB(ctx, ctx.getDebugStream() << "(DebugStopAfterCompilation)\n");
+      return std::unique_ptr<SolverResponse>(
+          new CXXFuzzingSolverResponse(SolverResponse::UNKNOWN));
+    }
+
+    // Set LibFuzzer options that depend on the program
+    JFS_SM_TIMER(fuzz, ctx);
+    LibFuzzerOptions continuedLfo;
+    if (warmUpEnabled && !relaidOut && !inProcess) {
+      // The seeds were written to the corpus directory by the warm up.
+      continuedLfo = *lfo;
+      continuedLfo.addAllZeroMaxLengthSeed = false;
+      continuedLfo.addAllOneMaxLengthSeed = false;
+      continuedLfo.extraSeeds.clear();
+      lfo = &continuedLfo;
+    }
+    lfo->targetBinary = outputFilePath;
+    lfo->targetArgs.clear();
+    if (pbo->liftConstants) {
+      lfo->targetArgs.push_back("--jfs_constants=" + constantTablePath);
     }
+    lfo->dictionaryFile = dictionaryPath;
+    // With an empty buffer there is only a single run so extra workers
+    // would just repeat it.
+    bool useWorkers = options->numFuzzingWorkers > 1 && lfo->maxLength > 0;
+    if (corpusDir.size() == 0 && (!inProcess || useWorkers)) {
+      // When LibFuzzer runs in-process the seeds are passed in memory so
+      // a corpus directory is only needed to share inputs between workers.
+      corpusDir = wdm->makeNewDirectoryInDirectory("corpus");
+    }
+    if (corpusDir.size() > 0) {
+      lfo->corpusDir = corpusDir;
+    }
+    if (!inProcess) {
+      std::string artifactDir = wdm->makeNewDirectoryInDirectory("artifacts");
+      lfo->artifactDir = artifactDir;
+    }
+    std::string libFuzzerStdOutFile;
+    std::string libFuzzerStdErrFile;
+
     // Fuzz
-    auto fuzzingResponse =
-        lim.fuzz(lfo, libFuzzerStdOutFile, libFuzzerStdErrFile);
+    std::unique_ptr<LibFuzzerResponse> fuzzingResponse;
+    if (useWorkers) {
+      fuzzingResponse = fuzzWithWorkers(lfo, inProcess);
+    } else {
+      if (options->redirectLibFuzzerOutput) {
+        // When being quiet redirect to files
+        libFuzzerStdOutFile =
+            wdm->getPathToFileInDirectory("libfuzzer.stdout.txt");
+        libFuzzerStdErrFile =
+            wdm->getPathToFileInDirectory("libfuzzer.stderr.txt");
+        // Needed for the dictionary stats. The stats are read back from
+        // LibFuzzer's output so they are only available when it is
+        // redirected.
+        if (ctx.getStats() != nullptr && dictionary.size() > 0) {
+          lfo->printFinalStats = true;
+        }
+      }
+      fuzzingResponse =
+          runFuzzer(&lim, lfo, inProcess, libFuzzerStdOutFile,
+                    libFuzzerStdErrFile);
+    }
+
+    if (ctx.getStats() != nullptr && dictionary.size() > 0) {
+      std::unique_ptr<JFSCXXFuzzingDictionaryStat> stat(
+          new JFSCXXFuzzingDictionaryStat("CXXFuzzingSolverDictionary"));
+      stat->numEntries = dictionary.size();
+      stat->numUsedEntries = fuzzingResponse->numUsedDictionaryEntries;
+      ctx.getStats()->append(std::move(stat));
+    }
 
     switch (fuzzingResponse->outcome) {
     case LibFuzzerResponse::ResponseTy::UNKNOWN:
@@ -316,6 +950,7 @@ public:
     }
     return nullptr;
   }
+#undef CHECK_CANCELLED
 };
 
 CXXFuzzingSolver::CXXFuzzingSolver(
@@ -335,6 +970,12 @@ CXXFuzzingSolver::fuzz(jfs::core::Query &q, bool produceModel,
   return impl->fuzz(q, produceModel, info);
 }
 
+bool CXXFuzzingSolver::checksConstraintsByCost() const {
+  return static_cast<const CXXFuzzingSolverOptions*>(options.get())
+      ->getCXXProgramBuilderOptions()
+      ->orderConstraintsByCost;
+}
+
 llvm::StringRef CXXFuzzingSolver::getName() const { return "CXXFuzzingSolver"; }
 
 void CXXFuzzingSolver::cancel() {
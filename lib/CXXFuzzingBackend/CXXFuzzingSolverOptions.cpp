@@ -20,9 +20,14 @@ namespace cxxfb {
 
 CXXFuzzingSolverOptions::CXXFuzzingSolverOptions(
     std::unique_ptr<ClangOptions> clangOpt,
-    std::unique_ptr<jfs::fuzzingCommon::LibFuzzerOptions> libFuzzerOpt)
+    std::unique_ptr<jfs::fuzzingCommon::LibFuzzerOptions> libFuzzerOpt,
+    std::unique_ptr<CXXProgramBuilderOptions> programBuilderOpt)
     : jfs::core::SolverOptions(CXX_FUZZING_SOLVER_KIND),
       clangOpt(std::move(clangOpt)), libFuzzerOpt(std::move(libFuzzerOpt)),
-      redirectClangOutput(false), redirectLibFuzzerOutput(false) {}
+      programBuilderOpt(std::move(programBuilderOpt)),
+      redirectClangOutput(false), redirectLibFuzzerOutput(false),
+      numFuzzingWorkers(1), varyFuzzingWorkerStrategy(false),
+      programCacheDir(""), pipeSourceToClang(false), relaxedModelSeedTimeout(0),
+      profileWarmUpTime(0), profileWarmUpPGO(false) {}
 }
 }
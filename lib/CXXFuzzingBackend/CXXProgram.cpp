@@ -158,7 +158,7 @@ void CXXDeclAndDefnVarStatement::print(llvm::raw_ostream& os) const {
 }
 
 // CXXGenericStatement
-CXXGenericStatement::CXXGenericStatement(CXXCodeBlock* parent,
+CXXGenericStatement::CXXGenericStatement(CXXDecl* parent,
                                          llvm::StringRef statement)
     : CXXStatement(parent), statement(statement.str()) {}
 
@@ -169,6 +169,13 @@ void CXXGenericStatement::print(llvm::raw_ostream& os) const {
 // CXXProgram
 
 void CXXProgram::print(llvm::raw_ostream& os) const {
+  printTranslationUnit(os);
+  for (const auto& tu : translationUnits) {
+    tu->print(os);
+  }
+}
+
+void CXXProgram::printTranslationUnit(llvm::raw_ostream& os) const {
   os << "// Begin program\n";
   for (const auto& decl : decls) {
     decl->print(os);
@@ -177,5 +184,13 @@ void CXXProgram::print(llvm::raw_ostream& os) const {
 }
 
 void CXXProgram::appendDecl(CXXDeclRef decl) { decls.push_back(decl); }
+
+void CXXProgram::prependDecl(CXXDeclRef decl) {
+  decls.insert(decls.begin(), decl);
+}
+
+void CXXProgram::appendTranslationUnit(CXXProgramRef tu) {
+  translationUnits.push_back(tu);
+}
 }
 }
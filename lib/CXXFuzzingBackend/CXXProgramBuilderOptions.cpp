@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/CXXFuzzingBackend/CXXProgramBuilderOptions.h"
+#include "llvm/Support/ErrorHandling.h"
+
+namespace jfs {
+namespace cxxfb {
+
+CXXProgramBuilderOptions::CXXProgramBuilderOptions()
+    : fuzzingTarget(FuzzingTargetTy::ABORT), liftConstants(false),
+      numConstraintPartitions(1), customMutator(false),
+      buildDictionary(false), distanceFeedback(false),
+      traceFloatComparisons(false), countSatisfiedConstraints(false),
+      orderConstraintsByCost(false), recordRejections(false),
+      lazyDecoding(false) {}
+
+void CXXProgramBuilderOptions::dump() const { print(llvm::errs()); }
+
+void CXXProgramBuilderOptions::print(llvm::raw_ostream& os) const {
+  os << "fuzzingTarget: ";
+  switch (fuzzingTarget) {
+  case FuzzingTargetTy::ABORT:
+    os << "ABORT\n";
+    break;
+  case FuzzingTargetTy::LIBFUZZER_CALLBACK:
+    os << "LIBFUZZER_CALLBACK\n";
+    break;
+  default:
+    llvm_unreachable("Unhandled fuzzing target");
+  }
+  os << "liftConstants: " << (liftConstants ? "true" : "false") << "\n";
+  os << "numConstraintPartitions: " << numConstraintPartitions << "\n";
+  os << "customMutator: " << (customMutator ? "true" : "false") << "\n";
+  os << "buildDictionary: " << (buildDictionary ? "true" : "false") << "\n";
+  os << "distanceFeedback: " << (distanceFeedback ? "true" : "false") << "\n";
+  os << "traceFloatComparisons: "
+     << (traceFloatComparisons ? "true" : "false") << "\n";
+  os << "countSatisfiedConstraints: "
+     << (countSatisfiedConstraints ? "true" : "false") << "\n";
+  os << "orderConstraintsByCost: "
+     << (orderConstraintsByCost ? "true" : "false") << "\n";
+  os << "recordRejections: " << (recordRejections ? "true" : "false") << "\n";
+  os << "lazyDecoding: " << (lazyDecoding ? "true" : "false") << "\n";
+}
+}
+}
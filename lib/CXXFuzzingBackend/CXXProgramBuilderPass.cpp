@@ -21,13 +21,28 @@ namespace jfs {
 namespace cxxfb {
 
 CXXProgramBuilderPass::CXXProgramBuilderPass(
-    std::shared_ptr<FuzzingAnalysisInfo> info, JFSContext& ctx)
-    : impl(new CXXProgramBuilderPassImpl(info, ctx)) {}
+    std::shared_ptr<FuzzingAnalysisInfo> info,
+    const CXXProgramBuilderOptions* options, JFSContext& ctx)
+    : impl(new CXXProgramBuilderPassImpl(info, options, ctx)) {}
 
 std::shared_ptr<CXXProgram> CXXProgramBuilderPass::getProgram() {
   return impl->program;
 }
 
+const std::vector<uint64_t>& CXXProgramBuilderPass::getConstantTable() const {
+  return impl->constantTable;
+}
+
+const std::vector<std::vector<uint8_t>>&
+CXXProgramBuilderPass::getDictionary() const {
+  return impl->dictionary;
+}
+
+const std::vector<Z3ASTHandle>&
+CXXProgramBuilderPass::getConstraintOrder() const {
+  return impl->constraintOrder;
+}
+
 CXXProgramBuilderPass::~CXXProgramBuilderPass() {}
 
 llvm::StringRef CXXProgramBuilderPass::getName() { return "CXXProgramBuilder"; }
@@ -12,20 +12,33 @@
 #include "jfs/CXXFuzzingBackend/CXXProgram.h"
 #include "jfs/CXXFuzzingBackend/JFSCXXProgramStat.h"
 #include "jfs/Core/Z3Node.h"
+#include "jfs/Core/IfVerbose.h"
 #include "jfs/Core/Z3NodeMap.h"
+#include "jfs/FuzzingCommon/ConstraintOrdering.h"
 #include "jfs/Support/StatisticsManager.h"
+#include <algorithm>
 #include <ctype.h>
 #include <list>
+#include <set>
 
 using namespace jfs::core;
 using namespace jfs::fuzzingCommon;
 
+namespace {
+// Must match `JFS_DISTANCE_COUNTERS_PER_CMP` in the runtime.
+const uint64_t JFSDistanceCountersPerComparison = 65;
+}
+
 namespace jfs {
 namespace cxxfb {
 
 CXXProgramBuilderPassImpl::CXXProgramBuilderPassImpl(
-    std::shared_ptr<FuzzingAnalysisInfo> info, JFSContext& ctx)
+    std::shared_ptr<FuzzingAnalysisInfo> info,
+    const CXXProgramBuilderOptions* options, JFSContext& ctx)
     : ctx(ctx), info(info) {
+  if (options) {
+    this->options = *options;
+  }
   program = std::make_shared<CXXProgram>();
 
   // Setup early exit code block
@@ -37,6 +50,16 @@ CXXProgramBuilderPassImpl::CXXProgramBuilderPassImpl(
 }
 
 CXXTypeRef CXXProgramBuilderPassImpl::getOrInsertTy(Z3SortHandle sort) {
+  switch (sort.getKind()) {
+  case Z3_BV_SORT:
+    needsBitVectorHeader = true;
+    break;
+  case Z3_FLOATING_POINT_SORT:
+    needsFloatHeader = true;
+    break;
+  default:
+    break;
+  }
   auto cachedIt = sortToCXXTypeCache.find(sort);
   if (cachedIt != sortToCXXTypeCache.end()) {
     return cachedIt->second;
@@ -82,16 +105,8 @@ CXXTypeRef CXXProgramBuilderPassImpl::getOrInsertTy(Z3SortHandle sort) {
 
 CXXFunctionDeclRef CXXProgramBuilderPassImpl::buildEntryPoint() {
   program = std::make_shared<CXXProgram>();
-  // Runtime header includes
-  // FIXME: We should probe the query and only emit these header includes
-  // if we actually need them.
-  program->appendDecl(std::make_shared<CXXIncludeDecl>(program.get(),
-                                                       "SMTLIB/Core.h",
-                                                       /*systemHeader=*/false));
-  program->appendDecl(std::make_shared<CXXIncludeDecl>(
-      program.get(), "SMTLIB/BitVector.h", /*systemHeader=*/false));
-  program->appendDecl(std::make_shared<CXXIncludeDecl>(
-      program.get(), "SMTLIB/Float.h", /*systemHeader=*/false));
+  // NOTE: Runtime header includes are inserted by `insertRuntimeIncludes()`
+  // once we know which ones are needed.
   // Int types header for LibFuzzer entry point definition.
   program->appendDecl(std::make_shared<CXXIncludeDecl>(program.get(),
                                                        "stdint.h",
@@ -100,10 +115,24 @@ CXXFunctionDeclRef CXXProgramBuilderPassImpl::buildEntryPoint() {
                                                        "stdlib.h",
                                                        /*systemHeader=*/true));
 
-  // Build entry point for LibFuzzer
-  auto retTy = std::make_shared<CXXType>(program.get(), "int");
   auto firstArgTy = std::make_shared<CXXType>(program.get(), "const uint8_t*");
   auto secondArgTy = std::make_shared<CXXType>(program.get(), "size_t");
+  if (options.fuzzingTarget ==
+      CXXProgramBuilderOptions::FuzzingTargetTy::LIBFUZZER_CALLBACK) {
+    // Declare the callback provided by JFS's build of LibFuzzer.
+    auto voidTy = std::make_shared<CXXType>(program.get(), "void");
+    auto callbackArguments = std::vector<CXXFunctionArgumentRef>();
+    callbackArguments.push_back(std::make_shared<CXXFunctionArgument>(
+        program.get(), "data", firstArgTy));
+    callbackArguments.push_back(std::make_shared<CXXFunctionArgument>(
+        program.get(), "size", secondArgTy));
+    program->appendDecl(std::make_shared<CXXFunctionDecl>(
+        program.get(), "jfs_libfuzzer_target_found", voidTy, callbackArguments,
+        /*hasCVisibility=*/true));
+  }
+
+  // Build entry point for LibFuzzer
+  auto retTy = std::make_shared<CXXType>(program.get(), "int");
   entryPointFirstArgName = insertSymbol("data");
   auto firstArg = std::make_shared<CXXFunctionArgument>(
       program.get(), entryPointFirstArgName, firstArgTy);
@@ -118,7 +147,8 @@ CXXFunctionDeclRef CXXProgramBuilderPassImpl::buildEntryPoint() {
       /*hasCVisibility=*/true);
   auto funcBody = std::make_shared<CXXCodeBlock>(funcDefn.get());
   funcDefn->defn = funcBody; // FIXME: shouldn't be done like this
-  program->appendDecl(funcDefn);
+  // NOTE: `build()` appends the entry point to the program so that functions
+  // it calls can be declared first.
   return funcDefn;
 }
 
@@ -264,37 +294,57 @@ void CXXProgramBuilderPassImpl::insertFreeVariableConstruction(
   auto bufferRefAssignment = std::make_shared<CXXDeclAndDefnVarStatement>(
       cb.get(), bufferRefTy, bufferRefName, underlyingString);
   cb->statements.push_back(bufferRefAssignment);
-  unsigned currentBufferBit = 0;
 
   // Walk through free variables and construct CXX code to initialize them
-  // from the buffer.
+  // from the buffer. When decoding lazily the code is emitted by
+  // `insertPendingDecode()` instead, right before the first constraint that
+  // uses the variable, so that inputs rejected early are only partly decoded.
+  pendingDecodes.clear();
   for (const auto& be : ba) {
     // Add assignment
     auto assignmentTy = getOrInsertTy(be.getSort());
     llvm::StringRef sanitizedSymbolName =
-        insertSSASymbolForExpr(be.declApp, be.getName());
+        options.lazyDecoding ? insertSymbol(be.getName())
+                             : insertSSASymbolForExpr(be.declApp, be.getName());
+    unsigned currentBufferBit = be.getBitOffset();
     unsigned endBufferBit = (currentBufferBit + be.getBitWidth()) - 1;
 
-    // Build string `makeBitVectorFrom<a,b>(jfs_buffer_ref)`
-    // where a is min bit and b is max bit from `jfs_buffer_ref`.
+    // Build string `makeBitVectorFrom<w, a, b>(jfs_buffer_ref)`
+    // where a is min bit and b is max bit from `jfs_buffer_ref`. The bits
+    // are template arguments so that clang can fold the decoding into a
+    // load, shift and mask.
     underlyingString.clear();
     switch (be.getSort().getKind()) {
     case Z3_BOOL_SORT: {
       assert((endBufferBit - currentBufferBit + 1) <= 8);
-      ss << "makeBoolFrom(" << bufferRefName << ", " << currentBufferBit << ", "
-         << endBufferBit << ")";
+      needsCoreHeader = true;
+      ss << "makeBoolFrom<" << currentBufferBit << ", " << endBufferBit
+         << ">(" << bufferRefName << ")";
       break;
     }
     case Z3_BV_SORT: {
+      if (be.hasInterval()) {
+        ss << "makeBitVectorInRangeFrom<" << be.getSortBitWidth()
+           << ", UINT64_C(" << be.getIntervalLow() << "), UINT64_C("
+           << be.getIntervalHigh() << "), " << currentBufferBit << ", "
+           << endBufferBit << ">(" << bufferRefName << ")";
+        break;
+      }
+      if (be.hasDeadBits()) {
+        ss << "makeBitVectorFromLiveBits<" << be.getSortBitWidth() << ", "
+           << be.getLiveLowBit() << ", " << currentBufferBit << ", "
+           << endBufferBit << ">(" << bufferRefName << ")";
+        break;
+      }
       ss << "makeBitVectorFrom"
-         << "<" << be.getBitWidth() << ">(" << bufferRefName << ", "
-         << currentBufferBit << ", " << endBufferBit << ")";
+         << "<" << be.getBitWidth() << ", " << currentBufferBit << ", "
+         << endBufferBit << ">(" << bufferRefName << ")";
       break;
     }
     case Z3_FLOATING_POINT_SORT: {
       ss << "makeFloatFrom<" << be.getSort().getFloatingPointExponentBitWidth()
-         << "," << be.getSort().getFloatingPointSignificandBitWidth() << ">("
-         << bufferRefName << ", " << currentBufferBit << ", " << endBufferBit
+         << ", " << be.getSort().getFloatingPointSignificandBitWidth() << ", "
+         << currentBufferBit << ", " << endBufferBit << ">(" << bufferRefName
          << ")";
       break;
     }
@@ -302,19 +352,32 @@ void CXXProgramBuilderPassImpl::insertFreeVariableConstruction(
       llvm_unreachable("Unhandled sort");
     }
     ss.flush();
-    auto assignmentStmt = std::make_shared<CXXDeclAndDefnVarStatement>(
-        cb.get(), assignmentTy, sanitizedSymbolName, underlyingString);
-    cb->statements.push_back(assignmentStmt);
+    if (options.lazyDecoding) {
+      pendingDecodes.insert(std::make_pair(
+          be.declApp,
+          PendingDecode{sanitizedSymbolName, underlyingString, Z3ASTHandle()}));
+    } else {
+      auto assignmentStmt = std::make_shared<CXXDeclAndDefnVarStatement>(
+          cb.get(), assignmentTy, sanitizedSymbolName, underlyingString);
+      cb->statements.push_back(assignmentStmt);
+    }
 
-    currentBufferBit += be.getBitWidth();
     // Add equalities
     // FIXME: When we support casts this code will need to be fixed
     for (const auto& e : be.equalities) {
       assert(e.isFreeVariable() && "should be free variable");
+      assert(e.getSort() == be.getSort() && "sorts don't match");
+      if (options.lazyDecoding) {
+        llvm::StringRef otherVarName =
+            insertSymbol(e.asApp().getFuncDecl().getName());
+        pendingDecodes.insert(std::make_pair(
+            e, PendingDecode{otherVarName, sanitizedSymbolName.str(),
+                             be.declApp}));
+        continue;
+      }
 
       llvm::StringRef otherVarName =
           insertSSASymbolForExpr(e, e.asApp().getFuncDecl().getName());
-      assert(e.getSort() == be.getSort() && "sorts don't match");
       auto equalityAssignmentStmt =
           std::make_shared<CXXDeclAndDefnVarStatement>(
               cb.get(), assignmentTy, otherVarName, sanitizedSymbolName);
@@ -323,6 +386,28 @@ void CXXProgramBuilderPassImpl::insertFreeVariableConstruction(
   }
 }
 
+bool CXXProgramBuilderPassImpl::insertPendingDecode(Z3ASTHandle e) {
+  auto it = pendingDecodes.find(e);
+  if (it == pendingDecodes.end())
+    return false;
+  PendingDecode decode = it->second;
+  pendingDecodes.erase(it);
+  // Variables that are equal to another share its decoded value.
+  if (!decode.aliasOf.isNull() && !hasBeenVisited(decode.aliasOf)) {
+    bool decoded = insertPendingDecode(decode.aliasOf);
+    assert(decoded && "aliased variable was not decoded");
+    (void)decoded;
+  }
+  auto statusPair = exprToSymbolName.insert(std::make_pair(e, decode.symbol));
+  assert(statusPair.second && "expr already has symbol");
+  (void)statusPair;
+  getCurrentBlock()->statements.push_back(
+      std::make_shared<CXXDeclAndDefnVarStatement>(
+          getCurrentBlock().get(), getOrInsertTy(e.getSort()), decode.symbol,
+          decode.expr));
+  return true;
+}
+
 void CXXProgramBuilderPassImpl::insertConstantAssignments(CXXCodeBlockRef cb) {
   // FIXME: Due to constant propagation constant assignments should not be
   // present. We probably should just remove this entirely.
@@ -354,7 +439,7 @@ void CXXProgramBuilderPassImpl::insertConstantAssignments(CXXCodeBlockRef cb) {
 }
 
 void CXXProgramBuilderPassImpl::insertBranchForConstraint(
-    Z3ASTHandle constraint) {
+    Z3ASTHandle constraint, size_t constraintIndex) {
   assert(constraint.getSort().isBoolTy());
   // TODO: investigate whether it is better to construct
   // if (!e) { return 0; }
@@ -367,21 +452,585 @@ void CXXProgramBuilderPassImpl::insertBranchForConstraint(
   doDFSPostOrderTraversal(constraint);
   assert(exprToSymbolName.count(constraint) > 0);
 
+  if (options.distanceFeedback) {
+    insertDistanceFeedback(constraint);
+  }
+
   llvm::StringRef symbolForConstraint = getSymbolFor(constraint);
+  if (options.countSatisfiedConstraints) {
+    // Don't exit early. Remember that the constraint was satisfied and check
+    // that they all were once every constraint has been evaluated.
+    std::string underlyingString;
+    llvm::raw_string_ostream ss(underlyingString);
+    ss << "jfs_extra_counters["
+       << (satisfiedConstraintCountersOffset + constraintIndex)
+       << "] |= " << symbolForConstraint;
+    getCurrentBlock()->statements.push_back(
+        std::make_shared<CXXGenericStatement>(getCurrentBlock().get(),
+                                              ss.str()));
+    underlyingString.clear();
+    ss << numSatisfiedConstraintsSymbol << " += " << symbolForConstraint;
+    getCurrentBlock()->statements.push_back(
+        std::make_shared<CXXGenericStatement>(getCurrentBlock().get(),
+                                              ss.str()));
+    return;
+  }
   auto ifStatement = std::make_shared<CXXIfStatement>(getCurrentBlock().get(),
                                                       symbolForConstraint);
   ifStatement->trueBlock = nullptr;
-  ifStatement->falseBlock = earlyExitBlock;
+  ifStatement->falseBlock = getRejectionBlock(constraintIndex);
   getCurrentBlock()->statements.push_back(ifStatement);
 }
 
+CXXCodeBlockRef
+CXXProgramBuilderPassImpl::getRejectionBlock(size_t constraintIndex) {
+  if (!recordRejections)
+    return earlyExitBlock;
+  // Blame the constraint before returning.
+  auto block = std::make_shared<CXXCodeBlock>(program.get());
+  std::string underlyingString;
+  llvm::raw_string_ostream ss(underlyingString);
+  ss << "++jfs_rejection_counts[" << constraintIndex << "]";
+  block->statements.push_back(
+      std::make_shared<CXXGenericStatement>(block.get(), ss.str()));
+  block->statements.push_back(
+      std::make_shared<CXXReturnIntStatement>(block.get(), 0));
+  return block;
+}
+
+void CXXProgramBuilderPassImpl::insertRejectionCounts() {
+  // One counter per constraint followed by the number of inputs that were
+  // checked against the constraints at all.
+  std::string underlyingString;
+  llvm::raw_string_ostream ss(underlyingString);
+  ss << "extern \"C\" uint64_t jfs_rejection_counts["
+     << (constraintOrder.size() + 1) << "] = {}";
+  program->appendDecl(
+      std::make_shared<CXXGenericStatement>(program.get(), ss.str()));
+}
+
+void CXXProgramBuilderPassImpl::insertDistanceFeedback(
+    Z3ASTHandle constraint) {
+  if (!constraint.isApp())
+    return;
+  Z3AppHandle app = constraint.asApp();
+  if (app.getNumKids() != 2)
+    return;
+  Z3ASTHandle lhs = app.getKid(0);
+  Z3ASTHandle rhs = app.getKid(1);
+  Z3SortHandle sort = lhs.getSort();
+  if (sort.isBitVectorTy()) {
+    // The runtime only gives raw access to native bitvectors.
+    if (sort.getBitVectorWidth() > 64)
+      return;
+  } else if (!sort.isFloatingPointTy()) {
+    return;
+  }
+  const char* distanceFn = nullptr;
+  bool swapArgs = false;
+  switch (app.getKind()) {
+  case Z3_OP_EQ:
+    distanceFn =
+        sort.isBitVectorTy() ? "jfs_distance_bv_eq" : "jfs_distance_fp_smt_eq";
+    break;
+  case Z3_OP_ULT:
+  case Z3_OP_UGT:
+    distanceFn = "jfs_distance_bvult";
+    swapArgs = app.getKind() == Z3_OP_UGT;
+    break;
+  case Z3_OP_ULEQ:
+  case Z3_OP_UGEQ:
+    distanceFn = "jfs_distance_bvule";
+    swapArgs = app.getKind() == Z3_OP_UGEQ;
+    break;
+  case Z3_OP_SLT:
+  case Z3_OP_SGT:
+    distanceFn = "jfs_distance_bvslt";
+    swapArgs = app.getKind() == Z3_OP_SGT;
+    break;
+  case Z3_OP_SLEQ:
+  case Z3_OP_SGEQ:
+    distanceFn = "jfs_distance_bvsle";
+    swapArgs = app.getKind() == Z3_OP_SGEQ;
+    break;
+  case Z3_OP_FPA_EQ:
+    distanceFn = "jfs_distance_fp_eq";
+    break;
+  case Z3_OP_FPA_LT:
+  case Z3_OP_FPA_GT:
+    distanceFn = "jfs_distance_fp_lt";
+    swapArgs = app.getKind() == Z3_OP_FPA_GT;
+    break;
+  case Z3_OP_FPA_LE:
+  case Z3_OP_FPA_GE:
+    distanceFn = "jfs_distance_fp_leq";
+    swapArgs = app.getKind() == Z3_OP_FPA_GE;
+    break;
+  default:
+    return;
+  }
+  if (swapArgs)
+    std::swap(lhs, rhs);
+
+  // Build `jfs_record_distance(jfs_extra_counters + <offset>,
+  // <distanceFn>(lhs, rhs))`
+  std::string underlyingString;
+  llvm::raw_string_ostream ss(underlyingString);
+  ss << "jfs_record_distance(jfs_extra_counters + "
+     << allocateExtraCounters(JFSDistanceCountersPerComparison) << ", "
+     << distanceFn << "(" << getSymbolFor(lhs) << ", " << getSymbolFor(rhs)
+     << "))";
+  getCurrentBlock()->statements.push_back(
+      std::make_shared<CXXGenericStatement>(getCurrentBlock().get(), ss.str()));
+  ++numDistanceComparisons;
+}
+
+unsigned CXXProgramBuilderPassImpl::allocateExtraCounters(unsigned numCounters) {
+  unsigned offset = numExtraCounters;
+  numExtraCounters += numCounters;
+  return offset;
+}
+
+void CXXProgramBuilderPassImpl::insertExtraCounters() {
+  // LibFuzzer treats every byte of the `__libfuzzer_extra_counters` section
+  // as a coverage counter. It clears the section a word at a time so the
+  // size is rounded up to a multiple of 8 bytes.
+  assert(numExtraCounters > 0);
+  uint64_t numCounters = (numExtraCounters + 7) & ~UINT64_C(7);
+  std::string underlyingString;
+  llvm::raw_string_ostream ss(underlyingString);
+  ss << "extern \"C\" __attribute__((section(\"__libfuzzer_extra_counters\"), "
+        "aligned(8))) uint8_t jfs_extra_counters["
+     << numCounters << "] = {}";
+  program->appendDecl(
+      std::make_shared<CXXGenericStatement>(program.get(), ss.str()));
+  // Exported so the counters can be found when the program is a shared
+  // object loaded by JFS's copy of LibFuzzer.
+  underlyingString.clear();
+  ss << "extern \"C\" const size_t jfs_num_extra_counters = " << numCounters;
+  program->appendDecl(
+      std::make_shared<CXXGenericStatement>(program.get(), ss.str()));
+}
+
+void CXXProgramBuilderPassImpl::insertSatisfiedConstraintsCounter(
+    CXXCodeBlockRef cb) {
+  numSatisfiedConstraintsSymbol = insertSymbol("jfs_num_satisfied");
+  auto counterTy = std::make_shared<CXXType>(program.get(), "uint64_t",
+                                             /*isConst=*/false);
+  cb->statements.push_back(std::make_shared<CXXDeclAndDefnVarStatement>(
+      cb.get(), counterTy, numSatisfiedConstraintsSymbol, "0"));
+}
+
+void CXXProgramBuilderPassImpl::insertSatisfiedConstraintsCheck(
+    CXXCodeBlockRef cb, size_t numConstraints) {
+  // Reaching a higher count than before is a new feature.
+  std::string underlyingString;
+  llvm::raw_string_ostream ss(underlyingString);
+  ss << "jfs_extra_counters["
+     << (satisfiedConstraintCountersOffset + numConstraints) << " + "
+     << numSatisfiedConstraintsSymbol << "] = 1";
+  cb->statements.push_back(
+      std::make_shared<CXXGenericStatement>(cb.get(), ss.str()));
+  underlyingString.clear();
+  ss << numSatisfiedConstraintsSymbol << " == " << numConstraints;
+  auto ifStatement = std::make_shared<CXXIfStatement>(cb.get(), ss.str());
+  ifStatement->trueBlock = nullptr;
+  ifStatement->falseBlock = earlyExitBlock;
+  cb->statements.push_back(ifStatement);
+}
+
+void CXXProgramBuilderPassImpl::insertFloatComparisonTrace(Z3ASTHandle lhs,
+                                                            Z3ASTHandle rhs) {
+  if (!options.traceFloatComparisons)
+    return;
+  std::string underlyingString;
+  llvm::raw_string_ostream ss(underlyingString);
+  ss << "jfs_trace_fp_cmp(" << getSymbolFor(lhs) << ", " << getSymbolFor(rhs)
+     << ")";
+  getCurrentBlock()->statements.push_back(
+      std::make_shared<CXXGenericStatement>(getCurrentBlock().get(), ss.str()));
+}
+
+void CXXProgramBuilderPassImpl::insertConstraintPartitions(
+    const std::vector<Z3ASTHandle>& constraints, unsigned numPartitions,
+    CXXCodeBlockRef cb) {
+  assert(numPartitions > 1 && numPartitions <= constraints.size());
+  auto retTy = std::make_shared<CXXType>(program.get(), "int");
+  auto firstArgTy = std::make_shared<CXXType>(program.get(), "const uint8_t*");
+  auto secondArgTy = std::make_shared<CXXType>(program.get(), "size_t");
+  auto funcArguments = std::vector<CXXFunctionArgumentRef>();
+  funcArguments.push_back(std::make_shared<CXXFunctionArgument>(
+      program.get(), entryPointFirstArgName, firstArgTy));
+  funcArguments.push_back(std::make_shared<CXXFunctionArgument>(
+      program.get(), entryPointSecondArgName, secondArgTy));
+
+  const size_t numConstraints = constraints.size();
+  size_t constraintIndex = 0;
+  for (unsigned index = 0; index < numPartitions; ++index) {
+    // Spread the remainder over the first partitions.
+    size_t partitionSize = (numConstraints / numPartitions) +
+                           ((index < (numConstraints % numPartitions)) ? 1 : 0);
+    std::string underlyingString;
+    llvm::raw_string_ostream ss(underlyingString);
+    ss << "jfs_check_constraints_" << index;
+    llvm::StringRef funcName = insertSymbol(ss.str());
+
+    // Returns 1 iff all the constraints in the partition are satisfied.
+    auto tu = std::make_shared<CXXProgram>();
+    tu->appendDecl(std::make_shared<CXXIncludeDecl>(tu.get(), "stdint.h",
+                                                    /*systemHeader=*/true));
+    tu->appendDecl(std::make_shared<CXXIncludeDecl>(tu.get(), "stdlib.h",
+                                                    /*systemHeader=*/true));
+    if (options.distanceFeedback || options.countSatisfiedConstraints) {
+      // Defined by the main translation unit.
+      tu->appendDecl(std::make_shared<CXXGenericStatement>(
+          tu.get(), "extern \"C\" uint8_t jfs_extra_counters[]"));
+    }
+    if (recordRejections) {
+      tu->appendDecl(std::make_shared<CXXGenericStatement>(
+          tu.get(), "extern \"C\" uint64_t jfs_rejection_counts[]"));
+    }
+    auto funcDefn = std::make_shared<CXXFunctionDecl>(
+        tu.get(), funcName, retTy, funcArguments, /*hasCVisibility=*/false);
+    auto funcBody = std::make_shared<CXXCodeBlock>(funcDefn.get());
+    funcDefn->defn = funcBody; // FIXME: shouldn't be done like this
+    tu->appendDecl(funcDefn);
+    program->appendDecl(std::make_shared<CXXFunctionDecl>(
+        program.get(), funcName, retTy, funcArguments,
+        /*hasCVisibility=*/false));
+
+    // Each function has its own SSA variables.
+    exprToSymbolName.clear();
+    entryPointMainBlock = funcBody;
+    insertFreeVariableConstruction(funcBody);
+    insertConstantAssignments(funcBody);
+    // When counting satisfied constraints the function returns how many of
+    // its constraints are satisfied instead.
+    llvm::StringRef entryPointNumSatisfiedSymbol =
+        numSatisfiedConstraintsSymbol;
+    if (options.countSatisfiedConstraints)
+      insertSatisfiedConstraintsCounter(funcBody);
+    for (size_t end = constraintIndex + partitionSize; constraintIndex < end;
+         ++constraintIndex) {
+      insertBranchForConstraint(constraints[constraintIndex],
+                                constraintIndex);
+    }
+    if (options.countSatisfiedConstraints) {
+      underlyingString.clear();
+      ss << "return " << numSatisfiedConstraintsSymbol;
+      funcBody->statements.push_back(
+          std::make_shared<CXXGenericStatement>(funcBody.get(), ss.str()));
+      numSatisfiedConstraintsSymbol = entryPointNumSatisfiedSymbol;
+    } else {
+      funcBody->statements.push_back(
+          std::make_shared<CXXReturnIntStatement>(funcBody.get(), 1));
+    }
+    program->appendTranslationUnit(tu);
+
+    // Call from the entry point
+    underlyingString.clear();
+    if (options.countSatisfiedConstraints) {
+      ss << numSatisfiedConstraintsSymbol << " += " << funcName << "("
+         << entryPointFirstArgName << ", " << entryPointSecondArgName << ")";
+      cb->statements.push_back(
+          std::make_shared<CXXGenericStatement>(cb.get(), ss.str()));
+      continue;
+    }
+    ss << funcName << "(" << entryPointFirstArgName << ", "
+       << entryPointSecondArgName << ")";
+    ss.flush();
+    auto ifStatement =
+        std::make_shared<CXXIfStatement>(cb.get(), underlyingString);
+    ifStatement->trueBlock = nullptr;
+    ifStatement->falseBlock = earlyExitBlock;
+    cb->statements.push_back(ifStatement);
+  }
+  assert(constraintIndex == numConstraints);
+  entryPointMainBlock = cb;
+}
+
 void CXXProgramBuilderPassImpl::insertFuzzingTarget(CXXCodeBlockRef cb) {
-  // FIXME: Replace this with something that we can use to
-  // communicate LibFuzzer's outcome
   cb->statements.push_back(
       std::make_shared<CXXCommentBlock>(cb.get(), "Fuzzing target"));
-  cb->statements.push_back(
-      std::make_shared<CXXGenericStatement>(cb.get(), "abort()"));
+  switch (options.fuzzingTarget) {
+  case CXXProgramBuilderOptions::FuzzingTargetTy::ABORT:
+    cb->statements.push_back(
+        std::make_shared<CXXGenericStatement>(cb.get(), "abort()"));
+    break;
+  case CXXProgramBuilderOptions::FuzzingTargetTy::LIBFUZZER_CALLBACK: {
+    std::string underlyingString;
+    llvm::raw_string_ostream ss(underlyingString);
+    ss << "jfs_libfuzzer_target_found(" << entryPointFirstArgName << ", "
+       << entryPointSecondArgName << ")";
+    cb->statements.push_back(
+        std::make_shared<CXXGenericStatement>(cb.get(), ss.str()));
+    break;
+  }
+  default:
+    llvm_unreachable("Unhandled fuzzing target");
+  }
+}
+
+void CXXProgramBuilderPassImpl::insertFuzzerInitializer() {
+  // LibFuzzer calls `LLVMFuzzerInitialize()` once at start up. That is where
+  // the constant table is loaded and the rejection profile is set up.
+  auto intTy = std::make_shared<CXXType>(program.get(), "int");
+  auto argcTy = std::make_shared<CXXType>(program.get(), "int*");
+  auto argvTy = std::make_shared<CXXType>(program.get(), "char***");
+  auto funcArguments = std::vector<CXXFunctionArgumentRef>();
+  funcArguments.push_back(
+      std::make_shared<CXXFunctionArgument>(program.get(), "argc", argcTy));
+  funcArguments.push_back(
+      std::make_shared<CXXFunctionArgument>(program.get(), "argv", argvTy));
+  auto funcDefn = std::make_shared<CXXFunctionDecl>(
+      program.get(), "LLVMFuzzerInitialize", intTy, funcArguments,
+      /*hasCVisibility=*/true);
+  auto funcBody = std::make_shared<CXXCodeBlock>(funcDefn.get());
+  funcDefn->defn = funcBody; // FIXME: shouldn't be done like this
+  std::string underlyingString;
+  llvm::raw_string_ostream ss(underlyingString);
+  if (recordRejections) {
+    ss << "jfs_setup_rejection_profile(argc, argv, jfs_rejection_counts, "
+          "UINT64_C("
+       << (constraintOrder.size() + 1) << "))";
+    funcBody->statements.push_back(
+        std::make_shared<CXXGenericStatement>(funcBody.get(), ss.str()));
+    underlyingString.clear();
+  }
+  if (options.liftConstants) {
+    ss << "return jfs_load_constant_table(argc, argv, UINT64_C("
+       << constantTable.size() << "))";
+    funcBody->statements.push_back(
+        std::make_shared<CXXGenericStatement>(funcBody.get(), ss.str()));
+  } else {
+    funcBody->statements.push_back(
+        std::make_shared<CXXReturnIntStatement>(funcBody.get(), 0));
+  }
+  program->appendDecl(funcDefn);
+}
+
+void CXXProgramBuilderPassImpl::insertCustomMutator() {
+  // Describe where each free variable lives in the buffer so the runtime's
+  // mutators can work on whole variables rather than arbitrary bytes.
+  const BufferAssignment& ba =
+      *(info->freeVariableAssignment->bufferAssignment.get());
+  std::string underlyingString;
+  llvm::raw_string_ostream ss(underlyingString);
+  ss << "static const jfs_buffer_element jfs_buffer_layout[] = {";
+  for (const auto& be : ba) {
+    ss << "\n  {";
+    switch (be.getSort().getKind()) {
+    case Z3_BOOL_SORT:
+      ss << "JFS_BUFFER_ELEMENT_BOOL, ";
+      break;
+    case Z3_BV_SORT:
+      ss << "JFS_BUFFER_ELEMENT_BITVECTOR, ";
+      break;
+    case Z3_FLOATING_POINT_SORT:
+      ss << "JFS_BUFFER_ELEMENT_FLOAT, ";
+      break;
+    default:
+      llvm_unreachable("Unhandled sort");
+    }
+    ss << be.getBitOffset() << ", " << be.getBitWidth() << ", ";
+    if (be.getSort().getKind() == Z3_FLOATING_POINT_SORT) {
+      ss << be.getSort().getFloatingPointExponentBitWidth() << ", "
+         << be.getSort().getFloatingPointSignificandBitWidth();
+    } else {
+      ss << "0, 0";
+    }
+    ss << "},";
+  }
+  if (ba.size() == 0) {
+    // Zero length arrays aren't allowed.
+    ss << "\n  {JFS_BUFFER_ELEMENT_BOOL, 0, 0, 0, 0},";
+  }
+  ss << "\n}";
+  program->appendDecl(
+      std::make_shared<CXXGenericStatement>(program.get(), ss.str()));
+
+  auto sizeTy = std::make_shared<CXXType>(program.get(), "size_t");
+  auto dataTy = std::make_shared<CXXType>(program.get(), "uint8_t*");
+  auto constDataTy = std::make_shared<CXXType>(program.get(), "const uint8_t*");
+  auto seedTy = std::make_shared<CXXType>(program.get(), "unsigned int");
+
+  // LibFuzzer calls `LLVMFuzzerCustomMutator()` instead of its own mutators.
+  auto mutatorArguments = std::vector<CXXFunctionArgumentRef>();
+  mutatorArguments.push_back(
+      std::make_shared<CXXFunctionArgument>(program.get(), "data", dataTy));
+  mutatorArguments.push_back(
+      std::make_shared<CXXFunctionArgument>(program.get(), "size", sizeTy));
+  mutatorArguments.push_back(
+      std::make_shared<CXXFunctionArgument>(program.get(), "maxSize", sizeTy));
+  mutatorArguments.push_back(
+      std::make_shared<CXXFunctionArgument>(program.get(), "seed", seedTy));
+  auto mutatorDefn = std::make_shared<CXXFunctionDecl>(
+      program.get(), "LLVMFuzzerCustomMutator", sizeTy, mutatorArguments,
+      /*hasCVisibility=*/true);
+  mutatorDefn->defn = std::make_shared<CXXCodeBlock>(mutatorDefn.get());
+  underlyingString.clear();
+  ss << "return jfs_custom_mutate(jfs_buffer_layout, " << ba.size()
+     << ", data, size, maxSize, seed)";
+  mutatorDefn->defn->statements.push_back(std::make_shared<CXXGenericStatement>(
+      mutatorDefn->defn.get(), ss.str()));
+  program->appendDecl(mutatorDefn);
+
+  auto crossOverArguments = std::vector<CXXFunctionArgumentRef>();
+  crossOverArguments.push_back(std::make_shared<CXXFunctionArgument>(
+      program.get(), "data1", constDataTy));
+  crossOverArguments.push_back(
+      std::make_shared<CXXFunctionArgument>(program.get(), "size1", sizeTy));
+  crossOverArguments.push_back(std::make_shared<CXXFunctionArgument>(
+      program.get(), "data2", constDataTy));
+  crossOverArguments.push_back(
+      std::make_shared<CXXFunctionArgument>(program.get(), "size2", sizeTy));
+  crossOverArguments.push_back(
+      std::make_shared<CXXFunctionArgument>(program.get(), "out", dataTy));
+  crossOverArguments.push_back(std::make_shared<CXXFunctionArgument>(
+      program.get(), "maxOutSize", sizeTy));
+  crossOverArguments.push_back(
+      std::make_shared<CXXFunctionArgument>(program.get(), "seed", seedTy));
+  auto crossOverDefn = std::make_shared<CXXFunctionDecl>(
+      program.get(), "LLVMFuzzerCustomCrossOver", sizeTy, crossOverArguments,
+      /*hasCVisibility=*/true);
+  crossOverDefn->defn = std::make_shared<CXXCodeBlock>(crossOverDefn.get());
+  underlyingString.clear();
+  ss << "return jfs_custom_cross_over(jfs_buffer_layout, " << ba.size()
+     << ", data1, size1, data2, size2, out, maxOutSize, seed)";
+  crossOverDefn->defn->statements.push_back(
+      std::make_shared<CXXGenericStatement>(crossOverDefn->defn.get(),
+                                            ss.str()));
+  program->appendDecl(crossOverDefn);
+}
+
+void CXXProgramBuilderPassImpl::recordDictionaryConstant(Z3SortHandle sort,
+                                                         uint64_t bits) {
+  if (!options.buildDictionary)
+    return;
+  dictionaryConstants.push_back(std::make_pair(sort, bits));
+}
+
+namespace {
+// Encode the low `bitWidth` bits of `value` as they would appear in the buffer
+// for a variable starting at `bitOffset`, i.e. in the byte order and bit
+// numbering used by `makeBitVectorFrom()`. Bits of the first byte below the
+// offset are zero.
+std::vector<uint8_t> encodeForBuffer(uint64_t value, unsigned bitWidth,
+                                     unsigned bitOffset) {
+  const unsigned shift = bitOffset % 8;
+  std::vector<uint8_t> bytes((shift + bitWidth + 7) / 8, 0);
+  for (unsigned index = 0; index < bitWidth; ++index) {
+    if ((value >> index) & 1) {
+      unsigned bit = shift + index;
+      bytes[bit / 8] |= 1 << (bit % 8);
+    }
+  }
+  return bytes;
+}
+
+// Returns true if the `fromWidth` bit value `value` can be represented in
+// `toWidth` bits when interpreted as either unsigned or signed.
+bool fitsInWidth(uint64_t value, unsigned fromWidth, unsigned toWidth) {
+  if (toWidth >= fromWidth)
+    return true;
+  uint64_t upperBits = (value >> toWidth);
+  if (upperBits == 0)
+    return true;
+  // Signed: the upper bits are all copies of the new sign bit.
+  uint64_t upperMask = (fromWidth >= 64 ? ~UINT64_C(0)
+                                        : ((UINT64_C(1) << fromWidth) - 1)) >>
+                       toWidth;
+  bool signBit = (value >> (toWidth - 1)) & 1;
+  return signBit && upperBits == upperMask;
+}
+
+// LibFuzzer ignores dictionary entries beyond this.
+const size_t maxDictionaryEntries = 1 << 14;
+}
+
+void CXXProgramBuilderPassImpl::buildDictionary() {
+  // Encode each constant at the width and bit offset of each free variable it
+  // could plausibly be compared with so that LibFuzzer can drop it into the
+  // input in one step rather than discovering it byte by byte.
+  const BufferAssignment& ba =
+      *(info->freeVariableAssignment->bufferAssignment.get());
+  if (ba.size() == 0) {
+    // Nothing to fuzz.
+    return;
+  }
+  std::set<std::vector<uint8_t>> seen;
+  auto addEntry = [&](std::vector<uint8_t> entry) {
+    if (dictionary.size() >= maxDictionaryEntries)
+      return;
+    if (seen.insert(entry).second)
+      dictionary.push_back(std::move(entry));
+  };
+  for (const auto& constant : dictionaryConstants) {
+    const Z3SortHandle& sort = constant.first;
+    const uint64_t bits = constant.second;
+    unsigned constantWidth = sort.isBitVectorTy()
+                                 ? sort.getBitVectorWidth()
+                                 : sort.getFloatingPointBitWidth();
+    // Byte aligned encoding for constants that are compared with parts of
+    // variables.
+    addEntry(encodeForBuffer(bits, constantWidth, 0));
+    for (const auto& be : ba) {
+      Z3SortHandle varSort = be.getSort();
+      unsigned varWidth = be.getBitWidth();
+      bool candidate = false;
+      if (be.hasInterval()) {
+        // The buffer stores the offset into the interval.
+        if (sort.isBitVectorTy() && bits >= be.getIntervalLow() &&
+            bits <= be.getIntervalHigh()) {
+          addEntry(encodeForBuffer(bits - be.getIntervalLow(), varWidth,
+                                   be.getBitOffset()));
+        }
+        continue;
+      }
+      if (sort.isBitVectorTy() && varSort.isBitVectorTy()) {
+        candidate = fitsInWidth(bits, constantWidth, varWidth);
+      } else if (varSort.isFloatingPointTy()) {
+        // Floating point constants with the same sort and bitvectors that
+        // might be reinterpreted as floating point.
+        candidate = sort == varSort ||
+                    (sort.isBitVectorTy() && constantWidth == varWidth);
+      }
+      if (candidate) {
+        addEntry(encodeForBuffer(bits, std::min(constantWidth, varWidth),
+                                 be.getBitOffset()));
+      }
+    }
+  }
+  IF_VERB(ctx, ctx.getDebugStream()
+                   << "(CXXProgramBuilderPass built dictionary with "
+                   << dictionary.size() << " entries from "
+                   << dictionaryConstants.size() << " constants)\n");
+}
+
+void CXXProgramBuilderPassImpl::insertRuntimeIncludes(CXXProgramRef tu) {
+  // Prepend in reverse order so the includes appear in the order below.
+  std::vector<const char*> headers;
+  if (needsCoreHeader)
+    headers.push_back("SMTLIB/Core.h");
+  if (needsBitVectorHeader)
+    headers.push_back("SMTLIB/BitVector.h");
+  if (needsFloatHeader)
+    headers.push_back("SMTLIB/Float.h");
+  if (options.liftConstants)
+    headers.push_back("SMTLIB/ConstantTable.h");
+  // Only the main translation unit defines the mutators.
+  if (options.customMutator && tu == program)
+    headers.push_back("SMTLIB/Mutator.h");
+  if (numDistanceComparisons > 0)
+    headers.push_back("SMTLIB/Distance.h");
+  if (options.traceFloatComparisons && needsFloatHeader)
+    headers.push_back("SMTLIB/TraceCmp.h");
+  if (recordRejections && tu == program)
+    headers.push_back("SMTLIB/RejectionProfile.h");
+  for (auto it = headers.rbegin(), ie = headers.rend(); it != ie; ++it) {
+    tu->prependDecl(std::make_shared<CXXIncludeDecl>(tu.get(), *it,
+                                                     /*systemHeader=*/false));
+  }
 }
 
 void CXXProgramBuilderPassImpl::build(const Query& q) {
@@ -389,14 +1038,74 @@ void CXXProgramBuilderPassImpl::build(const Query& q) {
   entryPointMainBlock = fuzzFn->defn;
 
   insertBufferSizeGuard(fuzzFn->defn);
-  insertFreeVariableConstruction(fuzzFn->defn);
-  insertConstantAssignments(fuzzFn->defn);
+  std::vector<Z3ASTHandle> constraints;
+  if (options.orderConstraintsByCost) {
+    constraints = orderConstraintsByCost(q.constraints);
+    size_t numMoved = 0;
+    for (size_t index = 0; index < constraints.size(); ++index) {
+      if (!constraints[index].isStructurallyEqualTo(q.constraints[index]))
+        ++numMoved;
+    }
+    IF_VERB(ctx, ctx.getDebugStream()
+                     << "(CXXProgramBuilderPass reordered " << numMoved
+                     << " of " << constraints.size()
+                     << " constraints by cost)\n");
+  } else {
+    constraints = q.constraints;
+  }
+  constraintOrder = constraints;
+  recordRejections =
+      options.recordRejections && !options.countSatisfiedConstraints;
+  if (recordRejections) {
+    // Count the inputs that get past the buffer size guard.
+    std::string underlyingString;
+    llvm::raw_string_ostream ss(underlyingString);
+    ss << "++jfs_rejection_counts[" << constraints.size() << "]";
+    fuzzFn->defn->statements.push_back(std::make_shared<CXXGenericStatement>(
+        fuzzFn->defn.get(), ss.str()));
+  }
+  if (options.countSatisfiedConstraints) {
+    satisfiedConstraintCountersOffset =
+        allocateExtraCounters((2 * constraints.size()) + 1);
+    insertSatisfiedConstraintsCounter(fuzzFn->defn);
+  }
+  unsigned numPartitions = std::min<size_t>(options.numConstraintPartitions,
+                                            constraints.size());
+  if (numPartitions > 1) {
+    insertConstraintPartitions(constraints, numPartitions, fuzzFn->defn);
+  } else {
+    insertFreeVariableConstruction(fuzzFn->defn);
+    insertConstantAssignments(fuzzFn->defn);
 
-  // Generate constraint branches
-  for (const auto& constraint : q.constraints) {
-    insertBranchForConstraint(constraint);
+    // Generate constraint branches
+    for (size_t index = 0; index < constraints.size(); ++index) {
+      insertBranchForConstraint(constraints[index], index);
+    }
+  }
+  if (options.countSatisfiedConstraints) {
+    insertSatisfiedConstraintsCheck(fuzzFn->defn, constraints.size());
+  }
+  if (numExtraCounters > 0) {
+    insertExtraCounters();
   }
+  if (recordRejections) {
+    insertRejectionCounts();
+  }
+  program->appendDecl(fuzzFn);
   insertFuzzingTarget(fuzzFn->defn);
+  if (options.liftConstants || recordRejections) {
+    insertFuzzerInitializer();
+  }
+  if (options.customMutator) {
+    insertCustomMutator();
+  }
+  if (options.buildDictionary) {
+    buildDictionary();
+  }
+  insertRuntimeIncludes(program);
+  for (const auto& tu : program->getTranslationUnits()) {
+    insertRuntimeIncludes(tu);
+  }
 
   // Add stats
   if (ctx.getStats() != nullptr) {
@@ -409,6 +1118,9 @@ void CXXProgramBuilderPassImpl::build(const Query& q) {
     // FIXME: Should compute once and cache
     progStats->bufferWidth = bufferWidthInBits;
     progStats->numEqualitySets = info->equalityExtraction->equalities.size();
+    progStats->numDictionaryEntries = dictionary.size();
+    progStats->numDistanceComparisons = numDistanceComparisons;
+    progStats->numExtraCounters = numExtraCounters;
     ctx.getStats()->append(std::move(progStats));
   }
 }
@@ -425,7 +1137,7 @@ const char* CXXProgramBuilderPassImpl::getboolConstantStr(Z3AppHandle e) const {
 }
 
 std::string
-CXXProgramBuilderPassImpl::getBitVectorConstantStr(Z3AppHandle e) const {
+CXXProgramBuilderPassImpl::getBitVectorConstantStr(Z3AppHandle e) {
   assert(e.isConstant());
   Z3SortHandle sort = e.getSort();
   assert(sort.isBitVectorTy());
@@ -434,19 +1146,23 @@ CXXProgramBuilderPassImpl::getBitVectorConstantStr(Z3AppHandle e) const {
   std::string underlyingString;
   llvm::raw_string_ostream ss(underlyingString);
 
-  ss << "BitVector<" << bitWidth << ">(UINT64_C(";
   // Get constant
   uint64_t value = 0;
   bool success = e.getConstantAsUInt64(&value);
   assert(success && "Failed to get numeral value");
-  ss << value;
-  ss << "))";
+  if (options.liftConstants) {
+    ss << "BitVector<" << bitWidth << ">(jfs_constant_table["
+       << constantTable.size() << "])";
+    constantTable.push_back(value);
+  } else {
+    ss << "BitVector<" << bitWidth << ">(UINT64_C(" << value << "))";
+  }
   ss.flush();
   return underlyingString;
 }
 
 std::string CXXProgramBuilderPassImpl::getFloatingPointConstantStr(
-    jfs::core::Z3AppHandle e) const {
+    jfs::core::Z3AppHandle e) {
   std::string underlyingString;
   llvm::raw_string_ostream ss(underlyingString);
   auto sort = e.getSort();
@@ -624,6 +1340,10 @@ CXXProgramBuilderPassImpl::getSymbolFor(jfs::core::Z3ASTHandle e) const {
 
 // Visitor methods
 void CXXProgramBuilderPassImpl::visitUninterpretedFunc(Z3AppHandle e) {
+  // Free variables that haven't been decoded yet.
+  if (insertPendingDecode(e.asAST()))
+    return;
+
   // We can't really model uninterpreted functions in CXX very well.
   // Unfortunately Z3 doesn't provide a great API for examining these
   // so we examine the string value and try to guess what interpretation
@@ -643,6 +1363,8 @@ void CXXProgramBuilderPassImpl::visitEqual(jfs::core::Z3AppHandle e) {
   assert(e.getNumKids() == 2);
   auto arg0 = e.getKid(0);
   auto arg1 = e.getKid(1);
+  if (arg0.getSort().isFloatingPointTy())
+    insertFloatComparisonTrace(arg0, arg1);
   std::string underlyingString;
   llvm::raw_string_ostream ss(underlyingString);
   ss << getSymbolFor(arg0) << " == " << getSymbolFor(arg1);
@@ -971,6 +1693,9 @@ void CXXProgramBuilderPassImpl::visitBoolConstant(Z3AppHandle e) {
 
 void CXXProgramBuilderPassImpl::visitBitVector(Z3AppHandle e) {
   insertSSAStmt(e.asAST(), getBitVectorConstantStr(e));
+  uint64_t value = 0;
+  if (e.getConstantAsUInt64(&value))
+    recordDictionaryConstant(e.getSort(), value);
 }
 
 // Floating point
@@ -1039,18 +1764,34 @@ FP_UNARY_OP(visitFloatNeg, neg)
     insertSSAStmt(e.asAST(), ss.str());                                        \
   }
 
-FP_BIN_OP(visitFloatIEEEEquals, ieeeEquals)
-FP_BIN_OP(visitFloatLessThan, fplt)
-FP_BIN_OP(visitFloatLessThanOrEqual, fpleq)
-FP_BIN_OP(visitFloatGreaterThan, fpgt)
-FP_BIN_OP(visitFloatGreaterThanOrEqual, fpgeq)
-
 FP_BIN_OP(visitFloatRem, rem)
 FP_BIN_OP(visitFloatMin, min)
 FP_BIN_OP(visitFloatMax, max)
 
 #undef FP_BIN_OP
 
+#define FP_CMP_OP(NAME, CALL_NAME)                                             \
+  void CXXProgramBuilderPassImpl::NAME(Z3AppHandle e) {                        \
+    assert(e.getNumKids() == 2);                                               \
+    auto lhs = e.getKid(0);                                                    \
+    auto rhs = e.getKid(1);                                                    \
+    assert(lhs.getSort().isFloatingPointTy());                                 \
+    assert(rhs.getSort().isFloatingPointTy());                                 \
+    insertFloatComparisonTrace(lhs, rhs);                                      \
+    std::string underlyingString;                                              \
+    llvm::raw_string_ostream ss(underlyingString);                             \
+    ss << getSymbolFor(lhs) << "." #CALL_NAME "(" << getSymbolFor(rhs) << ")"; \
+    insertSSAStmt(e.asAST(), ss.str());                                        \
+  }
+
+FP_CMP_OP(visitFloatIEEEEquals, ieeeEquals)
+FP_CMP_OP(visitFloatLessThan, fplt)
+FP_CMP_OP(visitFloatLessThanOrEqual, fpleq)
+FP_CMP_OP(visitFloatGreaterThan, fpgt)
+FP_CMP_OP(visitFloatGreaterThanOrEqual, fpgeq)
+
+#undef FP_CMP_OP
+
 #define FP_SPECIAL_CONST(NAME, CALL_NAME)                                      \
   void CXXProgramBuilderPassImpl::NAME(jfs::core::Z3AppHandle e) {             \
     assert(e.getNumKids() == 0);                                               \
@@ -1074,6 +1815,33 @@ FP_SPECIAL_CONST(visitFloatNaN, getNaN)
 void CXXProgramBuilderPassImpl::visitFloatingPointConstant(Z3AppHandle e) {
   assert(e.getNumKids() == 0);
   insertSSAStmt(e.asAST(), getFloatingPointConstantStr(e));
+
+  // Record the IEEE-754 bits of the constant.
+  auto sort = e.getSort();
+  if (!options.buildDictionary || sort.getFloatingPointBitWidth() > 64)
+    return;
+  Z3ASTHandle signExpr(::Z3_fpa_get_numeral_sign_bv(e.getContext(), e.asAST()),
+                       e.getContext());
+  Z3ASTHandle exponentExpr(
+      ::Z3_fpa_get_numeral_exponent_bv(e.getContext(), e.asAST(),
+                                       /*biased=*/true),
+      e.getContext());
+  Z3ASTHandle significandExpr(
+      ::Z3_fpa_get_numeral_significand_bv(e.getContext(), e.asAST()),
+      e.getContext());
+  uint64_t sign = 0;
+  uint64_t exponent = 0;
+  uint64_t significand = 0;
+  if (!signExpr.asApp().getConstantAsUInt64(&sign) ||
+      !exponentExpr.asApp().getConstantAsUInt64(&exponent) ||
+      !significandExpr.asApp().getConstantAsUInt64(&significand))
+    return;
+  const unsigned significandBits =
+      sort.getFloatingPointSignificandBitWidth() - 1;
+  const unsigned exponentBits = sort.getFloatingPointExponentBitWidth();
+  recordDictionaryConstant(sort, (sign << (exponentBits + significandBits)) |
+                                     (exponent << significandBits) |
+                                     significand);
 }
 
 llvm::StringRef CXXProgramBuilderPassImpl::roundingModeToString(
@@ -11,11 +11,13 @@
 #ifndef JFS_CXX_FUZZING_BACKEND_CXX_PROGRAM_BUILDER_PASS_IMPL_H
 #define JFS_CXX_FUZZING_BACKEND_CXX_PROGRAM_BUILDER_PASS_IMPL_H
 #include "jfs/CXXFuzzingBackend/CXXProgram.h"
+#include "jfs/CXXFuzzingBackend/CXXProgramBuilderOptions.h"
 #include "jfs/CXXFuzzingBackend/CXXProgramBuilderPass.h"
 #include "jfs/Core/JFSContext.h"
 #include "jfs/Core/Z3ASTVisitor.h"
 #include "jfs/Core/Z3Node.h"
 #include "jfs/Core/Z3NodeMap.h"
+#include <vector>
 namespace jfs {
 namespace cxxfb {
 
@@ -25,6 +27,7 @@ private:
   jfs::core::JFSContext& ctx;
   std::shared_ptr<CXXProgram> program;
   std::shared_ptr<jfs::fuzzingCommon::FuzzingAnalysisInfo> info;
+  CXXProgramBuilderOptions options;
   CXXCodeBlockRef earlyExitBlock;
   CXXCodeBlockRef entryPointMainBlock;
   jfs::core::Z3SortMap<CXXTypeRef> sortToCXXTypeCache;
@@ -34,10 +37,52 @@ private:
   std::unordered_set<std::string> usedSymbols;
   llvm::StringRef entryPointFirstArgName;
   llvm::StringRef entryPointSecondArgName;
+  // Values of the constants lifted out of the program when
+  // `options.liftConstants` is true. Indexed by the generated program.
+  std::vector<uint64_t> constantTable;
+  // Bitvector and floating point constants used by the constraints, as
+  // (sort, bits) pairs. Only populated when `options.buildDictionary` is true.
+  std::vector<std::pair<jfs::core::Z3SortHandle, uint64_t>>
+      dictionaryConstants;
+  // LibFuzzer dictionary entries built from `dictionaryConstants`.
+  std::vector<std::vector<uint8_t>> dictionary;
+  // Number of comparisons that record their distance when
+  // `options.distanceFeedback` is true.
+  unsigned numDistanceComparisons = 0;
+  // Size of `jfs_extra_counters`. All LibFuzzer extra counters used by the
+  // program live in that one array so that they can be registered with
+  // LibFuzzer as a single range when fuzzing in process.
+  unsigned numExtraCounters = 0;
+  // When `options.countSatisfiedConstraints` is true the extra counters
+  // starting at this offset record which constraints were satisfied
+  // (one per constraint) followed by how many were (one per count).
+  unsigned satisfiedConstraintCountersOffset = 0;
+  // Running count of satisfied constraints in the function being built.
+  llvm::StringRef numSatisfiedConstraintsSymbol;
+  // True if the program counts how many inputs each constraint rejects in
+  // `jfs_rejection_counts`.
+  bool recordRejections = false;
+  // The constraints in the order the program checks them. Indexes
+  // `jfs_rejection_counts`.
+  std::vector<jfs::core::Z3ASTHandle> constraintOrder;
+  // A free variable that has a symbol but whose value hasn't been decoded
+  // yet. Only used when `options.lazyDecoding` is true.
+  struct PendingDecode {
+    llvm::StringRef symbol; // References a string in `usedSymbols`.
+    std::string expr;
+    // The variable this one is equal to, which must be decoded first, or
+    // null.
+    jfs::core::Z3ASTHandle aliasOf;
+  };
+  jfs::core::Z3ASTMap<PendingDecode> pendingDecodes;
+  // Runtime headers needed by the program. Populated while building.
+  bool needsCoreHeader = false;
+  bool needsBitVectorHeader = false;
+  bool needsFloatHeader = false;
 
   CXXProgramBuilderPassImpl(
       std::shared_ptr<jfs::fuzzingCommon::FuzzingAnalysisInfo> info,
-      jfs::core::JFSContext& ctx);
+      const CXXProgramBuilderOptions* options, jfs::core::JFSContext& ctx);
 
   void build(const jfs::core::Query& q);
 
@@ -52,16 +97,40 @@ private:
   CXXFunctionDeclRef buildEntryPoint();
   void insertBufferSizeGuard(CXXCodeBlockRef cb);
   void insertFreeVariableConstruction(CXXCodeBlockRef cb);
+  // Decode `e` in the current block if it is a free variable whose decoding
+  // was deferred. Returns true if it was.
+  bool insertPendingDecode(jfs::core::Z3ASTHandle e);
   void insertConstantAssignments(CXXCodeBlockRef cb);
-  void insertBranchForConstraint(jfs::core::Z3ASTHandle constraint);
+  void insertBranchForConstraint(jfs::core::Z3ASTHandle constraint,
+                                 size_t constraintIndex);
+  void insertDistanceFeedback(jfs::core::Z3ASTHandle constraint);
+  unsigned allocateExtraCounters(unsigned numCounters);
+  void insertExtraCounters();
+  void insertSatisfiedConstraintsCounter(CXXCodeBlockRef cb);
+  void insertSatisfiedConstraintsCheck(CXXCodeBlockRef cb,
+                                       size_t numConstraints);
+  void insertFloatComparisonTrace(jfs::core::Z3ASTHandle lhs,
+                                  jfs::core::Z3ASTHandle rhs);
+  CXXCodeBlockRef getRejectionBlock(size_t constraintIndex);
+  void insertRejectionCounts();
+  // Move the constraints into `numPartitions` functions, each in its own
+  // translation unit, that are called from `cb`.
+  void insertConstraintPartitions(
+      const std::vector<jfs::core::Z3ASTHandle>& constraints,
+      unsigned numPartitions, CXXCodeBlockRef cb);
   void insertFuzzingTarget(CXXCodeBlockRef cb);
+  void insertFuzzerInitializer();
+  void insertCustomMutator();
+  void recordDictionaryConstant(jfs::core::Z3SortHandle sort, uint64_t bits);
+  void buildDictionary();
+  void insertRuntimeIncludes(CXXProgramRef tu);
   // Only let CXXProgramBuilderPass use the implementation.
   friend class CXXProgramBuilderPass;
 
   // Visitor and ConstantAssignment helper methods
   const char* getboolConstantStr(jfs::core::Z3AppHandle e) const;
-  std::string getBitVectorConstantStr(jfs::core::Z3AppHandle e) const;
-  std::string getFloatingPointConstantStr(jfs::core::Z3AppHandle e) const;
+  std::string getBitVectorConstantStr(jfs::core::Z3AppHandle e);
+  std::string getFloatingPointConstantStr(jfs::core::Z3AppHandle e);
   std::string getFreshSymbol();
   void insertSSAStmt(jfs::core::Z3ASTHandle e, llvm::StringRef expr,
                      llvm::StringRef preferredSymbolName);
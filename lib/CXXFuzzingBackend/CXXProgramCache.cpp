@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/CXXFuzzingBackend/CXXProgramCache.h"
+#include "jfs/Core/IfVerbose.h"
+#include "jfs/Support/version.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+#include <unistd.h>
+
+namespace {
+// Fuzzing programs are executed straight from the cache (they are hard
+// linked) so other users must never be able to write to an entry.
+const llvm::sys::fs::perms cacheEntryPerms =
+    llvm::sys::fs::owner_read | llvm::sys::fs::owner_write |
+    llvm::sys::fs::owner_exe | llvm::sys::fs::group_read |
+    llvm::sys::fs::group_exe | llvm::sys::fs::others_read |
+    llvm::sys::fs::others_exe;
+}
+
+namespace jfs {
+namespace cxxfb {
+
+CXXProgramCache::CXXProgramCache(llvm::StringRef cacheDir,
+                                 jfs::core::JFSContext& ctx)
+    : cacheDir(cacheDir), ctx(ctx) {
+  if (auto ec = llvm::sys::fs::create_directories(this->cacheDir)) {
+    ctx.getErrorStream() << "(error failed to create program cache directory \""
+                         << this->cacheDir << "\" because " << ec.message()
+                         << ")\n";
+  }
+}
+
+std::string CXXProgramCache::getPathForKey(llvm::StringRef key) const {
+  llvm::SmallString<256> path(cacheDir);
+  llvm::sys::path::append(path, key);
+  return std::string(path.data(), path.size());
+}
+
+std::string
+CXXProgramCache::computeKey(const CXXProgram* program,
+                            const ClangOptions* clangOptions,
+                            const CXXProgramBuilderOptions* pbOptions) const {
+  std::string buffer;
+  llvm::raw_string_ostream ss(buffer);
+  ss << "jfs_version: " << jfs::support::getVersionString() << "\n";
+  clangOptions->print(ss);
+  // The dictionary is passed to LibFuzzer separately and doesn't change the
+  // program so it mustn't change the key.
+  CXXProgramBuilderOptions keyOptions(*pbOptions);
+  keyOptions.buildDictionary = false;
+  keyOptions.print(ss);
+  program->print(ss);
+  ss.flush();
+  llvm::SHA1 hasher;
+  hasher.update(buffer);
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+uint64_t CXXProgramCache::lookup(llvm::StringRef key,
+                                 llvm::StringRef outputFile) {
+  std::string cachedFile = getPathForKey(key);
+  uint64_t size = 0;
+  if (llvm::sys::fs::file_size(cachedFile, size) || size == 0) {
+    IF_VERB(ctx, ctx.getDebugStream()
+                     << "(CXXProgramCache miss " << key << ")\n");
+    return 0;
+  }
+  // Prefer a hard link so that nothing is copied. Fall back to copying if the
+  // working directory is on a different file system.
+  if (llvm::sys::fs::create_hard_link(cachedFile, outputFile)) {
+    if (auto ec = llvm::sys::fs::copy_file(cachedFile, outputFile)) {
+      IF_VERB(ctx, ctx.getWarningStream()
+                       << "(warning failed to copy cached program \""
+                       << cachedFile << "\" because " << ec.message() << ")\n");
+      return 0;
+    }
+    llvm::sys::fs::setPermissions(outputFile, cacheEntryPerms);
+  }
+  IF_VERB(ctx, ctx.getDebugStream() << "(CXXProgramCache hit " << key << ")\n");
+  return size;
+}
+
+bool CXXProgramCache::insert(llvm::StringRef key, llvm::StringRef outputFile) {
+  // Copy to a unique temporary file and then rename it so that concurrent
+  // JFS instances never observe a partially written entry.
+  int fd = -1;
+  llvm::SmallString<256> tmpPath;
+  if (auto ec = llvm::sys::fs::createUniqueFile(
+          getPathForKey(key) + "-%%%%%%.tmp", fd, tmpPath)) {
+    IF_VERB(ctx, ctx.getWarningStream()
+                     << "(warning failed to create program cache entry because "
+                     << ec.message() << ")\n");
+    return false;
+  }
+  ::close(fd);
+  std::error_code ec = llvm::sys::fs::copy_file(outputFile, tmpPath);
+  if (!ec)
+    ec = llvm::sys::fs::setPermissions(tmpPath, cacheEntryPerms);
+  if (!ec)
+    ec = llvm::sys::fs::rename(tmpPath, getPathForKey(key));
+  if (ec) {
+    IF_VERB(ctx, ctx.getWarningStream()
+                     << "(warning failed to add \"" << outputFile
+                     << "\" to program cache because " << ec.message()
+                     << ")\n");
+    llvm::sys::fs::remove(tmpPath);
+    return false;
+  }
+  return true;
+}
+}
+}
@@ -15,12 +15,19 @@
 #include "jfs/Core/IfVerbose.h"
 #include "jfs/FuzzingCommon/SMTLIBRuntimes.h"
 #include "jfs/Support/CancellableProcess.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <atomic>
+#include <list>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 namespace jfs {
 namespace cxxfb {
@@ -32,7 +39,19 @@ class ClangInvocationManagerImpl : public jfs::support::ICancellable {
 private:
   JFSContext& ctx;
   std::atomic<bool> cancelled;
-  CancellableProcess proc;
+  // Clang invocations in progress. There is more than one when translation
+  // units are compiled concurrently.
+  std::mutex activeMutex;
+  std::unordered_set<ICancellable*> active;
+  std::mutex debugStreamMutex;
+  // Storage for arguments built by `appendProfileArgs()`. A list so that
+  // existing elements don't move.
+  mutable std::mutex profileArgsMutex;
+  mutable std::list<std::string> profileArgs;
+  // Whether Clang accepts the precompiled runtime header for a set of compile
+  // arguments. See `checkPrecompiledHeader()`.
+  std::mutex pchCheckMutex;
+  std::unordered_map<std::string, bool> pchAccepted;
 
 public:
   ClangInvocationManagerImpl(JFSContext& ctx) : ctx(ctx), cancelled(false) {}
@@ -42,7 +61,46 @@ public:
     // Cancel Clang invocation
     IF_VERB(ctx,
             ctx.getDebugStream() << "(ClangInvocationManager cancel called)\n");
-    proc.cancel();
+    std::lock_guard<std::mutex> lock(activeMutex);
+    for (const auto& invocation : active) {
+      invocation->cancel();
+    }
+  }
+
+  // `cmdLineArgs` should not be null terminated. This can be called
+  // concurrently.
+  int execute(const ClangOptions* options, std::vector<const char*> cmdLineArgs,
+              std::vector<llvm::StringRef>& redirects,
+              CancellableProcess::StdinWriterTy stdinWriter) {
+    if (ctx.getVerbosity() > 0) {
+      std::lock_guard<std::mutex> lock(debugStreamMutex);
+      ctx.getDebugStream() << "(ClangInvocationManager \n [";
+      for (const auto& arg : cmdLineArgs) {
+        ctx.getDebugStream() << "\"" << arg << "\", ";
+      }
+      ctx.getDebugStream() << "]\n)\n";
+    }
+    CancellableProcess proc;
+    {
+      std::lock_guard<std::mutex> lock(activeMutex);
+      // `cancel()` sets `cancelled` before taking the lock so either we see
+      // it here or `cancel()` sees this invocation.
+      if (cancelled)
+        return -2;
+      active.insert(&proc);
+    }
+    // Null terminates args
+    cmdLineArgs.push_back(nullptr);
+    int exitCode = proc.execute(
+        /*program=*/options->pathToBinary,
+        /*args=*/cmdLineArgs,
+        /*redirects=*/redirects,
+        /*stdinWriter=*/stdinWriter);
+    {
+      std::lock_guard<std::mutex> lock(activeMutex);
+      active.erase(&proc);
+    }
+    return exitCode;
   }
 
   // FIXME: Not sure if this belongs here or in ClangOptions
@@ -95,12 +153,33 @@ public:
     return path;
   }
 
-  bool compile(const CXXProgram* program, llvm::StringRef sourceFile,
-               llvm::StringRef outputFile, const ClangOptions* options,
-               llvm::StringRef stdoutFile, llvm::StringRef stdErrFile) {
-    // FIXME: Implement pipe building mode.
-    assert(sourceFile.size() > 0 &&
-           "Support for non sourceFile build not implemented");
+  // Returns the path to the runtime's precompiled header that matches
+  // `options` or the empty string if there isn't one. See
+  // `runtime/SMTLIB/SMTLIB/CMakeLists.txt` for how these are built.
+  std::string computePrecompiledHeaderPath(const ClangOptions* options) const {
+    if (!options->usePrecompiledHeader)
+      return "";
+    llvm::SmallVector<char, 256> mutablePath;
+    std::string runtimePath = computeSMTLIBRuntimePath(options);
+    mutablePath.append(runtimePath.begin(), runtimePath.end());
+    llvm::sys::path::remove_filename(mutablePath);
+    // Clang only checks whether optimization is enabled, not the level.
+    bool optimized =
+        options->optimizationLevel != ClangOptions::OptimizationLevel::O0;
+    std::string pchName = optimized ? "Runtime_O1" : "Runtime_O0";
+    if (options->buildSharedObject)
+      pchName += "_PIC";
+    pchName += ".h.pch";
+    llvm::sys::path::append(mutablePath, "pch", pchName);
+    std::string path(mutablePath.data(), mutablePath.size());
+    if (!llvm::sys::fs::exists(path)) {
+      IF_VERB(ctx, ctx.getWarningStream()
+                       << "(warning precompiled runtime header \"" << path
+                       << "\" does not exist)\n");
+      return "";
+    }
+    return path;
+  }
 
 #define CHECK_CANCELLED()                                                      \
   if (cancelled) {                                                             \
@@ -108,9 +187,21 @@ public:
             ctx.getDebugStream() << "(ClangInvocationManager cancelled)\n");   \
     return false;                                                              \
   }
-    // Cancelation point
-    CHECK_CANCELLED();
 
+  // If `sourceFile` is non-empty write `tu` to it. Otherwise set
+  // `stdinWriter` to pipe `tu` to Clang.
+  void prepareSource(const CXXProgram* tu, bool wholeProgram,
+                     llvm::StringRef sourceFile,
+                     CancellableProcess::StdinWriterTy& stdinWriter) {
+    if (sourceFile.size() == 0) {
+      stdinWriter = [tu, wholeProgram](llvm::raw_ostream& os) {
+        if (wholeProgram)
+          tu->print(os);
+        else
+          tu->printTranslationUnit(os);
+      };
+      return;
+    }
     // Write source file to disk
     std::error_code ec;
     llvm::raw_fd_ostream sourceStream(sourceFile, ec,
@@ -126,19 +217,55 @@ public:
       ctx.raiseFatalError(underlyingString);
     }
     // FIXME: We need to be able to cancel writing to the file.
-    program->print(sourceStream);
+    if (wholeProgram)
+      tu->print(sourceStream);
+    else
+      tu->printTranslationUnit(sourceStream);
     assert(!(sourceStream.has_error()));
     sourceStream.close();
+  }
 
-    CHECK_CANCELLED();
+  // Flags that are needed when compiling and linking.
+  void appendSanitizerArgs(const ClangOptions* options,
+                           std::vector<const char*>& cmdLineArgs) const {
+    // ASan
+    if (options->useASan) {
+      cmdLineArgs.push_back("-fsanitize=address");
+    }
 
-    // Invoke Clang
+    // UBSan
+    if (options->useUBSan) {
+      cmdLineArgs.push_back("-fsanitize=undefined");
+    }
+  }
 
-    // Build up command line arguments
-    std::vector<const char*> cmdLineArgs;
-    // arg0 should be the program name itself
-    cmdLineArgs.push_back(options->pathToBinary.c_str());
+  // Flags for Clang PGO that are needed when compiling and linking. Each
+  // argument is owned by `profileArgs`.
+  void appendProfileArgs(const ClangOptions* options,
+                         std::vector<const char*>& cmdLineArgs) const {
+    if (options->profileInstrGenerateFile.size() > 0) {
+      cmdLineArgs.push_back(
+          getProfileArg("-fprofile-instr-generate=",
+                        options->profileInstrGenerateFile));
+    }
+    if (options->profileInstrUseFile.size() > 0) {
+      cmdLineArgs.push_back(getProfileArg("-fprofile-instr-use=",
+                                          options->profileInstrUseFile));
+      // The profile was collected from a program whose constraints were
+      // checked in a different order so parts of it won't match.
+      cmdLineArgs.push_back("-Wno-profile-instr-out-of-date");
+      cmdLineArgs.push_back("-Wno-profile-instr-unprofiled");
+    }
+  }
 
+  const char* getProfileArg(llvm::StringRef flag, llvm::StringRef path) const {
+    std::lock_guard<std::mutex> lock(profileArgsMutex);
+    profileArgs.push_back((flag + path).str());
+    return profileArgs.back().c_str();
+  }
+
+  void appendCompileArgs(const ClangOptions* options,
+                         std::vector<const char*>& cmdLineArgs) const {
     // Set C++ standard
     cmdLineArgs.push_back("-std=c++11");
 
@@ -172,15 +299,8 @@ public:
     // TODO: Do we actually need this?
     cmdLineArgs.push_back("-fno-omit-frame-pointer");
 
-    // ASan
-    if (options->useASan) {
-      cmdLineArgs.push_back("-fsanitize=address");
-    }
+    appendSanitizerArgs(options, cmdLineArgs);
 
-    // UBSan
-    if (options->useUBSan) {
-      cmdLineArgs.push_back("-fsanitize=undefined");
-    }
     // SanitizerCoverage options
     assert(options->sanitizerCoverageOptions.size() > 0);
     for (const auto& sanitizerCovOpt : options->sanitizerCoverageOptions) {
@@ -196,49 +316,113 @@ public:
       }
     }
 
+    appendProfileArgs(options, cmdLineArgs);
+
     // JFS runtime asserts
     if (options->useJFSRuntimeAsserts) {
       cmdLineArgs.push_back("-DENABLE_JFS_RUNTIME_ASSERTS");
     }
 
-    // Source file to compile
-    cmdLineArgs.push_back(sourceFile.data());
-
-    // Link against SMTLIB runtime
-    std::string smtlibRuntimePath = computeSMTLIBRuntimePath(options);
-    cmdLineArgs.push_back(smtlibRuntimePath.c_str());
+    if (options->buildSharedObject) {
+      cmdLineArgs.push_back("-fPIC");
+    }
+  }
 
-    // Link against LibFuzzer
-    cmdLineArgs.push_back(options->pathToLibFuzzerLib.c_str());
+  void appendPrecompiledHeaderArgs(const std::string& pchPath,
+                                   std::vector<const char*>& cmdLineArgs) {
+    if (pchPath.size() > 0) {
+      cmdLineArgs.push_back("-include-pch");
+      cmdLineArgs.push_back(pchPath.c_str());
+    }
+  }
 
-    // Set output path
-    cmdLineArgs.push_back("-o");
-    cmdLineArgs.push_back(outputFile.data());
+  // Returns `pchPath` if Clang accepts it when compiling with `options` and
+  // the empty string otherwise. Clang refuses to use a PCH that doesn't
+  // match the current compilation so rather than find out when a real
+  // compilation fails (and having to tell that apart from an error in the
+  // program) check once with an empty source file and remember the answer.
+  std::string checkPrecompiledHeader(const ClangOptions* options,
+                                     const std::string& pchPath) {
+    if (pchPath.size() == 0)
+      return "";
+    std::vector<const char*> cmdLineArgs;
+    cmdLineArgs.push_back(options->pathToBinary.c_str());
+    appendCompileArgs(options, cmdLineArgs);
+    appendPrecompiledHeaderArgs(pchPath, cmdLineArgs);
+    std::string key;
+    for (const auto& arg : cmdLineArgs) {
+      key += arg;
+      key += '\0';
+    }
+    // Only one thread runs the check at a time. The others use its answer.
+    std::lock_guard<std::mutex> lock(pchCheckMutex);
+    auto it = pchAccepted.find(key);
+    if (it != pchAccepted.end())
+      return it->second ? pchPath : "";
+    cmdLineArgs.push_back("-fsyntax-only");
+    cmdLineArgs.push_back("-x");
+    cmdLineArgs.push_back("c++");
+    cmdLineArgs.push_back("/dev/null");
+    // Discard Clang's output.
+    std::vector<llvm::StringRef> redirects = {"", "", ""};
+    int exitCode = execute(options, cmdLineArgs, redirects, nullptr);
+    if (exitCode == -2) {
+      // Cancelled. Don't remember anything.
+      return "";
+    }
+    bool accepted = exitCode == 0;
+    pchAccepted[key] = accepted;
+    if (!accepted) {
+      IF_VERB(ctx, ctx.getWarningStream()
+                       << "(warning Clang rejected precompiled runtime "
+                          "header \""
+                       << pchPath << "\". Not using it)\n");
+    }
+    return accepted ? pchPath : "";
+  }
 
-    if (ctx.getVerbosity() > 0) {
-      ctx.getDebugStream() << "(ClangInvocationManager \n [";
-      for (const auto& arg : cmdLineArgs) {
-        ctx.getDebugStream() << "\"" << arg << "\", ";
-      }
-      ctx.getDebugStream() << "]\n)\n";
+  void appendSourceArgs(llvm::StringRef sourceFile,
+                        std::vector<const char*>& cmdLineArgs) {
+    if (sourceFile.size() > 0) {
+      cmdLineArgs.push_back(sourceFile.data());
+      return;
     }
+    // Read the source from stdin. Reset the language afterwards so any
+    // libraries that follow are still treated as linker inputs.
+    cmdLineArgs.push_back("-x");
+    cmdLineArgs.push_back("c++");
+    cmdLineArgs.push_back("-");
+    cmdLineArgs.push_back("-x");
+    cmdLineArgs.push_back("none");
+  }
 
-    // Null terminates args
-    cmdLineArgs.push_back(nullptr);
+  void appendLinkArgs(const ClangOptions* options,
+                      const std::string& smtlibRuntimePath,
+                      std::vector<const char*>& cmdLineArgs) const {
+    // Link against SMTLIB runtime
+    cmdLineArgs.push_back(smtlibRuntimePath.c_str());
 
-    CHECK_CANCELLED();
-    std::vector<llvm::StringRef> redirects;
+    if (options->buildSharedObject) {
+      // LibFuzzer's symbols are provided by the process that loads the shared
+      // object so don't link against it.
+      cmdLineArgs.push_back("-shared");
+    } else {
+      // Link against LibFuzzer
+      cmdLineArgs.push_back(options->pathToLibFuzzerLib.c_str());
+    }
+  }
+
+  void makeRedirects(llvm::StringRef stdoutFile, llvm::StringRef stdErrFile,
+                     std::vector<llvm::StringRef>& redirects) const {
     if (stdoutFile.size() > 0 || stdErrFile.size() > 0) {
       // Redirect stdin
-      redirects.push_back("");         // STDIN goes to /dev/null
+      redirects.push_back("");         // STDIN goes to /dev/null or the pipe
       redirects.push_back(stdoutFile); // STDOUT
       redirects.push_back(stdErrFile); // STDERR
     }
-    int exitCode = proc.execute(
-        /*program=*/options->pathToBinary,
-        /*args=*/cmdLineArgs,
-        /*redirects=*/redirects);
+  }
 
+  bool checkExitCode(int exitCode) {
     if (exitCode == 0) {
       // Success
       return true;
@@ -254,6 +438,211 @@ public:
     ctx.raiseError(underlyingString);
     return false;
   }
+
+  bool compile(const CXXProgram* program, llvm::StringRef sourceFile,
+               llvm::StringRef outputFile, const ClangOptions* options,
+               llvm::StringRef stdoutFile, llvm::StringRef stdErrFile) {
+    // Cancelation point
+    CHECK_CANCELLED();
+
+    if (program->getTranslationUnits().size() > 0) {
+      return compileTranslationUnits(program, sourceFile, outputFile, options,
+                                     stdoutFile, stdErrFile);
+    }
+
+    // Without a source file the program is piped to Clang's stdin.
+    CancellableProcess::StdinWriterTy stdinWriter = nullptr;
+    prepareSource(program, /*wholeProgram=*/true, sourceFile, stdinWriter);
+
+    CHECK_CANCELLED();
+
+    // Invoke Clang
+
+    // Build up command line arguments
+    std::vector<const char*> cmdLineArgs;
+    // arg0 should be the program name itself
+    cmdLineArgs.push_back(options->pathToBinary.c_str());
+    appendCompileArgs(options, cmdLineArgs);
+
+    // Precompiled runtime header
+    std::string pchPath =
+        checkPrecompiledHeader(options, computePrecompiledHeaderPath(options));
+    CHECK_CANCELLED();
+    appendPrecompiledHeaderArgs(pchPath, cmdLineArgs);
+
+    // Source file to compile
+    appendSourceArgs(sourceFile, cmdLineArgs);
+
+    std::string smtlibRuntimePath = computeSMTLIBRuntimePath(options);
+    appendLinkArgs(options, smtlibRuntimePath, cmdLineArgs);
+
+    // Set output path
+    cmdLineArgs.push_back("-o");
+    cmdLineArgs.push_back(outputFile.data());
+
+    CHECK_CANCELLED();
+    std::vector<llvm::StringRef> redirects;
+    makeRedirects(stdoutFile, stdErrFile, redirects);
+    int exitCode = execute(options, cmdLineArgs, redirects, stdinWriter);
+    return checkExitCode(exitCode);
+  }
+
+  bool mergeProfile(llvm::StringRef rawProfileFile,
+                    llvm::StringRef profileFile, const ClangOptions* options,
+                    llvm::StringRef stdoutFile, llvm::StringRef stdErrFile) {
+    CHECK_CANCELLED();
+    // Use the `llvm-profdata` that matches the Clang that wrote the profile.
+    llvm::SmallString<256> profDataPath(options->pathToBinary);
+    llvm::sys::path::remove_filename(profDataPath);
+    llvm::sys::path::append(profDataPath, "llvm-profdata");
+    std::string profDataTool(profDataPath.data(), profDataPath.size());
+    if (!llvm::sys::fs::can_execute(profDataTool)) {
+      IF_VERB(ctx, ctx.getWarningStream()
+                       << "(warning \"" << profDataTool
+                       << "\" is not executable. Not merging profile)\n");
+      return false;
+    }
+    std::vector<const char*> cmdLineArgs;
+    cmdLineArgs.push_back(profDataTool.c_str());
+    cmdLineArgs.push_back("merge");
+    cmdLineArgs.push_back("-o");
+    cmdLineArgs.push_back(profileFile.data());
+    cmdLineArgs.push_back(rawProfileFile.data());
+    if (ctx.getVerbosity() > 0) {
+      std::lock_guard<std::mutex> lock(debugStreamMutex);
+      ctx.getDebugStream() << "(ClangInvocationManager \n [";
+      for (const auto& arg : cmdLineArgs) {
+        ctx.getDebugStream() << "\"" << arg << "\", ";
+      }
+      ctx.getDebugStream() << "]\n)\n";
+    }
+    cmdLineArgs.push_back(nullptr);
+    std::vector<llvm::StringRef> redirects;
+    makeRedirects(stdoutFile, stdErrFile, redirects);
+    CancellableProcess proc;
+    {
+      std::lock_guard<std::mutex> lock(activeMutex);
+      if (cancelled)
+        return false;
+      active.insert(&proc);
+    }
+    int exitCode = proc.execute(profDataTool, cmdLineArgs, redirects);
+    {
+      std::lock_guard<std::mutex> lock(activeMutex);
+      active.erase(&proc);
+    }
+    if (exitCode == -2)
+      return false;
+    if (exitCode != 0) {
+      IF_VERB(ctx, ctx.getWarningStream()
+                       << "(warning llvm-profdata has exit code " << exitCode
+                       << ". Not using profile)\n");
+      return false;
+    }
+    return true;
+  }
+
+  // Compile each translation unit of `program` to an object file
+  // concurrently and then link them.
+  bool compileTranslationUnits(const CXXProgram* program,
+                               llvm::StringRef sourceFile,
+                               llvm::StringRef outputFile,
+                               const ClangOptions* options,
+                               llvm::StringRef stdoutFile,
+                               llvm::StringRef stdErrFile) {
+    std::vector<const CXXProgram*> tus;
+    tus.push_back(program);
+    for (const auto& tu : program->getTranslationUnits()) {
+      tus.push_back(tu.get());
+    }
+    std::string pchPath =
+        checkPrecompiledHeader(options, computePrecompiledHeaderPath(options));
+    CHECK_CANCELLED();
+    std::vector<std::string> objectFiles;
+    std::vector<std::string> tuSourceFiles;
+    std::vector<CancellableProcess::StdinWriterTy> stdinWriters;
+    std::vector<std::string> tuStdoutFiles;
+    std::vector<std::string> tuStdErrFiles;
+    for (size_t index = 0; index < tus.size(); ++index) {
+      std::string suffix = "." + std::to_string(index);
+      objectFiles.push_back(outputFile.str() + suffix + ".o");
+      // e.g. `program.cpp` => `program.0.cpp`
+      std::string tuSourceFile;
+      if (sourceFile.size() > 0) {
+        llvm::SmallString<256> path(sourceFile);
+        llvm::sys::path::replace_extension(path,
+                                           std::to_string(index) + ".cpp");
+        tuSourceFile = std::string(path.data(), path.size());
+      }
+      CancellableProcess::StdinWriterTy stdinWriter = nullptr;
+      prepareSource(tus[index], /*wholeProgram=*/false, tuSourceFile,
+                    stdinWriter);
+      tuSourceFiles.push_back(tuSourceFile);
+      stdinWriters.push_back(stdinWriter);
+      // Each invocation gets its own output files so they don't clobber each
+      // other.
+      tuStdoutFiles.push_back(
+          stdoutFile.size() > 0 ? (stdoutFile.str() + suffix) : "");
+      tuStdErrFiles.push_back(
+          stdErrFile.size() > 0 ? (stdErrFile.str() + suffix) : "");
+    }
+
+    // Don't run more Clang invocations at once than there are hardware
+    // threads. Each worker takes the next translation unit that hasn't been
+    // compiled yet.
+    std::vector<int> exitCodes(tus.size(), -1);
+    std::atomic<size_t> nextIndex(0);
+    auto worker = [&]() {
+      for (size_t index = nextIndex++; index < tus.size();
+           index = nextIndex++) {
+        std::vector<const char*> cmdLineArgs;
+        cmdLineArgs.push_back(options->pathToBinary.c_str());
+        appendCompileArgs(options, cmdLineArgs);
+        appendPrecompiledHeaderArgs(pchPath, cmdLineArgs);
+        appendSourceArgs(tuSourceFiles[index], cmdLineArgs);
+        cmdLineArgs.push_back("-c");
+        cmdLineArgs.push_back("-o");
+        cmdLineArgs.push_back(objectFiles[index].c_str());
+        std::vector<llvm::StringRef> redirects;
+        makeRedirects(tuStdoutFiles[index], tuStdErrFiles[index], redirects);
+        exitCodes[index] =
+            execute(options, cmdLineArgs, redirects, stdinWriters[index]);
+      }
+    };
+    size_t numWorkers = std::max(1u, std::thread::hardware_concurrency());
+    numWorkers = std::min(numWorkers, tus.size());
+    std::vector<std::thread> threads;
+    for (size_t index = 1; index < numWorkers; ++index) {
+      threads.emplace_back(worker);
+    }
+    // This thread is a worker too.
+    worker();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    CHECK_CANCELLED();
+    for (int exitCode : exitCodes) {
+      if (exitCode != 0)
+        return checkExitCode(exitCode);
+    }
+
+    // Link
+    std::vector<const char*> cmdLineArgs;
+    cmdLineArgs.push_back(options->pathToBinary.c_str());
+    appendSanitizerArgs(options, cmdLineArgs);
+    appendProfileArgs(options, cmdLineArgs);
+    for (const auto& objectFile : objectFiles) {
+      cmdLineArgs.push_back(objectFile.c_str());
+    }
+    std::string smtlibRuntimePath = computeSMTLIBRuntimePath(options);
+    appendLinkArgs(options, smtlibRuntimePath, cmdLineArgs);
+    cmdLineArgs.push_back("-o");
+    cmdLineArgs.push_back(outputFile.data());
+    std::vector<llvm::StringRef> redirects;
+    makeRedirects(stdoutFile, stdErrFile, redirects);
+    int exitCode = execute(options, cmdLineArgs, redirects, nullptr);
+    return checkExitCode(exitCode);
+  }
 };
 
 ClangInvocationManager::ClangInvocationManager(JFSContext& ctx)
@@ -263,6 +652,15 @@ ClangInvocationManager::~ClangInvocationManager() {}
 
 void ClangInvocationManager::cancel() { impl->cancel(); }
 
+bool ClangInvocationManager::mergeProfile(llvm::StringRef rawProfileFile,
+                                          llvm::StringRef profileFile,
+                                          const ClangOptions* options,
+                                          llvm::StringRef stdOutFile,
+                                          llvm::StringRef stdErrFile) {
+  return impl->mergeProfile(rawProfileFile, profileFile, options, stdOutFile,
+                            stdErrFile);
+}
+
 bool ClangInvocationManager::compile(const CXXProgram* program,
                                      llvm::StringRef sourceFile,
                                      llvm::StringRef outputFile,
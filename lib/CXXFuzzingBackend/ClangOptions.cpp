@@ -19,9 +19,10 @@ namespace cxxfb {
 
 ClangOptions::ClangOptions()
     : pathToBinary(""), pathToRuntimeDir(""), pathToRuntimeIncludeDir(""),
-      pathToLibFuzzerLib(""), optimizationLevel(OptimizationLevel::O0),
+      pathToLibFuzzerLib(""), pathToLibFuzzerInProcessDriver(""),
+      buildSharedObject(false), optimizationLevel(OptimizationLevel::O0),
       debugSymbols(false), useASan(false), useUBSan(false),
-      useJFSRuntimeAsserts(false) {}
+      useJFSRuntimeAsserts(false), usePrecompiledHeader(false) {}
 
 bool ClangOptions::checkPaths(jfs::core::JFSContext& ctx) const {
   bool ok = true;
@@ -39,6 +40,15 @@ bool ClangOptions::checkPaths(jfs::core::JFSContext& ctx) const {
                 << "\" does not exist)\n");
     ok = false;
   }
+
+  if (buildSharedObject &&
+      !llvm::sys::fs::exists(pathToLibFuzzerInProcessDriver)) {
+    IF_VERB(ctx, ctx.getWarningStream()
+                     << "(warning path to LibFuzzer in-process driver \""
+                     << pathToLibFuzzerInProcessDriver
+                     << "\" does not exist)\n");
+    ok = false;
+  }
   bool isDirectory = llvm::sys::fs::is_directory(pathToRuntimeIncludeDir);
   if (!isDirectory) {
     IF_VERB(ctx,
@@ -100,6 +110,10 @@ ClangOptions::ClangOptions(llvm::StringRef pathToExecutable,
   // FIXME: This is linux specific
   llvm::sys::path::append(mutablePath, "Fuzzer", "libLLVMFuzzer.a");
   pathToLibFuzzerLib = std::string(mutablePath.data(), mutablePath.size());
+  llvm::sys::path::remove_filename(mutablePath);
+  llvm::sys::path::append(mutablePath, "LLVMFuzzerJFSInProcessDriver");
+  pathToLibFuzzerInProcessDriver =
+      std::string(mutablePath.data(), mutablePath.size());
 }
 
 void ClangOptions::appendSanitizerCoverageOption(SanitizerCoverageTy opt) {
@@ -112,6 +126,10 @@ void ClangOptions::print(llvm::raw_ostream& os) const {
   os << "pathToBinary: \"" << pathToBinary << "\"\n";
   os << "pathToRuntimeIncludeDir: \"" << pathToRuntimeIncludeDir << "\"\n";
   os << "pathToLibFuzzerLib: \"" << pathToLibFuzzerLib << "\"\n";
+  os << "pathToLibFuzzerInProcessDriver: \"" << pathToLibFuzzerInProcessDriver
+     << "\"\n";
+  os << "buildSharedObject: " << (buildSharedObject ? "true" : "false")
+     << "\n";
   os << "optimizationLevel: ";
   switch (optimizationLevel) {
 #define HANDLE_LEVEL(X)                                                        \
@@ -127,6 +145,12 @@ void ClangOptions::print(llvm::raw_ostream& os) const {
   os << "debug symbols:" << (debugSymbols ? "true" : "false") << "\n";
   os << "useASan: " << (useASan ? "true" : "false") << "\n";
   os << "useUBSan: " << (useUBSan ? "true" : "false") << "\n";
+  os << "useJFSRuntimeAsserts: " << (useJFSRuntimeAsserts ? "true" : "false")
+     << "\n";
+  os << "usePrecompiledHeader: " << (usePrecompiledHeader ? "true" : "false")
+     << "\n";
+  os << "profileInstrGenerateFile: \"" << profileInstrGenerateFile << "\"\n";
+  os << "profileInstrUseFile: \"" << profileInstrUseFile << "\"\n";
   os << "sanitizerCoverageOptions:";
   for (const auto& opt : sanitizerCoverageOptions) {
     switch (opt) {
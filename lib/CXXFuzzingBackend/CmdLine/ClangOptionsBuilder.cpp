@@ -65,6 +65,20 @@ llvm::cl::opt<bool> UseJFSRuntimeAsserts(
     "runtime-asserts",
     llvm::cl::desc("Build JFS runtime asserts enabled (default: false)"),
     llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> UsePrecompiledHeader(
+    "runtime-pch",
+    llvm::cl::desc("Use the runtime's precompiled header when compiling the "
+                   "fuzzing program if it is available (default: true)"),
+    llvm::cl::init(true), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> LibFuzzerInProcess(
+    "libfuzzer-in-process",
+    llvm::cl::desc("Build the fuzzing target as a shared object and run "
+                   "LibFuzzer on it in a helper that passes seeds and results "
+                   "back in memory rather than building and executing a "
+                   "standalone binary (default: false)"),
+    llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
 }
 
 namespace jfs {
@@ -98,6 +112,10 @@ buildClangOptionsFromCmdLine(llvm::StringRef pathToExecutable) {
   clangOptions->useUBSan = UseUBSan;
   // JFS runtime asserts
   clangOptions->useJFSRuntimeAsserts = UseJFSRuntimeAsserts;
+  // Precompiled runtime header
+  clangOptions->usePrecompiledHeader = UsePrecompiledHeader;
+  // Shared object build
+  clangOptions->buildSharedObject = LibFuzzerInProcess;
 
   return clangOptions;
 }
@@ -0,0 +1,30 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/CXXFuzzingBackend/JFSCXXFuzzingDictionaryStat.h"
+
+namespace jfs {
+namespace cxxfb {
+
+JFSCXXFuzzingDictionaryStat::JFSCXXFuzzingDictionaryStat(llvm::StringRef name)
+    : jfs::support::JFSStat(CXX_FUZZING_DICTIONARY, name) {}
+JFSCXXFuzzingDictionaryStat::~JFSCXXFuzzingDictionaryStat() {}
+
+void JFSCXXFuzzingDictionaryStat::printYAML(llvm::ScopedPrinter& sp) const {
+  sp.indent();
+  auto& os = sp.getOStream();
+  os << "\n";
+  sp.startLine() << "name: " << getName() << "\n";
+  sp.startLine() << "num_entries: " << numEntries << "\n";
+  sp.startLine() << "num_used_entries: " << numUsedEntries << "\n";
+  sp.unindent();
+}
+}
+}
@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/CXXFuzzingBackend/JFSCXXFuzzingWorkersStat.h"
+
+namespace jfs {
+namespace cxxfb {
+
+JFSCXXFuzzingWorkersStat::JFSCXXFuzzingWorkersStat(llvm::StringRef name)
+    : jfs::support::JFSStat(CXX_FUZZING_WORKERS, name) {}
+JFSCXXFuzzingWorkersStat::~JFSCXXFuzzingWorkersStat() {}
+
+void JFSCXXFuzzingWorkersStat::printYAML(llvm::ScopedPrinter& sp) const {
+  sp.indent();
+  auto& os = sp.getOStream();
+  os << "\n";
+  sp.startLine() << "name: " << getName() << "\n";
+  sp.startLine() << "num_workers: " << workers.size() << "\n";
+  sp.startLine() << "winning_worker: " << winningWorker << "\n";
+  uint64_t totalExecutedUnits = 0;
+  for (const auto& w : workers) {
+    totalExecutedUnits += w.numExecutedUnits;
+  }
+  sp.startLine() << "total_executed_units: " << totalExecutedUnits << "\n";
+  sp.startLine() << "workers:";
+  if (workers.size() == 0) {
+    os << " []\n";
+    sp.unindent();
+    return;
+  }
+  os << "\n";
+  sp.indent();
+  for (const auto& w : workers) {
+    sp.startLine() << "-\n";
+    sp.indent();
+    sp.startLine() << "seed: " << w.seed << "\n";
+    sp.startLine() << "mutation_depth: " << w.mutationDepth << "\n";
+    sp.startLine() << "cross_over: " << (w.crossOver ? "true" : "false")
+                   << "\n";
+    sp.startLine() << "num_executed_units: " << w.numExecutedUnits << "\n";
+    sp.startLine() << "num_used_dictionary_entries: "
+                   << w.numUsedDictionaryEntries << "\n";
+    sp.startLine() << "outcome: " << w.outcome << "\n";
+    sp.unindent();
+  }
+  sp.unindent();
+  sp.unindent();
+}
+}
+}
@@ -0,0 +1,31 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/CXXFuzzingBackend/JFSCXXProgramCacheStat.h"
+
+namespace jfs {
+namespace cxxfb {
+
+JFSCXXProgramCacheStat::JFSCXXProgramCacheStat(llvm::StringRef name)
+    : jfs::support::JFSStat(CXX_PROGRAM_CACHE, name) {}
+JFSCXXProgramCacheStat::~JFSCXXProgramCacheStat() {}
+
+void JFSCXXProgramCacheStat::printYAML(llvm::ScopedPrinter& sp) const {
+  sp.indent();
+  auto& os = sp.getOStream();
+  os << "\n";
+  sp.startLine() << "name: " << getName() << "\n";
+  sp.startLine() << "hits: " << hits << "\n";
+  sp.startLine() << "misses: " << misses << "\n";
+  sp.startLine() << "bytes_saved: " << bytesSaved << "\n";
+  sp.unindent();
+}
+}
+}
@@ -28,6 +28,10 @@ void JFSCXXProgramStat::printYAML(llvm::ScopedPrinter& sp) const {
   sp.startLine() << "num_free_vars: " << numFreeVars << "\n";
   sp.startLine() << "buffer_width: " << bufferWidth << "\n";
   sp.startLine() << "num_equality_sets: " << numEqualitySets << "\n";
+  sp.startLine() << "num_dictionary_entries: " << numDictionaryEntries << "\n";
+  sp.startLine() << "num_distance_comparisons: " << numDistanceComparisons
+                 << "\n";
+  sp.startLine() << "num_extra_counters: " << numExtraCounters << "\n";
   sp.unindent();
 }
 }
@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/Core/PortfolioSolver.h"
+#include "jfs/Core/IfVerbose.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace jfs {
+namespace core {
+
+class PortfolioSolverResponse : public SolverResponse {
+public:
+  PortfolioSolverResponse(SolverResponse::SolverSatisfiability sat)
+      : SolverResponse(sat) {}
+  std::shared_ptr<Model> getModel() override { return nullptr; }
+};
+
+class PortfolioSolverImpl {
+private:
+  struct Entry {
+    // Declared before `solver` so that it is destroyed after it.
+    std::unique_ptr<JFSContext> ownedCtx;
+    std::unique_ptr<Solver> solver;
+  };
+  JFSContext& ctx;
+  std::atomic<bool> cancelled;
+  std::vector<Entry> entries;
+
+  std::unique_ptr<Query> translateQuery(const Query& q, JFSContext& target) {
+    std::unique_ptr<Query> translated(new Query(target));
+    Z3_context source = q.getContext().getZ3Ctx();
+    for (const auto& constraint : q.constraints) {
+      translated->constraints.push_back(Z3ASTHandle(
+          ::Z3_translate(source, constraint, target.getZ3Ctx()),
+          target.getZ3Ctx()));
+    }
+    return translated;
+  }
+
+public:
+  PortfolioSolverImpl(JFSContext& ctx) : ctx(ctx), cancelled(false) {}
+
+  llvm::StringRef getName() const { return "PortfolioSolver"; }
+
+  void addSolver(std::unique_ptr<Solver> solver,
+                 std::unique_ptr<JFSContext> solverCtx) {
+    assert(solver != nullptr);
+    if (solverCtx) {
+      assert(&(solver->getContext()) == solverCtx.get() &&
+             "solver must use the context it is added with");
+    } else {
+      assert(&(solver->getContext()) == &ctx && "solver must use our context");
+      for (const auto& entry : entries) {
+        assert(entry.ownedCtx &&
+               "only one solver can share the portfolio's context");
+      }
+    }
+    Entry entry;
+    entry.ownedCtx = std::move(solverCtx);
+    entry.solver = std::move(solver);
+    entries.push_back(std::move(entry));
+  }
+
+  void cancel() {
+    cancelled = true;
+    // `entries` is not modified once solving starts so no lock is needed.
+    for (const auto& entry : entries) {
+      entry.solver->cancel();
+    }
+  }
+
+  std::unique_ptr<SolverResponse> solve(const Query& q, bool produceModel) {
+    assert(&(q.getContext()) == &ctx);
+    // Translate the query up front. Nothing else uses the other contexts
+    // yet and no solver is modifying our context.
+    std::vector<std::unique_ptr<Query>> translatedQueries;
+    for (const auto& entry : entries) {
+      if (entry.ownedCtx) {
+        translatedQueries.push_back(translateQuery(q, *(entry.ownedCtx)));
+      } else {
+        translatedQueries.push_back(nullptr);
+      }
+    }
+
+    std::mutex winnerMutex; // protects `winner`
+    int winner = -1;
+    std::vector<std::unique_ptr<SolverResponse>> responses(entries.size());
+    std::vector<std::thread> threads;
+    for (unsigned index = 0; index < entries.size(); ++index) {
+      threads.emplace_back([&, index]() {
+        Solver* solver = entries[index].solver.get();
+        const Query& solverQuery =
+            translatedQueries[index] ? *(translatedQueries[index]) : q;
+        auto response = solver->solve(solverQuery, produceModel);
+        bool won = false;
+        if (response && response->sat != SolverResponse::UNKNOWN) {
+          std::lock_guard<std::mutex> lock(winnerMutex);
+          if (winner == -1) {
+            winner = index;
+            won = true;
+          }
+        }
+        responses[index] = std::move(response);
+        if (won) {
+          IF_VERB(ctx, ctx.getDebugStream() << "(" << getName() << " "
+                                            << solver->getName() << " won)\n");
+          for (unsigned other = 0; other < entries.size(); ++other) {
+            if (other != index) {
+              entries[other].solver->cancel();
+            }
+          }
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+
+    if (winner != -1) {
+      return std::move(responses[winner]);
+    }
+    if (cancelled) {
+      IF_VERB(ctx, ctx.getDebugStream() << "(" << getName() << " cancelled)\n");
+    }
+    return std::unique_ptr<SolverResponse>(
+        new PortfolioSolverResponse(SolverResponse::UNKNOWN));
+  }
+};
+
+PortfolioSolver::PortfolioSolver(std::unique_ptr<SolverOptions> options,
+                                 JFSContext& ctx)
+    : Solver(std::move(options), ctx), impl(new PortfolioSolverImpl(ctx)) {}
+
+PortfolioSolver::~PortfolioSolver() {}
+
+void PortfolioSolver::addSolver(std::unique_ptr<Solver> solver,
+                                std::unique_ptr<JFSContext> solverCtx) {
+  impl->addSolver(std::move(solver), std::move(solverCtx));
+}
+
+std::unique_ptr<SolverResponse> PortfolioSolver::solve(const Query& q,
+                                                       bool produceModel) {
+  return impl->solve(q, produceModel);
+}
+
+llvm::StringRef PortfolioSolver::getName() const { return "PortfolioSolver"; }
+
+void PortfolioSolver::cancel() { impl->cancel(); }
+}
+}
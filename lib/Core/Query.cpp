@@ -37,8 +37,7 @@ void Query::dump() const {
   llvm::errs() << *this;
 }
 
-void Query::print(llvm::raw_ostream& os) const {
-  Z3_context z3Ctx = ctx.getZ3Ctx();
+std::vector<Z3FuncDeclHandle> Query::getFreeVariables() const {
   std::list<Z3ASTHandle> workList;
   for (auto bi = constraints.begin(), be = constraints.end(); bi != be; ++bi) {
     workList.push_front(*bi);
@@ -83,8 +82,14 @@ void Query::print(llvm::raw_ostream& os) const {
               std::string bStr(::Z3_get_symbol_string(b.getContext(), bName));
               return aStr < bStr;
             });
+  return sortedVariables;
+}
+
+void Query::print(llvm::raw_ostream& os) const {
+  Z3_context z3Ctx = ctx.getZ3Ctx();
+  std::vector<Z3FuncDeclHandle> sortedVariables = getFreeVariables();
   // Print variables
-  os << "; Start decls (" << variables.size() << ")\n";
+  os << "; Start decls (" << sortedVariables.size() << ")\n";
   for (auto vi = sortedVariables.begin(), ve = sortedVariables.end(); vi != ve;
        ++vi) {
     Z3ASTHandle asAst = Z3ASTHandle(::Z3_func_decl_to_ast(z3Ctx, *vi), z3Ctx);
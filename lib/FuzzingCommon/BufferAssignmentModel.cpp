@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/FuzzingCommon/BufferAssignmentModel.h"
+#include "llvm/Support/ErrorHandling.h"
+#include <assert.h>
+
+using namespace jfs::core;
+
+namespace {
+
+// Bits are numbered from the least significant bit of the first byte, the
+// same as `makeBitVectorFrom()` in the runtime.
+uint64_t readBits(const std::vector<uint8_t>& input, unsigned bitOffset,
+                  unsigned bitWidth) {
+  assert(bitWidth <= 64);
+  uint64_t value = 0;
+  for (unsigned index = 0; index < bitWidth; ++index) {
+    unsigned bit = bitOffset + index;
+    assert((bit / 8) < input.size());
+    if (input[bit / 8] & (1 << (bit % 8)))
+      value |= UINT64_C(1) << index;
+  }
+  return value;
+}
+
+Z3ASTHandle makeValue(Z3SortHandle sort, uint64_t bits) {
+  Z3_context z3Ctx = sort.getContext();
+  switch (sort.getKind()) {
+  case Z3_BOOL_SORT:
+    return Z3ASTHandle(bits ? ::Z3_mk_true(z3Ctx) : ::Z3_mk_false(z3Ctx),
+                       z3Ctx);
+  case Z3_BV_SORT:
+    return Z3ASTHandle(::Z3_mk_unsigned_int64(z3Ctx, bits, sort), z3Ctx);
+  case Z3_FLOATING_POINT_SORT: {
+    // Reinterpret the IEEE-754 bits and fold it to a constant.
+    Z3SortHandle bvSort(
+        ::Z3_mk_bv_sort(z3Ctx, sort.getFloatingPointBitWidth()), z3Ctx);
+    Z3ASTHandle bv(::Z3_mk_unsigned_int64(z3Ctx, bits, bvSort), z3Ctx);
+    Z3ASTHandle fp(::Z3_mk_fpa_to_fp_bv(z3Ctx, bv, sort), z3Ctx);
+    return Z3ASTHandle(::Z3_simplify(z3Ctx, fp), z3Ctx);
+  }
+  case Z3_ROUNDING_MODE_SORT:
+    return Z3ASTHandle(::Z3_mk_fpa_round_nearest_ties_to_even(z3Ctx), z3Ctx);
+  default:
+    llvm_unreachable("Unhandled sort");
+  }
+}
+}
+
+namespace jfs {
+namespace fuzzingCommon {
+
+BufferAssignmentModel::BufferAssignmentModel(const FuzzingAnalysisInfo& info,
+                                             const std::vector<uint8_t>& input) {
+  decodeBuffer(*(info.freeVariableAssignment->bufferAssignment), input);
+  addConstantAssignments(*(info.freeVariableAssignment->constantAssignments));
+  addIntervals(*(info.bvIntervalExtraction));
+  addEqualities(*(info.equalityExtraction));
+}
+
+BufferAssignmentModel::~BufferAssignmentModel() {}
+
+void BufferAssignmentModel::decodeBuffer(const BufferAssignment& ba,
+                                         const std::vector<uint8_t>& input) {
+  assert(input.size() >= (ba.computeWidth() + 7) / 8);
+  for (const auto& be : ba) {
+    uint64_t bits = readBits(input, be.getBitOffset(), be.getBitWidth());
+    if (be.hasInterval()) {
+      // The buffer stores the offset into the interval. Offsets past the
+      // end of the interval wrap around.
+      const uint64_t span = be.getIntervalHigh() - be.getIntervalLow();
+      if (span != UINT64_MAX)
+        bits %= span + 1;
+      bits += be.getIntervalLow();
+    } else if (be.hasDeadBits()) {
+      // Only the live bits are in the buffer. The rest are zero.
+      bits <<= be.getLiveLowBit();
+    }
+    Z3ASTHandle value = makeValue(be.getSort(), bits);
+    assignments[be.getDecl()] = value;
+    for (const auto& e : be.equalities) {
+      assert(e.isFreeVariable() && "should be free variable");
+      assignments[e.asApp().getFuncDecl()] = value;
+    }
+  }
+}
+
+void BufferAssignmentModel::addConstantAssignments(
+    const ConstantAssignment& ca) {
+  for (const auto& keyPair : ca.assignments) {
+    assert(keyPair.first.isFreeVariable());
+    assignments[keyPair.first.asApp().getFuncDecl()] = keyPair.second;
+  }
+}
+
+void BufferAssignmentModel::addIntervals(const BvIntervalExtractionPass& bie) {
+  for (const auto& keyPair : bie.intervals) {
+    assert(keyPair.first.isFreeVariable());
+    Z3FuncDeclHandle decl = keyPair.first.asApp().getFuncDecl();
+    // A variable whose only constraints were its bounds isn't in the buffer.
+    // Any value in the interval satisfies the bounds that were removed.
+    if (assignments.count(decl) > 0)
+      continue;
+    assignments[decl] = makeValue(decl.getSort(), keyPair.second.first);
+  }
+}
+
+void BufferAssignmentModel::addEqualities(const EqualityExtractionPass& eep) {
+  for (const auto& equalitySet : eep.equalities) {
+    // Use the constant in the set if there is one. Otherwise use the value
+    // of a variable in the set that we already know.
+    Z3ASTHandle value;
+    for (const auto& e : *equalitySet) {
+      if (e.isConstant()) {
+        value = e;
+        break;
+      }
+      if (!value.isNull() || !e.isFreeVariable())
+        continue;
+      auto it = assignments.find(e.asApp().getFuncDecl());
+      if (it != assignments.end())
+        value = it->second;
+    }
+    if (value.isNull())
+      continue;
+    for (const auto& e : *equalitySet) {
+      if (e.isFreeVariable())
+        assignments[e.asApp().getFuncDecl()] = value;
+    }
+  }
+}
+
+Z3ASTHandle BufferAssignmentModel::getAssignment(Z3FuncDeclHandle funcDecl) {
+  auto it = assignments.find(funcDecl);
+  if (it != assignments.end())
+    return it->second;
+  // The variable doesn't affect the constraints so any value will do.
+  return makeValue(funcDecl.getSort(), 0);
+}
+}
+}
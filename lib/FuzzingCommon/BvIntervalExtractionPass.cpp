@@ -0,0 +1,215 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/FuzzingCommon/BvIntervalExtractionPass.h"
+#include "jfs/Core/IfVerbose.h"
+#include "jfs/FuzzingCommon/CommandLineCategory.h"
+#include "llvm/Support/CommandLine.h"
+#include <algorithm>
+#include <vector>
+
+using namespace jfs::core;
+
+namespace {
+llvm::cl::opt<bool> NarrowBvIntervals(
+    "narrow-bv-intervals",
+    llvm::cl::desc("Store bitvector free variables that are bounded by "
+                   "constants as an offset into their bounds in the fuzzing "
+                   "buffer and remove the bounds from the constraints "
+                   "(default: false)"),
+    llvm::cl::init(false),
+    llvm::cl::cat(jfs::fuzzingCommon::CommandLineCategory));
+
+typedef jfs::fuzzingCommon::BvIntervalExtractionPass::IntervalTy IntervalTy;
+
+bool getUInt64Numeral(Z3ASTHandle e, uint64_t& value) {
+  return e.isNumeral() && ::Z3_get_numeral_uint64(e.getContext(), e, &value);
+}
+
+// Comparison equivalent to `c <op> x` when written as `x <op'> c`.
+Z3_decl_kind swapOperands(Z3_decl_kind kind) {
+  switch (kind) {
+  case Z3_OP_ULEQ:
+    return Z3_OP_UGEQ;
+  case Z3_OP_ULT:
+    return Z3_OP_UGT;
+  case Z3_OP_UGEQ:
+    return Z3_OP_ULEQ;
+  case Z3_OP_UGT:
+    return Z3_OP_ULT;
+  default:
+    llvm_unreachable("Unhandled comparison");
+  }
+}
+
+Z3_decl_kind negate(Z3_decl_kind kind) {
+  switch (kind) {
+  case Z3_OP_ULEQ:
+    return Z3_OP_UGT;
+  case Z3_OP_ULT:
+    return Z3_OP_UGEQ;
+  case Z3_OP_UGEQ:
+    return Z3_OP_ULT;
+  case Z3_OP_UGT:
+    return Z3_OP_ULEQ;
+  default:
+    llvm_unreachable("Unhandled comparison");
+  }
+}
+
+// If `constraint` is an unsigned comparison of a bitvector free variable
+// (of at most 64 bits) with a constant (possibly negated) set `variable` and
+// the `interval` the constraint restricts it to. Comparisons that can never
+// be satisfied (e.g. `(bvult x #x00)`) are not matched.
+bool matchBound(Z3ASTHandle constraint, Z3ASTHandle& variable,
+                IntervalTy& interval) {
+  if (!constraint.isApp())
+    return false;
+  Z3AppHandle app = constraint.asApp();
+  bool negated = false;
+  if (app.getKind() == Z3_OP_NOT) {
+    Z3ASTHandle kid = app.getKid(0);
+    if (!kid.isApp())
+      return false;
+    app = kid.asApp();
+    negated = true;
+  }
+  Z3_decl_kind kind = app.getKind();
+  if (kind != Z3_OP_ULEQ && kind != Z3_OP_ULT && kind != Z3_OP_UGEQ &&
+      kind != Z3_OP_UGT)
+    return false;
+  assert(app.getNumKids() == 2);
+  Z3ASTHandle lhs = app.getKid(0);
+  Z3ASTHandle rhs = app.getKid(1);
+  uint64_t bound = 0;
+  if (lhs.isFreeVariable() && getUInt64Numeral(rhs, bound)) {
+    variable = lhs;
+  } else if (rhs.isFreeVariable() && getUInt64Numeral(lhs, bound)) {
+    variable = rhs;
+    kind = swapOperands(kind);
+  } else {
+    return false;
+  }
+  if (negated)
+    kind = negate(kind);
+
+  Z3SortHandle sort = variable.getSort();
+  if (!sort.isBitVectorTy() || sort.getBitVectorWidth() > 64)
+    return false;
+  const unsigned width = sort.getBitVectorWidth();
+  const uint64_t max =
+      width == 64 ? UINT64_MAX : ((UINT64_C(1) << width) - 1);
+  switch (kind) {
+  case Z3_OP_ULEQ:
+    interval = IntervalTy(0, bound);
+    return true;
+  case Z3_OP_ULT:
+    if (bound == 0)
+      return false;
+    interval = IntervalTy(0, bound - 1);
+    return true;
+  case Z3_OP_UGEQ:
+    interval = IntervalTy(bound, max);
+    return true;
+  case Z3_OP_UGT:
+    if (bound == max)
+      return false;
+    interval = IntervalTy(bound + 1, max);
+    return true;
+  default:
+    llvm_unreachable("Unhandled comparison");
+  }
+}
+}
+
+namespace jfs {
+namespace fuzzingCommon {
+
+BvIntervalExtractionPass::BvIntervalExtractionPass(
+    const EqualityExtractionPass& eep)
+    : eep(eep) {}
+
+llvm::StringRef BvIntervalExtractionPass::getName() {
+  return "BvIntervalExtractionPass";
+}
+
+bool BvIntervalExtractionPass::run(jfs::core::Query& q) {
+  JFSContext& ctx = q.getContext();
+  Z3_context z3Ctx = ctx.getZ3Ctx();
+  intervals.clear();
+  if (!NarrowBvIntervals)
+    return false;
+
+  // The variable bounded by each constraint. Null if the constraint isn't a
+  // bound.
+  std::vector<Z3ASTHandle> boundedVariables(q.constraints.size());
+  for (size_t index = 0; index < q.constraints.size(); ++index) {
+    if (cancelled) {
+      IF_VERB(ctx, ctx.getDebugStream() << "(" << getName() << " cancelled)\n");
+      intervals.clear();
+      return false;
+    }
+    Z3ASTHandle variable;
+    IntervalTy interval;
+    if (!matchBound(q.constraints[index], variable, interval))
+      continue;
+    // FIXME: Variables with equalities are stored in the buffer once for the
+    // whole equality set so the bounds of every variable in the set would
+    // need to be combined.
+    if (eep.mapping.count(variable) > 0)
+      continue;
+    boundedVariables[index] = variable;
+    auto itSucPair = intervals.insert(std::make_pair(variable, interval));
+    if (itSucPair.second)
+      continue;
+    // Intersect with the bounds found so far.
+    IntervalTy& existing = itSucPair.first->second;
+    existing.first = std::max(existing.first, interval.first);
+    existing.second = std::min(existing.second, interval.second);
+  }
+
+  if (intervals.size() == 0) {
+    // No bounds were found so nothing was changed.
+    return false;
+  }
+
+  for (const auto& kvp : intervals) {
+    if (kvp.second.first > kvp.second.second) {
+      // Found inconsistency. Replace constraints with false
+      intervals.clear();
+      q.constraints.clear();
+      q.constraints.push_back(Z3ASTHandle(::Z3_mk_false(z3Ctx), z3Ctx));
+      return true;
+    }
+  }
+
+  // Every value decoded from the buffer satisfies the bounds so they no
+  // longer need to be checked.
+  std::vector<Z3ASTHandle> newConstraints;
+  newConstraints.reserve(q.constraints.size());
+  for (size_t index = 0; index < q.constraints.size(); ++index) {
+    if (boundedVariables[index].isNull())
+      newConstraints.push_back(q.constraints[index]);
+  }
+  q.constraints = std::move(newConstraints);
+
+  if (ctx.getVerbosity() > 1) {
+    auto& ss = ctx.getDebugStream();
+    ss << "(" << getName() << "\n";
+    for (const auto& kvp : intervals) {
+      ss << "  " << kvp.first.toStr() << " in [" << kvp.second.first << ", "
+         << kvp.second.second << "]\n";
+    }
+    ss << ")\n";
+  }
+  return true;
+}
+}
+}
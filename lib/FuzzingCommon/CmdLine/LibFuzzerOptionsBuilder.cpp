@@ -48,6 +48,14 @@ llvm::cl::opt<bool>
                                   "ones to the corpus (default: true)"),
                    llvm::cl::init(true),
                    llvm::cl::cat(jfs::fuzzingCommon::CommandLineCategory));
+
+llvm::cl::opt<bool> AddSortAwareSeeds(
+    "libfuzzer-sort-aware-seeds",
+    llvm::cl::desc("Add seeds built from special values of each free "
+                   "variable's sort (e.g. NaN, infinity, signed min) to the "
+                   "corpus (default: true)"),
+    llvm::cl::init(true),
+    llvm::cl::cat(jfs::fuzzingCommon::CommandLineCategory));
 }
 
 namespace jfs {
@@ -74,6 +82,9 @@ buildLibFuzzerOptionsFromCmdLine() {
   // All ones seed
   libFuzzerOptions->addAllOneMaxLengthSeed = AddAllOnesSeed;
 
+  // Sort aware seeds
+  libFuzzerOptions->addSortAwareSeeds = AddSortAwareSeeds;
+
   return libFuzzerOptions;
 }
 }
@@ -0,0 +1,216 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/FuzzingCommon/ConstraintOrdering.h"
+#include "jfs/Core/Z3NodeMap.h"
+#include "jfs/Core/Z3NodeSet.h"
+#include <algorithm>
+#include <assert.h>
+#include <list>
+#include <math.h>
+#include <numeric>
+
+using namespace jfs::core;
+
+namespace {
+
+// Rough relative cost of evaluating `e` in the runtime once its operands are
+// available. Free variables and constants are built before any constraint
+// is checked so they are free.
+double getOperationCost(Z3AppHandle e) {
+  if (e.getNumKids() == 0)
+    return 0.0;
+  switch (e.getKind()) {
+  // Floating point operations that go through the rounding mode machinery.
+  case Z3_OP_FPA_FMA:
+  case Z3_OP_FPA_REM:
+    return 25.0;
+  case Z3_OP_FPA_SQRT:
+    return 20.0;
+  case Z3_OP_FPA_DIV:
+    return 10.0;
+  case Z3_OP_FPA_ADD:
+  case Z3_OP_FPA_SUB:
+  case Z3_OP_FPA_MUL:
+  case Z3_OP_FPA_ROUND_TO_INTEGRAL:
+  case Z3_OP_FPA_TO_FP:
+  case Z3_OP_FPA_TO_FP_UNSIGNED:
+    return 5.0;
+  case Z3_OP_FPA_TO_UBV:
+  case Z3_OP_FPA_TO_SBV:
+    return 4.0;
+  case Z3_OP_BUDIV:
+  case Z3_OP_BSDIV:
+  case Z3_OP_BUREM:
+  case Z3_OP_BSREM:
+  case Z3_OP_BSMOD:
+  case Z3_OP_BUDIV_I:
+  case Z3_OP_BSDIV_I:
+  case Z3_OP_BUREM_I:
+  case Z3_OP_BSREM_I:
+  case Z3_OP_BSMOD_I:
+    return 4.0;
+  case Z3_OP_BMUL:
+    return 2.0;
+  default:
+    break;
+  }
+  // Remaining floating point operations (e.g. classification and
+  // comparison) are cheaper but still more than a native integer operation.
+  for (unsigned index = 0; index < e.getNumKids(); ++index) {
+    if (e.getKid(index).getSort().isFloatingPointTy())
+      return 2.0;
+  }
+  return 1.0;
+}
+
+// Number of random bits that must match for two values of `sort` to be
+// equal, capped so the probability doesn't underflow.
+double getProbabilityOfEquality(Z3SortHandle sort) {
+  unsigned width = 1;
+  if (sort.isBitVectorTy())
+    width = sort.getBitVectorWidth();
+  else if (sort.isFloatingPointTy())
+    width = sort.getFloatingPointBitWidth();
+  return ldexp(1.0, -static_cast<int>(std::min(width, 30u)));
+}
+
+// Probability that `lhs <= rhs` (unsigned) when one side is a constant.
+double getProbabilityOfULE(Z3ASTHandle lhs, Z3ASTHandle rhs) {
+  Z3SortHandle sort = lhs.getSort();
+  uint64_t value = 0;
+  if (!sort.isBitVectorTy() || sort.getBitVectorWidth() > 64)
+    return 0.5;
+  const double range = ldexp(1.0, sort.getBitVectorWidth());
+  if (rhs.isNumeral() &&
+      ::Z3_get_numeral_uint64(rhs.getContext(), rhs, &value)) {
+    return (static_cast<double>(value) + 1.0) / range;
+  }
+  if (lhs.isNumeral() &&
+      ::Z3_get_numeral_uint64(lhs.getContext(), lhs, &value)) {
+    return (range - static_cast<double>(value)) / range;
+  }
+  return 0.5;
+}
+
+// Estimate the probability that `e` is true for a random input. Only the
+// top-level boolean structure and the comparisons under it are looked at.
+double getProbabilityOfTrue(Z3ASTHandle e, unsigned depth = 0) {
+  if (e.isTrue())
+    return 1.0;
+  if (e.isFalse())
+    return 0.0;
+  if (!e.isApp() || depth > 16)
+    return 0.5;
+  Z3AppHandle app = e.asApp();
+  const unsigned numKids = app.getNumKids();
+  switch (app.getKind()) {
+  case Z3_OP_NOT:
+    return 1.0 - getProbabilityOfTrue(app.getKid(0), depth + 1);
+  case Z3_OP_AND: {
+    double p = 1.0;
+    for (unsigned index = 0; index < numKids; ++index)
+      p *= getProbabilityOfTrue(app.getKid(index), depth + 1);
+    return p;
+  }
+  case Z3_OP_OR: {
+    double q = 1.0;
+    for (unsigned index = 0; index < numKids; ++index)
+      q *= 1.0 - getProbabilityOfTrue(app.getKid(index), depth + 1);
+    return 1.0 - q;
+  }
+  case Z3_OP_EQ:
+  case Z3_OP_FPA_EQ:
+    return getProbabilityOfEquality(app.getKid(0).getSort());
+  case Z3_OP_DISTINCT:
+    return 1.0 - getProbabilityOfEquality(app.getKid(0).getSort());
+  case Z3_OP_ULEQ:
+    return getProbabilityOfULE(app.getKid(0), app.getKid(1));
+  case Z3_OP_UGEQ:
+    return getProbabilityOfULE(app.getKid(1), app.getKid(0));
+  case Z3_OP_ULT:
+    return 1.0 - getProbabilityOfULE(app.getKid(1), app.getKid(0));
+  case Z3_OP_UGT:
+    return 1.0 - getProbabilityOfULE(app.getKid(0), app.getKid(1));
+  // Proportion of random bit patterns in each class.
+  case Z3_OP_FPA_IS_NAN:
+  case Z3_OP_FPA_IS_SUBNORMAL:
+    return 1.0 / 256;
+  case Z3_OP_FPA_IS_INF:
+  case Z3_OP_FPA_IS_ZERO:
+    return getProbabilityOfEquality(app.getKid(0).getSort());
+  case Z3_OP_FPA_IS_NORMAL:
+    return 1.0 - (2.0 / 256);
+  default:
+    return 0.5;
+  }
+}
+}
+
+namespace jfs {
+namespace fuzzingCommon {
+
+std::vector<Z3ASTHandle>
+orderConstraintsByCost(const std::vector<Z3ASTHandle>& constraints) {
+  return orderConstraintsByCost(
+      constraints, std::vector<double>(constraints.size(), -1.0));
+}
+
+std::vector<Z3ASTHandle>
+orderConstraintsByCost(const std::vector<Z3ASTHandle>& constraints,
+                       const std::vector<double>& probabilitiesOfTrue) {
+  assert(probabilitiesOfTrue.size() == constraints.size());
+  // Collect the operations each constraint needs and how many constraints
+  // need each operation.
+  std::vector<std::vector<Z3AppHandle>> operations(constraints.size());
+  Z3ASTMap<unsigned> numUses;
+  for (size_t index = 0; index < constraints.size(); ++index) {
+    Z3ASTSet seen;
+    std::list<Z3ASTHandle> workList;
+    workList.push_back(constraints[index]);
+    while (workList.size() > 0) {
+      Z3ASTHandle node = workList.front();
+      workList.pop_front();
+      if (!node.isApp() || !seen.insert(node).second)
+        continue;
+      Z3AppHandle app = node.asApp();
+      operations[index].push_back(app);
+      ++numUses[node];
+      for (unsigned kidIndex = 0; kidIndex < app.getNumKids(); ++kidIndex)
+        workList.push_back(app.getKid(kidIndex));
+    }
+  }
+
+  std::vector<double> scores(constraints.size());
+  for (size_t index = 0; index < constraints.size(); ++index) {
+    // Every constraint costs at least its branch.
+    double cost = 1.0;
+    for (const auto& app : operations[index])
+      cost += getOperationCost(app) / numUses[app.asAST()];
+    double probabilityOfTrue = probabilitiesOfTrue[index];
+    if (probabilityOfTrue < 0.0)
+      probabilityOfTrue = getProbabilityOfTrue(constraints[index]);
+    double probabilityOfFalse = 1.0 - probabilityOfTrue;
+    scores[index] = cost / std::max(probabilityOfFalse, 1e-9);
+  }
+
+  std::vector<size_t> order(constraints.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return scores[a] < scores[b];
+  });
+  std::vector<Z3ASTHandle> orderedConstraints;
+  orderedConstraints.reserve(constraints.size());
+  for (size_t index : order)
+    orderedConstraints.push_back(constraints[index]);
+  return orderedConstraints;
+}
+}
+}
@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/FuzzingCommon/ConstraintOrderingPass.h"
+#include "jfs/Core/IfVerbose.h"
+#include "jfs/FuzzingCommon/ConstraintOrdering.h"
+
+using namespace jfs::core;
+
+namespace jfs {
+namespace fuzzingCommon {
+
+bool ConstraintOrderingPass::run(Query& q) {
+  JFSContext& ctx = q.getContext();
+  if (cancelled) {
+    IF_VERB(ctx, ctx.getDebugStream() << "(" << getName() << " cancelled)\n");
+    return false;
+  }
+  std::vector<Z3ASTHandle> ordered = orderConstraintsByCost(q.constraints);
+  assert(ordered.size() == q.constraints.size());
+  bool changed = false;
+  for (unsigned index = 0; index < ordered.size(); ++index) {
+    if (!ordered[index].isStructurallyEqualTo(q.constraints[index])) {
+      changed = true;
+      break;
+    }
+  }
+  if (changed)
+    q.constraints = std::move(ordered);
+  return changed;
+}
+
+llvm::StringRef ConstraintOrderingPass::getName() {
+  return "ConstraintOrderingPass";
+}
+}
+}
@@ -10,11 +10,16 @@
 //===----------------------------------------------------------------------===//
 #include "jfs/FuzzingCommon/FreeVariableToBufferAssignmentPass.h"
 #include "jfs/Core/IfVerbose.h"
+#include "jfs/Core/Z3NodeMap.h"
 #include "jfs/Core/Z3NodeSet.h"
 #include "jfs/FuzzingCommon/CommandLineCategory.h"
+#include "jfs/FuzzingCommon/JFSBufferAssignmentStat.h"
+#include "jfs/Support/StatisticsManager.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MathExtras.h"
 #include <algorithm>
 #include <list>
+#include <unordered_map>
 #include <vector>
 
 using namespace jfs::core;
@@ -25,6 +30,8 @@ namespace {
 enum FreeVariableSortStrategyTy {
   ALPHABETICAL,
   FIRST_OBSERVED,
+  CONSTRAINT_LOCALITY,
+  ALIGNED,
   NONE, // Warning: Will likely be non-deterministic
 };
 llvm::cl::opt<FreeVariableSortStrategyTy> FreeVariableSortStrategy(
@@ -35,20 +42,152 @@ llvm::cl::opt<FreeVariableSortStrategyTy> FreeVariableSortStrategy(
                    "Sort free variables alphabetically (slow)"),
         clEnumValN(FIRST_OBSERVED, "first_observed",
                    "sort free variables by observation order (default)"),
+        clEnumValN(CONSTRAINT_LOCALITY, "constraint_locality",
+                   "Place free variables used by earlier constraints first "
+                   "and free variables used together next to each other"),
+        clEnumValN(ALIGNED, "aligned",
+                   "Group free variables by alignment and pad them to it. "
+                   "Booleans are packed together at the end"),
         clEnumValN(NONE, "none", "Do not order. This is non-deterministic")),
     llvm::cl::init(FIRST_OBSERVED),
     llvm::cl::cat(jfs::fuzzingCommon::CommandLineCategory));
+
+llvm::cl::opt<bool> OnlyStoreLiveBits(
+    "buffer-live-bits-only",
+    llvm::cl::desc("Only store the bits of bitvector free variables that can "
+                   "affect the constraints in the fuzzing buffer "
+                   "(default: true)"),
+    llvm::cl::init(true),
+    llvm::cl::cat(jfs::fuzzingCommon::CommandLineCategory));
+
+// Bits [first, second] of a free variable that are used.
+typedef std::pair<unsigned, unsigned> LiveBitsTy;
+
+// Record which bits of the free variables that are kids of `node` are used
+// by it. Only extracts use part of a variable.
+void updateLiveBits(Z3AppHandle node, Z3ASTMap<LiveBitsTy>& liveBits) {
+  for (unsigned index = 0; index < node.getNumKids(); ++index) {
+    Z3ASTHandle kid = node.getKid(index);
+    if (!kid.isFreeVariable() || !kid.getSort().isBitVectorTy())
+      continue;
+    LiveBitsTy used(0, kid.getSort().getBitVectorWidth() - 1);
+    if (node.getKind() == Z3_OP_EXTRACT) {
+      Z3FuncDeclHandle funcDecl = node.getFuncDecl();
+      used = LiveBitsTy(funcDecl.getIntParam(1), funcDecl.getIntParam(0));
+    }
+    auto itSucPair = liveBits.insert(std::make_pair(kid, used));
+    if (itSucPair.second)
+      continue;
+    LiveBitsTy& live = itSucPair.first->second;
+    live.first = std::min(live.first, used.first);
+    live.second = std::max(live.second, used.second);
+  }
+}
+
+// Order free variables so that those used by the first constraints (which
+// the fuzzing program checks first) form a prefix of the buffer and
+// variables used by the same constraints are next to each other.
+std::vector<Z3ASTHandle>
+getConstraintLocalityOrder(const std::vector<Z3ASTHandle>& constraints) {
+  // Collect the free variables used by each constraint.
+  Z3ASTMap<size_t> variableIndices;
+  std::vector<Z3ASTHandle> variables;
+  std::vector<std::vector<size_t>> constraintVariables;
+  for (const auto& constraint : constraints) {
+    constraintVariables.emplace_back();
+    Z3ASTSet seenExpr;
+    std::list<Z3ASTHandle> workList;
+    workList.push_back(constraint);
+    while (workList.size() > 0) {
+      Z3ASTHandle node = workList.front();
+      workList.pop_front();
+      if (!seenExpr.insert(node).second)
+        continue;
+      if (node.isFreeVariable()) {
+        auto itSucPair =
+            variableIndices.insert(std::make_pair(node, variables.size()));
+        if (itSucPair.second)
+          variables.push_back(node);
+        constraintVariables.back().push_back(itSucPair.first->second);
+        continue;
+      }
+      if (!node.isApp())
+        continue;
+      Z3AppHandle asApp = node.asApp();
+      for (unsigned index = 0; index < asApp.getNumKids(); ++index) {
+        workList.push_front(asApp.getKid((asApp.getNumKids() - 1) - index));
+      }
+    }
+  }
+
+  // Count how many constraints each pair of variables appears in together.
+  std::vector<std::unordered_map<size_t, unsigned>> coOccurrences(
+      variables.size());
+  for (const auto& used : constraintVariables) {
+    for (size_t i = 0; i < used.size(); ++i) {
+      for (size_t j = i + 1; j < used.size(); ++j) {
+        ++coOccurrences[used[i]][used[j]];
+        ++coOccurrences[used[j]][used[i]];
+      }
+    }
+  }
+
+  // Place the variables each constraint introduces, in constraint order.
+  // Within a constraint greedily place next the variable that appears with
+  // the previously placed variable most often, breaking ties by first use.
+  std::vector<Z3ASTHandle> ordered;
+  std::vector<bool> placed(variables.size(), false);
+  bool hasLast = false;
+  size_t last = 0;
+  for (const auto& used : constraintVariables) {
+    std::vector<size_t> pending;
+    for (size_t variable : used) {
+      if (!placed[variable])
+        pending.push_back(variable);
+    }
+    while (pending.size() > 0) {
+      size_t best = 0;
+      unsigned bestCount = 0;
+      for (size_t index = 0; hasLast && index < pending.size(); ++index) {
+        const auto& counts = coOccurrences[last];
+        auto it = counts.find(pending[index]);
+        if (it != counts.end() && it->second > bestCount) {
+          best = index;
+          bestCount = it->second;
+        }
+      }
+      last = pending[best];
+      hasLast = true;
+      placed[last] = true;
+      ordered.push_back(variables[last]);
+      pending.erase(pending.begin() + best);
+    }
+  }
+  return ordered;
+}
 }
 
 namespace jfs {
 namespace fuzzingCommon {
 
-BufferElement::BufferElement(const Z3ASTHandle declApp) : declApp(declApp) {
+BufferElement::BufferElement(const Z3ASTHandle declApp)
+    : bitOffset(0), liveLowBit(0), liveBitWidth(0), narrowed(false),
+      intervalLow(0), intervalHigh(0), declApp(declApp) {
   assert(declApp.isApp() && "should be an application");
   assert(declApp.asApp().isFreeVariable() && "should be an application");
 }
 
 unsigned BufferElement::getBitWidth() const {
+  if (narrowed) {
+    const uint64_t span = intervalHigh - intervalLow;
+    return span == 0 ? 1 : (64 - llvm::countLeadingZeros(span));
+  }
+  if (liveBitWidth > 0)
+    return liveBitWidth;
+  return getSortBitWidth();
+}
+
+unsigned BufferElement::getSortBitWidth() const {
   Z3SortHandle sort = declApp.getSort();
   switch (sort.getKind()) {
   case Z3_BOOL_SORT:
@@ -63,6 +202,36 @@ unsigned BufferElement::getBitWidth() const {
   }
 }
 
+void BufferElement::setLiveBits(unsigned lowBit, unsigned highBit) {
+  assert(getSort().isBitVectorTy() && "only bitvectors can have dead bits");
+  assert(lowBit <= highBit && highBit < getSortBitWidth() && "invalid bits");
+  liveLowBit = lowBit;
+  liveBitWidth = (highBit - lowBit) + 1;
+}
+
+void BufferElement::setInterval(uint64_t low, uint64_t high) {
+  assert(getSort().isBitVectorTy() && "only bitvectors can have intervals");
+  assert(getSortBitWidth() <= 64 && "interval bounds are at most 64 bits");
+  assert(low <= high && "invalid interval");
+  assert(equalities.size() == 0 && "equalities would not be in the interval");
+  narrowed = true;
+  intervalLow = low;
+  intervalHigh = high;
+}
+
+unsigned BufferElement::getNaturalBitAlignment() const {
+  if (getSort().getKind() == Z3_BOOL_SORT)
+    return 1;
+  // The smallest power of two number of bytes, up to a word, that the
+  // element fits in. Smaller elements are byte aligned so they never
+  // straddle bytes.
+  const unsigned bitWidth = getBitWidth();
+  unsigned alignment = 8;
+  while (alignment < bitWidth && alignment < 64)
+    alignment *= 2;
+  return alignment;
+}
+
 Z3FuncDeclHandle BufferElement::getDecl() const {
   return declApp.asApp().getFuncDecl();
 }
@@ -76,7 +245,15 @@ Z3SortHandle BufferElement::getSort() const {
 }
 
 void BufferElement::print(llvm::raw_ostream& os) const {
-  os << "(" << getDecl().getName() << ":" << getBitWidth();
+  os << "(" << getDecl().getName() << ":" << getBitWidth() << "@"
+     << bitOffset;
+  if (hasDeadBits()) {
+    os << " live: [" << (liveLowBit + getBitWidth() - 1) << ":" << liveLowBit
+       << "]";
+  }
+  if (narrowed) {
+    os << " interval: [" << intervalLow << ", " << intervalHigh << "]";
+  }
   if (equalities.size() > 0) {
     os << " equalities: ";
     for (const auto& e : equalities) {
@@ -88,13 +265,25 @@ void BufferElement::print(llvm::raw_ostream& os) const {
 
 void BufferElement::dump() const { print(llvm::errs()); }
 
-void BufferAssignment::appendElement(BufferElement& el) {
+void BufferAssignment::appendElement(BufferElement& el,
+                                     unsigned bitAlignment) {
+  assert(bitAlignment > 0 && "invalid alignment");
+  auto roundUp = [bitAlignment](unsigned bit) {
+    return ((bit + bitAlignment - 1) / bitAlignment) * bitAlignment;
+  };
+  el.bitOffset = roundUp(paddedEnd);
+  paddedEnd = roundUp(el.bitOffset + el.getBitWidth());
   chunks.push_back(el);
 }
 
-// FIXME: We are assuming everything can aligned to a bit boundary.
-// This might not be correct.
 unsigned BufferAssignment::computeWidth() const {
+  if (chunks.size() == 0)
+    return 0;
+  // Elements are appended in order of increasing offset.
+  return chunks.back().getBitOffset() + chunks.back().getBitWidth();
+}
+
+unsigned BufferAssignment::computePackedWidth() const {
   unsigned totalWidth = 0;
   for (const auto& ba : chunks) {
     totalWidth += ba.getBitWidth();
@@ -103,7 +292,8 @@ unsigned BufferAssignment::computeWidth() const {
 }
 
 void BufferAssignment::print(llvm::raw_ostream& os) const {
-  os << "(BufferAssignment " << computeWidth() << " bits\n";
+  os << "(BufferAssignment " << computeWidth() << " bits ("
+     << computePackedWidth() << " packed)\n";
   for (const auto& be : chunks) {
     os << "  ";
     be.print(os);
@@ -129,8 +319,13 @@ void ConstantAssignment::print(llvm::raw_ostream& os) const {
 void ConstantAssignment::dump() const { print(llvm::errs()); }
 
 FreeVariableToBufferAssignmentPass::FreeVariableToBufferAssignmentPass(
-    const EqualityExtractionPass& eep)
-    : eep(eep) {}
+    const EqualityExtractionPass& eep, const BvIntervalExtractionPass& biep)
+    : eep(eep), biep(biep) {}
+
+bool FreeVariableToBufferAssignmentPass::layoutDependsOnConstraintOrder()
+    const {
+  return FreeVariableSortStrategy == CONSTRAINT_LOCALITY;
+}
 
 llvm::StringRef FreeVariableToBufferAssignmentPass::getName() {
   return "FreeVariableToBufferAssignmentPass";
@@ -147,6 +342,8 @@ bool FreeVariableToBufferAssignmentPass::run(jfs::core::Query& q) {
   // This contains the same ASTs as `freeVariableApps` but gives
   // a deterministic ordering.
   std::vector<Z3ASTHandle> orderedFreeVariableApps;
+  // The bits of each bitvector free variable that are used.
+  Z3ASTMap<LiveBitsTy> liveBits;
 
   std::list<Z3ASTHandle> workList;
   for (const auto& c : q.constraints) {
@@ -169,10 +366,11 @@ bool FreeVariableToBufferAssignmentPass::run(jfs::core::Query& q) {
     seenExpr.insert(node);
     if (node.isFreeVariable()) {
       auto itSucPair = freeVariableApps.insert(node);
-      if (itSucPair.second && FreeVariableSortStrategy == FIRST_OBSERVED) {
+      if (itSucPair.second && (FreeVariableSortStrategy == FIRST_OBSERVED ||
+                               FreeVariableSortStrategy == ALIGNED)) {
         // This is the first time we've observed this free variable
-        // and we are using the "first observed" ordering strategy
-        // so add the free variable to the ordered list.
+        // and we are using a strategy that starts from the "first observed"
+        // ordering so add the free variable to the ordered list.
         orderedFreeVariableApps.push_back(node);
       }
       continue;
@@ -181,6 +379,7 @@ bool FreeVariableToBufferAssignmentPass::run(jfs::core::Query& q) {
       continue;
     }
     Z3AppHandle asApp = node.asApp();
+    updateLiveBits(asApp, liveBits);
     // Must be an application. Add its arguments to the work list
     for (unsigned index = 0; index < asApp.getNumKids(); ++index) {
       workList.push_front(asApp.getKid((asApp.getNumKids() - 1) - index));
@@ -208,6 +407,12 @@ bool FreeVariableToBufferAssignmentPass::run(jfs::core::Query& q) {
               });
     break;
   }
+  case CONSTRAINT_LOCALITY: {
+    assert(orderedFreeVariableApps.size() == 0);
+    orderedFreeVariableApps = getConstraintLocalityOrder(q.constraints);
+    assert(orderedFreeVariableApps.size() == freeVariableApps.size());
+    break;
+  }
   case NONE: {
     assert(orderedFreeVariableApps.size() == 0);
     orderedFreeVariableApps.insert(orderedFreeVariableApps.end(),
@@ -216,6 +421,8 @@ bool FreeVariableToBufferAssignmentPass::run(jfs::core::Query& q) {
     // Add with non-deterministic ordering
     break;
   }
+  case ALIGNED:
+    // Elements are grouped once equalities have been handled.
   case FIRST_OBSERVED: {
     // Nothing to do
     assert(orderedFreeVariableApps.size() == freeVariableApps.size());
@@ -230,7 +437,7 @@ bool FreeVariableToBufferAssignmentPass::run(jfs::core::Query& q) {
   // the query are not added. From a fuzzing perspective this means
   // those equalites don't need to be considered because they can be
   // trivialled satisfied.
-  bufferAssignment = std::make_shared<BufferAssignment>();
+  std::vector<BufferElement> elements;
   constantAssignments = std::make_shared<ConstantAssignment>();
   Z3ASTSet alreadyAssigned; // Already assigned to constant map or buffer
   for (const auto& freeVarApp : orderedFreeVariableApps) {
@@ -252,7 +459,22 @@ bool FreeVariableToBufferAssignmentPass::run(jfs::core::Query& q) {
     if (equalitySetsIt == eep.mapping.end()) {
       // No equalites so append to buffer
       BufferElement el(freeVarApp);
-      bufferAssignment->appendElement(el);
+      // An interval needs every bit of the variable to be decoded so live
+      // bits are only used for variables without one.
+      const auto intervalIt = biep.intervals.find(freeVarApp);
+      if (intervalIt != biep.intervals.end()) {
+        el.setInterval(intervalIt->second.first, intervalIt->second.second);
+        elements.push_back(el);
+        continue;
+      }
+      // FIXME: Variables with equalities would need the live bits of every
+      // variable in the equality set.
+      const auto liveBitsIt = liveBits.find(freeVarApp);
+      if (OnlyStoreLiveBits && liveBitsIt != liveBits.end() &&
+          el.getSortBitWidth() <= 64) {
+        el.setLiveBits(liveBitsIt->second.first, liveBitsIt->second.second);
+      }
+      elements.push_back(el);
       continue;
     }
 
@@ -302,7 +524,51 @@ bool FreeVariableToBufferAssignmentPass::run(jfs::core::Query& q) {
       el.equalities.push_back(e);
       alreadyAssigned.insert(e);
     }
-    bufferAssignment->appendElement(el);
+    elements.push_back(el);
+  }
+
+  // Lay out the buffer.
+  bufferAssignment = std::make_shared<BufferAssignment>();
+  if (FreeVariableSortStrategy == ALIGNED) {
+    // Placing elements in order of decreasing alignment means they only
+    // need padding when their width isn't a multiple of their alignment.
+    // Every element other than a boolean is padded to its alignment so it
+    // never shares a byte with another element. Booleans have the smallest
+    // alignment so they end up packed together at the end of the buffer.
+    // NOTE: `BufferElement` isn't assignable so sort pointers to them.
+    std::vector<BufferElement*> sortedElements;
+    for (auto& el : elements) {
+      sortedElements.push_back(&el);
+    }
+    std::stable_sort(sortedElements.begin(), sortedElements.end(),
+                     [](const BufferElement* a, const BufferElement* b) {
+                       return a->getNaturalBitAlignment() >
+                              b->getNaturalBitAlignment();
+                     });
+    for (auto el : sortedElements) {
+      bufferAssignment->appendElement(*el, el->getNaturalBitAlignment());
+    }
+  } else {
+    for (auto& el : elements) {
+      bufferAssignment->appendElement(el);
+    }
+  }
+
+  if (ctx.getStats() != nullptr) {
+    std::unique_ptr<JFSBufferAssignmentStat> stat(
+        new JFSBufferAssignmentStat(getName()));
+    stat->numElements = bufferAssignment->size();
+    stat->widthInBits = bufferAssignment->computeWidth();
+    stat->packedWidthInBits = bufferAssignment->computePackedWidth();
+    for (const auto& be : *bufferAssignment) {
+      if (be.hasInterval()) {
+        ++(stat->numNarrowedElements);
+        stat->numNarrowedBits += be.getSortBitWidth() - be.getBitWidth();
+        continue;
+      }
+      stat->numDeadBits += be.getSortBitWidth() - be.getBitWidth();
+    }
+    ctx.getStats()->append(std::move(stat));
   }
 
   if (ctx.getVerbosity() > 1) {
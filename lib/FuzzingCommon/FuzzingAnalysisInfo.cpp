@@ -13,10 +13,14 @@
 namespace jfs {
 namespace fuzzingCommon {
 
-FuzzingAnalysisInfo::FuzzingAnalysisInfo()
+FuzzingAnalysisInfo::FuzzingAnalysisInfo(bool orderConstraintsByCost)
     : equalityExtraction(std::make_shared<EqualityExtractionPass>()) {
-  freeVariableAssignment =
-      std::make_shared<FreeVariableToBufferAssignmentPass>(*equalityExtraction);
+  bvIntervalExtraction =
+      std::make_shared<BvIntervalExtractionPass>(*equalityExtraction);
+  if (orderConstraintsByCost)
+    constraintOrdering = std::make_shared<ConstraintOrderingPass>();
+  freeVariableAssignment = std::make_shared<FreeVariableToBufferAssignmentPass>(
+      *equalityExtraction, *bvIntervalExtraction);
 }
 
 FuzzingAnalysisInfo::~FuzzingAnalysisInfo() {}
@@ -26,6 +30,13 @@ void FuzzingAnalysisInfo::addTo(jfs::transform::QueryPassManager &pm) {
 
   // Look for equalities, extract them and remove them from the constraints
   pm.add(equalityExtraction);
+  // Look for constant bounds on variables, extract them and remove them from
+  // the constraints
+  pm.add(bvIntervalExtraction);
+  // Put the remaining constraints in the order they will be checked in so
+  // that the buffer layout can follow it.
+  if (constraintOrdering)
+    pm.add(constraintOrdering);
   pm.add(freeVariableAssignment);
 }
 }
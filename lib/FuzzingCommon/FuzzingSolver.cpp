@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #include "jfs/FuzzingCommon/FuzzingSolver.h"
 #include "jfs/Core/IfVerbose.h"
+#include "jfs/FuzzingCommon/BufferAssignmentModel.h"
 #include "jfs/FuzzingCommon/FuzzingAnalysisInfo.h"
 #include "jfs/Transform/QueryPassManager.h"
 #include <atomic>
@@ -25,15 +26,16 @@ namespace fuzzingCommon {
 // This response type is used for the trivial queries
 // that we can solve without fuzzing
 class TrivialFuzzingSolverResponse : public jfs::core::SolverResponse {
+private:
+  std::shared_ptr<Model> model;
+
 public:
   TrivialFuzzingSolverResponse(SolverResponse::SolverSatisfiability sat)
       : SolverResponse(sat) {}
-  std::shared_ptr<Model> getModel() override {
-    // TODO: Figure out how to support Model generation.
-    // Can we have common code for all fuzzing backends or
-    // will they need their own?
-    return nullptr;
-  }
+  TrivialFuzzingSolverResponse(SolverResponse::SolverSatisfiability sat,
+                               std::shared_ptr<Model> model)
+      : SolverResponse(sat), model(model) {}
+  std::shared_ptr<Model> getModel() override { return model; }
 };
 
 // FIXME: This complication exists because I don't want to expose the
@@ -66,10 +68,9 @@ public:
         new TrivialFuzzingSolverResponse(SolverResponse::UNKNOWN));            \
   }
 
-    // Check for trivial SAT
-    if (q.constraints.size() == 0) {
+    // Check for trivial SAT. The model is built from the analysis below.
+    if (q.constraints.size() == 0 && !produceModel) {
       // Empty constraint set is trivially satisifiable
-      assert(!produceModel && "producing models not implemented");
       return std::unique_ptr<SolverResponse>(
           new TrivialFuzzingSolverResponse(SolverResponse::SAT));
     }
@@ -102,7 +103,8 @@ public:
 
     // Can't trivially prove sat/unsat, so we have to fuzz.
     // Collect the information we need to fuzz and start fuzz
-    auto fai = std::make_shared<FuzzingAnalysisInfo>();
+    auto fai =
+        std::make_shared<FuzzingAnalysisInfo>(interF->checksConstraintsByCost());
     QueryPassManager preprocessingPassses;
     {
       // Make the pass manager cancellable
@@ -121,13 +123,22 @@ public:
       cancellablePassManager = nullptr;
     }
 
+    // The analysis is incomplete if it was cancelled.
+    CHECK_CANCELLED()
+
     // Check for trivial SAT. This can happen if the query only consists
     // of equalities.
     if (qCopy.constraints.size() == 0) {
       // Empty constraint set is trivially satisifiable
-      assert(!produceModel && "producing models not implemented");
+      std::shared_ptr<Model> model;
+      if (produceModel) {
+        // Nothing is left in the buffer so the model only comes from the
+        // equalities and bounds that were extracted.
+        model = std::make_shared<BufferAssignmentModel>(*fai,
+                                                        std::vector<uint8_t>());
+      }
       return std::unique_ptr<SolverResponse>(
-          new TrivialFuzzingSolverResponse(SolverResponse::SAT));
+          new TrivialFuzzingSolverResponse(SolverResponse::SAT, model));
     }
 
     // Check if equalities simplified to false
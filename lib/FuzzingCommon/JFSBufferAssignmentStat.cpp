@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/FuzzingCommon/JFSBufferAssignmentStat.h"
+
+namespace jfs {
+namespace fuzzingCommon {
+
+JFSBufferAssignmentStat::JFSBufferAssignmentStat(llvm::StringRef name)
+    : jfs::support::JFSStat(BUFFER_ASSIGNMENT, name) {}
+JFSBufferAssignmentStat::~JFSBufferAssignmentStat() {}
+
+void JFSBufferAssignmentStat::printYAML(llvm::ScopedPrinter& sp) const {
+  sp.indent();
+  auto& os = sp.getOStream();
+  os << "\n";
+  sp.startLine() << "name: " << getName() << "\n";
+  sp.startLine() << "num_elements: " << numElements << "\n";
+  sp.startLine() << "width_in_bits: " << widthInBits << "\n";
+  sp.startLine() << "packed_width_in_bits: " << packedWidthInBits << "\n";
+  sp.startLine() << "num_dead_bits: " << numDeadBits << "\n";
+  sp.startLine() << "num_narrowed_elements: " << numNarrowedElements << "\n";
+  sp.startLine() << "num_narrowed_bits: " << numNarrowedBits << "\n";
+  sp.unindent();
+}
+}
+}
@@ -16,28 +16,68 @@
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <functional>
+#include <mutex>
+#include <signal.h>
+#include <spawn.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <vector>
 
+extern char** environ;
+
 namespace jfs {
 namespace fuzzingCommon {
 
 using namespace jfs::core;
 using namespace jfs::support;
 
+namespace {
+// The file descriptor of the socket connected to JFS in
+// `LLVMFuzzerJFSInProcessDriver` (see `FuzzerJFSInProcessMain.cpp`).
+const int inProcessDriverChannelFd = 3;
+
+bool sendAll(int fd, const uint8_t* data, size_t size) {
+  while (size > 0) {
+    // Don't raise SIGPIPE if the driver has exited.
+    ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+    if (sent < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    data += sent;
+    size -= sent;
+  }
+  return true;
+}
+}
+
 class LibFuzzerInvocationManagerImpl {
 private:
   JFSContext& ctx;
   static const int targetFoundExitCode = 77;
   static const int unitTimeoutExitCode = 88;
   static const int singleRunTargetNotFoundExitCode = 0;
+  // LibFuzzer exits normally when it reaches `-max_total_time`.
+  static const int timeLimitExitCode = 0;
   std::atomic<bool> cancelled;
   CancellableProcess proc;
+  std::mutex childPidMutex; // protects `childPid`
+  pid_t childPid;
 
 public:
   LibFuzzerInvocationManagerImpl(JFSContext& ctx)
-      : ctx(ctx), cancelled(false) {}
+      : ctx(ctx), cancelled(false), childPid(-1) {}
   ~LibFuzzerInvocationManagerImpl() {}
   void cancel() {
     IF_VERB(ctx,
@@ -45,6 +85,10 @@ public:
                 << "(LibFuzzerInvocationManager cancel called)\n");
     cancelled = true;
     proc.cancel();
+    std::lock_guard<std::mutex> lock(childPidMutex);
+    if (childPid > 0) {
+      kill(childPid, SIGKILL);
+    }
   }
 
   void writeSeed(const LibFuzzerOptions* options, uint8_t* start, size_t length,
@@ -78,98 +122,160 @@ public:
                 << " seed)\n");
   }
 
-  void setupSeeds(const LibFuzzerOptions* options) {
+  // Calls `handler` for each seed that should be added to the corpus.
+  void forEachSeed(const LibFuzzerOptions* options,
+                   std::function<void(uint8_t*, size_t, llvm::StringRef)>
+                       handler) {
     assert(options->maxLength > 0);
     std::unique_ptr<uint8_t, decltype(std::free)*> buffer(
         (uint8_t*)malloc(options->maxLength), std::free);
-    // TODO: We need to be smarter about how create seeds
-    // For certain variable types in the buffer we might want to consider
-    // special values (e.g. NaN/Inf/0 for Floats)
     if (options->addAllZeroMaxLengthSeed) {
-      // Create a seed in the corpus directory that's the maximum size
-      // all filled with zeros.
+      // Create a seed that's the maximum size all filled with zeros.
       memset(buffer.get(), 0, options->maxLength);
-      writeSeed(options, buffer.get(), options->maxLength, "zeroSeed");
+      handler(buffer.get(), options->maxLength, "zeroSeed");
     }
     if (options->addAllOneMaxLengthSeed) {
-      // Create a seed in the corpus directory that's the maximum size
-      // all filled with ones.
+      // Create a seed that's the maximum size all filled with ones.
       memset(buffer.get(), 0xff, options->maxLength);
-      writeSeed(options, buffer.get(), options->maxLength, "onesSeed");
+      handler(buffer.get(), options->maxLength, "onesSeed");
+    }
+    // Seeds provided by the solver (e.g. sort aware seeds).
+    for (size_t index = 0; index < options->extraSeeds.size(); ++index) {
+      std::vector<uint8_t> seed(options->extraSeeds[index]);
+      assert(seed.size() == options->maxLength);
+      std::string name = "extraSeed" + std::to_string(index);
+      handler(seed.data(), seed.size(), name);
     }
   }
-  std::unique_ptr<LibFuzzerResponse> fuzz(const LibFuzzerOptions* options,
-                                          llvm::StringRef stdOutFile,
-                                          llvm::StringRef stdErrFile) {
-    // TODO: Assert paths exist
-    std::vector<const char*> cmdLineArgs;
 
-    // If previous steps failed to perform complete constant folding
-    // then we might end up with an empty buffer. In that case we only
-    // we only need to run the program once to determine sat/unsat.
-    bool emptyBuffer = options->maxLength == 0;
+  void setupSeeds(const LibFuzzerOptions* options) {
+    forEachSeed(options,
+                [this, options](uint8_t* start, size_t length,
+                                llvm::StringRef name) {
+                  writeSeed(options, start, length, name);
+                });
+  }
 
+  // Append the arguments that are common to all the ways we run LibFuzzer.
+  void appendCommonArgs(const LibFuzzerOptions* options, bool emptyBuffer,
+                        std::vector<std::string>& args) {
     std::string underlyingString;
     llvm::raw_string_ostream ss(underlyingString);
 
-#define SET_ARG(NAME, X)                                                       \
+#define ADD_ARG(X)                                                             \
   ss << X;                                                                     \
-  std::string NAME(ss.str());                                                  \
-  cmdLineArgs.push_back(NAME.data());                                          \
+  args.push_back(ss.str());                                                    \
   underlyingString.clear();
 
-    // First arg must be fuzzing binary
-    assert(llvm::sys::fs::exists(options->targetBinary));
-    cmdLineArgs.push_back(options->targetBinary.data());
-
-    SET_ARG(numberOfRunsArgs, "-runs=" << (emptyBuffer ? "1" : "-1"));
+    ADD_ARG("-runs=" << (emptyBuffer ? "1" : "-1"));
 
     // Seed
-    SET_ARG(seedArg, "-seed=" << options->seed);
+    ADD_ARG("-seed=" << options->seed);
 
     // Mutation depth
-    SET_ARG(mutationDepthArg, "-mutate_depth=" << options->mutationDepth);
+    ADD_ARG("-mutate_depth=" << options->mutationDepth);
 
     // Crossover
-    SET_ARG(crossOverArg, "-cross_over=" << (options->crossOver ? "1" : "0"));
+    ADD_ARG("-cross_over=" << (options->crossOver ? "1" : "0"));
 
     // Max length
-    SET_ARG(maxLengthArg, "-max_len=" << options->maxLength);
+    ADD_ARG("-max_len=" << options->maxLength);
 
-    // Use trace comparison
-    SET_ARG(useCmpArg, "-use_cmp=" << (options->useCmp ? "1" : "0"));
+    // Time limit
+    if (options->maxTotalTime > 0) {
+      ADD_ARG("-max_total_time=" << options->maxTotalTime);
+    }
 
-    // handle SIGABRT
-    SET_ARG(handleSIGABRTArg,
-            "-handle_abrt=" << (options->handleSIGABRT ? "1" : "0"));
+    // Use trace comparison
+    ADD_ARG("-use_cmp=" << (options->useCmp ? "1" : "0"));
+
+    // Final stats
+    ADD_ARG("-print_final_stats=" << (options->printFinalStats ? "1" : "0"));
+
+    // Signal handlers
+    ADD_ARG("-handle_abrt=" << (options->handleSIGABRT ? "1" : "0"));
+    ADD_ARG("-handle_bus=" << (options->handleSIGBUS ? "1" : "0"));
+    ADD_ARG("-handle_fpe=" << (options->handleSIGFPE ? "1" : "0"));
+    ADD_ARG("-handle_ill=" << (options->handleSIGILL ? "1" : "0"));
+    ADD_ARG("-handle_int=" << (options->handleSIGINT ? "1" : "0"));
+    ADD_ARG("-handle_segv=" << (options->handleSIGSEGV ? "1" : "0"));
+    ADD_ARG("-handle_term=" << (options->handleSIGTERM ? "1" : "0"));
+    ADD_ARG("-handle_xfsz=" << (options->handleSIGXFSZ ? "1" : "0"));
+
+    // Dictionary
+    if (options->dictionaryFile.size() > 0) {
+      ADD_ARG("-dict=" << options->dictionaryFile);
+    }
+#undef ADD_ARG
 
-    // handle SIGBUS
-    SET_ARG(handleSIGBUSArg,
-            "-handle_bus=" << (options->handleSIGBUS ? "1" : "0"));
+    for (const auto& arg : options->targetArgs) {
+      assert(llvm::StringRef(arg).startswith("--") &&
+             "LibFuzzer would interpret argument");
+      args.push_back(arg);
+    }
+  }
 
-    // handle SIGFPE
-    SET_ARG(handleSIGFPEArg,
-            "-handle_fpe=" << (options->handleSIGFPE ? "1" : "0"));
+  // Populate `response` with the stats LibFuzzer wrote to `stdErrFile`.
+  void readFinalStats(const LibFuzzerOptions* options,
+                      llvm::StringRef stdErrFile,
+                      LibFuzzerResponse* response) {
+    if (!options->printFinalStats || stdErrFile.size() == 0)
+      return;
+    auto bufferOrError = llvm::MemoryBuffer::getFile(stdErrFile);
+    if (!bufferOrError) {
+      IF_VERB(ctx, ctx.getWarningStream()
+                       << "(warning failed to read LibFuzzer stats from \""
+                       << stdErrFile << "\")\n");
+      return;
+    }
+    llvm::StringRef contents = bufferOrError.get()->getBuffer();
+    auto readStat = [&contents](llvm::StringRef prefix, uint64_t& result) {
+      size_t index = contents.rfind(prefix);
+      if (index == llvm::StringRef::npos)
+        return;
+      llvm::StringRef value = contents.substr(index + prefix.size());
+      value = value.take_until([](char c) { return c == '\n'; }).trim();
+      uint64_t parsed = 0;
+      if (!value.getAsInteger(/*Radix=*/10, parsed)) {
+        result = parsed;
+      }
+    };
+    readStat("stat::number_of_executed_units:", response->numExecutedUnits);
+    readStat("stat::jfs_used_dict_entries:",
+             response->numUsedDictionaryEntries);
+  }
 
-    // handle SIGILL
-    SET_ARG(handleSIGILLArg,
-            "-handle_ill=" << (options->handleSIGILL ? "1" : "0"));
+  void printArgs(const std::vector<std::string>& args) {
+    if (ctx.getVerbosity() > 0) {
+      ctx.getDebugStream() << "(LibFuzzerInvocationManager\n[";
+      for (const auto& arg : args) {
+        ctx.getDebugStream() << "\"" << arg << "\", ";
+      }
+      ctx.getDebugStream() << "]\n)\n";
+    }
+  }
 
-    // handle SIGINT
-    SET_ARG(handleSIGIntArg,
-            "-handle_int=" << (options->handleSIGINT ? "1" : "0"));
+  std::unique_ptr<LibFuzzerResponse> fuzz(const LibFuzzerOptions* options,
+                                          llvm::StringRef stdOutFile,
+                                          llvm::StringRef stdErrFile) {
+    // TODO: Assert paths exist
+    std::vector<std::string> args;
+    if (cancelled) {
+      std::unique_ptr<LibFuzzerResponse> response(new LibFuzzerResponse());
+      response->outcome = LibFuzzerResponse::ResponseTy::CANCELLED;
+      return response;
+    }
 
-    // handle SIGSEGV
-    SET_ARG(handleSIGSEGVArg,
-            "-handle_segv=" << (options->handleSIGSEGV ? "1" : "0"));
+    // If previous steps failed to perform complete constant folding
+    // then we might end up with an empty buffer. In that case we only
+    // we only need to run the program once to determine sat/unsat.
+    bool emptyBuffer = options->maxLength == 0;
 
-    // handle SIGTERM
-    SET_ARG(handleSIGTERMArg,
-            "-handle_term=" << (options->handleSIGTERM ? "1" : "0"));
+    // First arg must be fuzzing binary
+    assert(llvm::sys::fs::exists(options->targetBinary));
+    args.push_back(options->targetBinary);
 
-    // handle SIGXFSZ
-    SET_ARG(handleSIGXFSZArg,
-            "-handle_xfsz=" << (options->handleSIGXFSZ ? "1" : "0"));
+    appendCommonArgs(options, emptyBuffer, args);
 
     // Artifact dir
     // TODO: Use Twine?
@@ -178,28 +284,24 @@ public:
     artifactPathWithSlash =
         llvm::sys::path::convert_to_slash(artifactPathWithSlash);
     assert(llvm::sys::fs::is_directory(artifactPathWithSlash));
-    SET_ARG(artifactArg, "-artifact_prefix=" << artifactPathWithSlash);
+    args.push_back("-artifact_prefix=" + artifactPathWithSlash);
 
     // Set exit codes. We use this to work out what the outcome was
-    SET_ARG(errorExitCodeArg, "-error_exitcode=" << targetFoundExitCode);
-    SET_ARG(unitTimeoutExitCodeArg,
-            "-timeout_exitcode=" << unitTimeoutExitCode);
+    args.push_back("-error_exitcode=" + std::to_string(targetFoundExitCode));
+    args.push_back("-timeout_exitcode=" + std::to_string(unitTimeoutExitCode));
 
     // Corpus directory
     assert(llvm::sys::fs::is_directory(options->corpusDir));
-    cmdLineArgs.push_back(options->corpusDir.data());
+    args.push_back(options->corpusDir);
 
-#undef SET_ARG
-    if (ctx.getVerbosity() > 0) {
-      ctx.getDebugStream() << "(LibFuzzerInvocationManager\n[";
-      for (const auto& arg : cmdLineArgs) {
-        ctx.getDebugStream() << "\"" << arg << "\", ";
-      }
-      ctx.getDebugStream() << "]\n)\n";
-    }
+    printArgs(args);
     std::unique_ptr<LibFuzzerResponse> response(new LibFuzzerResponse());
 
     // cmdLineArgs must be null terminated
+    std::vector<const char*> cmdLineArgs;
+    for (const auto& arg : args) {
+      cmdLineArgs.push_back(arg.c_str());
+    }
     cmdLineArgs.push_back(nullptr);
 
     // Redirects
@@ -219,6 +321,7 @@ public:
     // Invoke Fuzzer
     int exitCode = proc.execute(/*program=*/options->targetBinary,
                                 /*args=*/cmdLineArgs, /*redirects=*/redirects);
+    readFinalStats(options, stdErrFile, response.get());
 
     if (exitCode == -2) {
       response->outcome = LibFuzzerResponse::ResponseTy::CANCELLED;
@@ -229,6 +332,10 @@ public:
           LibFuzzerResponse::ResponseTy::SINGLE_RUN_TARGET_NOT_FOUND;
       return response;
     }
+    if (options->maxTotalTime > 0 && exitCode == timeLimitExitCode) {
+      response->outcome = LibFuzzerResponse::ResponseTy::UNKNOWN;
+      return response;
+    }
     if (exitCode != targetFoundExitCode) {
       ctx.getErrorStream() << "(error Unexpected exit code from LibFuzzer "
                            << exitCode << ")\n";
@@ -240,11 +347,187 @@ public:
     response->outcome = LibFuzzerResponse::ResponseTy::TARGET_FOUND;
     return response;
   }
+
+  std::unique_ptr<LibFuzzerResponse>
+  fuzzSharedObject(const LibFuzzerOptions* options, llvm::StringRef driver,
+                   llvm::StringRef stdOutFile, llvm::StringRef stdErrFile) {
+    std::unique_ptr<LibFuzzerResponse> response(new LibFuzzerResponse());
+    bool emptyBuffer = options->maxLength == 0;
+
+    // The driver takes the shared object followed by LibFuzzer's arguments.
+    // The seeds are handed over through a socket so the corpus directory is
+    // only needed when it is shared with other fuzzers.
+    assert(llvm::sys::fs::exists(options->targetBinary));
+    std::vector<std::string> args;
+    args.push_back(driver.str());
+    args.push_back(options->targetBinary);
+    appendCommonArgs(options, emptyBuffer, args);
+    if (options->corpusDir.size() > 0) {
+      assert(llvm::sys::fs::is_directory(options->corpusDir));
+      args.push_back(options->corpusDir);
+    }
+    printArgs(args);
+    std::vector<std::vector<uint8_t>> seeds;
+    if (!emptyBuffer) {
+      JFS_SM_TIMER(add_fuzzer_seeds, ctx);
+      forEachSeed(options, [&seeds](uint8_t* start, size_t length,
+                                    llvm::StringRef name) {
+        seeds.push_back(std::vector<uint8_t>(start, start + length));
+      });
+    }
+
+    if (cancelled) {
+      response->outcome = LibFuzzerResponse::ResponseTy::CANCELLED;
+      return response;
+    }
+
+    // Close-on-exec so that processes spawned concurrently by other threads
+    // don't keep the socket open.
+    int socketFds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, socketFds) != 0) {
+      ctx.getErrorStream() << "(error failed to create socket because "
+                           << strerror(errno) << ")\n";
+      return response;
+    }
+    // `dup2()` is a no-op (and leaves close-on-exec set) if the descriptor
+    // already has the number the driver expects so move it out of the way.
+    int driverFd =
+        fcntl(socketFds[1], F_DUPFD_CLOEXEC, inProcessDriverChannelFd + 1);
+    close(socketFds[1]);
+    if (driverFd == -1) {
+      ctx.getErrorStream() << "(error failed to duplicate socket because "
+                           << strerror(errno) << ")\n";
+      close(socketFds[0]);
+      return response;
+    }
+
+    posix_spawn_file_actions_t fileActions;
+    posix_spawn_file_actions_init(&fileActions);
+    posix_spawn_file_actions_addopen(&fileActions, STDIN_FILENO, "/dev/null",
+                                     O_RDONLY, 0);
+    std::string stdOutPath = stdOutFile.str();
+    std::string stdErrPath = stdErrFile.str();
+    if (stdOutPath.size() > 0) {
+      posix_spawn_file_actions_addopen(&fileActions, STDOUT_FILENO,
+                                       stdOutPath.c_str(),
+                                       O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    if (stdErrPath.size() > 0) {
+      posix_spawn_file_actions_addopen(&fileActions, STDERR_FILENO,
+                                       stdErrPath.c_str(),
+                                       O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    posix_spawn_file_actions_adddup2(&fileActions, driverFd,
+                                     inProcessDriverChannelFd);
+    std::vector<char*> argv;
+    for (const auto& arg : args) {
+      argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    pid_t pid = -1;
+    int spawnError = posix_spawn(&pid, args[0].c_str(), &fileActions,
+                                 /*attrp=*/nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&fileActions);
+    close(driverFd);
+    if (spawnError != 0) {
+      ctx.getErrorStream() << "(error failed to execute \"" << driver
+                           << "\" because " << strerror(spawnError) << ")\n";
+      close(socketFds[0]);
+      return response;
+    }
+    {
+      std::lock_guard<std::mutex> lock(childPidMutex);
+      childPid = pid;
+    }
+    if (cancelled) {
+      // `cancel()` might have been called before `childPid` was set.
+      kill(pid, SIGKILL);
+    }
+
+    // Send the seeds. If the driver exits early sending fails and the exit
+    // status is reported below.
+    for (const auto& seed : seeds) {
+      uint64_t size64 = seed.size();
+      if (!sendAll(socketFds[0], reinterpret_cast<uint8_t*>(&size64),
+                   sizeof(size64)) ||
+          !sendAll(socketFds[0], seed.data(), seed.size())) {
+        break;
+      }
+    }
+    shutdown(socketFds[0], SHUT_WR);
+
+    // Read until the driver closes its end of the socket (i.e. exits).
+    std::vector<uint8_t> received;
+    uint8_t readBuffer[4096];
+    while (true) {
+      ssize_t bytesRead = read(socketFds[0], readBuffer, sizeof(readBuffer));
+      if (bytesRead == 0)
+        break;
+      if (bytesRead < 0) {
+        if (errno == EINTR)
+          continue;
+        ctx.getErrorStream() << "(error failed to read from LibFuzzer because "
+                             << strerror(errno) << ")\n";
+        break;
+      }
+      received.insert(received.end(), readBuffer, readBuffer + bytesRead);
+    }
+    close(socketFds[0]);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {
+    }
+    {
+      std::lock_guard<std::mutex> lock(childPidMutex);
+      childPid = -1;
+    }
+    readFinalStats(options, stdErrFile, response.get());
+
+    // The driver writes the size of the input followed by the input.
+    uint64_t inputSize = 0;
+    if (received.size() >= sizeof(inputSize)) {
+      memcpy(&inputSize, received.data(), sizeof(inputSize));
+      if (received.size() - sizeof(inputSize) == inputSize) {
+        response->input.assign(received.begin() + sizeof(inputSize),
+                               received.end());
+        response->outcome = LibFuzzerResponse::ResponseTy::TARGET_FOUND;
+        return response;
+      }
+      ctx.getErrorStream() << "(error truncated input received from "
+                              "LibFuzzer)\n";
+      return response;
+    }
+    if (cancelled) {
+      response->outcome = LibFuzzerResponse::ResponseTy::CANCELLED;
+      return response;
+    }
+    bool exitedNormally = WIFEXITED(status);
+    int exitCode = exitedNormally ? WEXITSTATUS(status) : -1;
+    if (emptyBuffer && exitCode == singleRunTargetNotFoundExitCode) {
+      response->outcome =
+          LibFuzzerResponse::ResponseTy::SINGLE_RUN_TARGET_NOT_FOUND;
+      return response;
+    }
+    if (options->maxTotalTime > 0 && exitedNormally &&
+        exitCode == timeLimitExitCode) {
+      return response;
+    }
+    if (exitedNormally) {
+      ctx.getErrorStream() << "(error Unexpected exit code from LibFuzzer "
+                           << exitCode << ")\n";
+    } else if (WIFSIGNALED(status)) {
+      ctx.getErrorStream() << "(error LibFuzzer terminated by signal "
+                           << WTERMSIG(status) << ")\n";
+    }
+    return response;
+  }
 };
 
 // LibFuzzerResponse
 
-LibFuzzerResponse::LibFuzzerResponse() : outcome(ResponseTy::UNKNOWN) {}
+LibFuzzerResponse::LibFuzzerResponse()
+    : outcome(ResponseTy::UNKNOWN), numExecutedUnits(0),
+      numUsedDictionaryEntries(0) {}
 LibFuzzerResponse::~LibFuzzerResponse() {}
 
 // LibFuzzerInvocationManager
@@ -261,5 +544,11 @@ LibFuzzerInvocationManager::fuzz(const LibFuzzerOptions* options,
                                  llvm::StringRef stdErrFile) {
   return impl->fuzz(options, stdOutFile, stdErrFile);
 }
+
+std::unique_ptr<LibFuzzerResponse> LibFuzzerInvocationManager::fuzzSharedObject(
+    const LibFuzzerOptions* options, llvm::StringRef driver,
+    llvm::StringRef stdOutFile, llvm::StringRef stdErrFile) {
+  return impl->fuzzSharedObject(options, driver, stdOutFile, stdErrFile);
+}
 }
 }
@@ -14,10 +14,11 @@ namespace jfs {
 namespace fuzzingCommon {
 
 LibFuzzerOptions::LibFuzzerOptions()
-    : seed(1), mutationDepth(5), crossOver(true), maxLength(0), useCmp(false),
+    : seed(1), mutationDepth(5), crossOver(true), maxLength(0),
+      maxTotalTime(0), useCmp(false), printFinalStats(false),
       handleSIGABRT(true), handleSIGBUS(true), handleSIGFPE(true),
       handleSIGILL(true), handleSIGINT(true), handleSIGSEGV(true),
       handleSIGXFSZ(true), addAllZeroMaxLengthSeed(true),
-      addAllOneMaxLengthSeed(true) {}
+      addAllOneMaxLengthSeed(true), addSortAwareSeeds(true) {}
 }
 }
@@ -0,0 +1,240 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/FuzzingCommon/RelaxedModelSeedGenerator.h"
+#include "jfs/Core/IfVerbose.h"
+#include "jfs/Core/Z3NodeSet.h"
+#include "jfs/FuzzingCommon/SeedGenerator.h"
+#include "jfs/Z3Backend/Z3Solver.h"
+#include "jfs/Z3Backend/Z3SolverOptions.h"
+#include "llvm/ADT/APInt.h"
+#include <atomic>
+#include <list>
+#include <mutex>
+
+using namespace jfs::core;
+using namespace jfs::z3Backend;
+
+namespace {
+bool involvesFloatingPoint(Z3ASTHandle constraint) {
+  Z3ASTSet seen;
+  std::list<Z3ASTHandle> workList;
+  workList.push_back(constraint);
+  while (workList.size() > 0) {
+    Z3ASTHandle e = workList.front();
+    workList.pop_front();
+    if (!seen.insert(e).second)
+      continue;
+    if (!e.isApp())
+      continue;
+    Z3SortHandle sort = e.getSort();
+    if (sort.isFloatingPointTy() || sort.getKind() == Z3_ROUNDING_MODE_SORT)
+      return true;
+    Z3AppHandle app = e.asApp();
+    for (unsigned index = 0; index < app.getNumKids(); ++index) {
+      workList.push_back(app.getKid(index));
+    }
+  }
+  return false;
+}
+
+bool getBitVectorNumeral(Z3ASTHandle e, llvm::APInt& out) {
+  if (!e.isNumeral() || !e.getSort().isBitVectorTy())
+    return false;
+  llvm::StringRef str(::Z3_get_numeral_string(e.getContext(), e));
+  out = llvm::APInt(e.getSort().getBitVectorWidth(), str, /*radix=*/10);
+  return true;
+}
+
+bool getFloatingPointBits(Z3ASTHandle e, llvm::APInt& out) {
+  Z3SortHandle sort = e.getSort();
+  if (!e.isApp() || !sort.isFloatingPointTy())
+    return false;
+  const unsigned exponentBits = sort.getFloatingPointExponentBitWidth();
+  const unsigned storedBits = sort.getFloatingPointSignificandBitWidth() - 1;
+  const unsigned width = exponentBits + storedBits + 1;
+  const llvm::APInt sign = llvm::APInt::getOneBitSet(width, width - 1);
+  const llvm::APInt infinity =
+      llvm::APInt::getBitsSet(width, storedBits, storedBits + exponentBits);
+  Z3AppHandle app = e.asApp();
+  llvm::APInt signBits;
+  llvm::APInt exponent;
+  llvm::APInt significand;
+  switch (app.getKind()) {
+  case Z3_OP_FPA_PLUS_ZERO:
+    out = llvm::APInt::getNullValue(width);
+    return true;
+  case Z3_OP_FPA_MINUS_ZERO:
+    out = sign;
+    return true;
+  case Z3_OP_FPA_PLUS_INF:
+    out = infinity;
+    return true;
+  case Z3_OP_FPA_MINUS_INF:
+    out = infinity | sign;
+    return true;
+  case Z3_OP_FPA_NAN:
+    out = infinity | llvm::APInt::getOneBitSet(width, storedBits - 1);
+    return true;
+  case Z3_OP_FPA_FP:
+    assert(app.getNumKids() == 3);
+    if (!getBitVectorNumeral(app.getKid(0), signBits) ||
+        !getBitVectorNumeral(app.getKid(1), exponent) ||
+        !getBitVectorNumeral(app.getKid(2), significand))
+      return false;
+    break;
+  case Z3_OP_FPA_NUM: {
+    Z3_context z3Ctx = e.getContext();
+    if (!getBitVectorNumeral(
+            Z3ASTHandle(::Z3_fpa_get_numeral_sign_bv(z3Ctx, e), z3Ctx),
+            signBits) ||
+        !getBitVectorNumeral(
+            Z3ASTHandle(::Z3_fpa_get_numeral_exponent_bv(z3Ctx, e,
+                                                         /*biased=*/true),
+                        z3Ctx),
+            exponent) ||
+        !getBitVectorNumeral(
+            Z3ASTHandle(::Z3_fpa_get_numeral_significand_bv(z3Ctx, e), z3Ctx),
+            significand))
+      return false;
+    break;
+  }
+  default:
+    return false;
+  }
+  if (signBits.getBitWidth() != 1 || exponent.getBitWidth() != exponentBits ||
+      significand.getBitWidth() != storedBits)
+    return false;
+  out = signBits.zext(width).shl(width - 1) |
+        exponent.zext(width).shl(storedBits) | significand.zext(width);
+  return true;
+}
+
+bool getBits(Z3ASTHandle value, llvm::APInt& out) {
+  Z3SortHandle sort = value.getSort();
+  switch (sort.getKind()) {
+  case Z3_BOOL_SORT:
+    if (!value.isTrue() && !value.isFalse())
+      return false;
+    out = llvm::APInt(1, value.isTrue() ? 1 : 0);
+    return true;
+  case Z3_BV_SORT:
+    return getBitVectorNumeral(value, out);
+  case Z3_FLOATING_POINT_SORT:
+    return getFloatingPointBits(value, out);
+  default:
+    return false;
+  }
+}
+}
+
+namespace jfs {
+namespace fuzzingCommon {
+
+class RelaxedModelSeedGeneratorImpl {
+private:
+  JFSContext& ctx;
+  std::atomic<bool> cancelled;
+  std::mutex solverMutex;
+  Z3Solver* activeSolver;
+
+public:
+  RelaxedModelSeedGeneratorImpl(JFSContext& ctx)
+      : ctx(ctx), cancelled(false), activeSolver(nullptr) {}
+
+  void cancel() {
+    cancelled = true;
+    std::lock_guard<std::mutex> lock(solverMutex);
+    if (activeSolver)
+      activeSolver->cancel();
+  }
+
+  bool generate(const Query& q, const BufferAssignment& ba,
+                unsigned timeoutInMs, std::vector<uint8_t>& seed) {
+    Query relaxedQuery(ctx);
+    for (const auto& constraint : q.constraints) {
+      if (!involvesFloatingPoint(constraint))
+        relaxedQuery.constraints.push_back(constraint);
+    }
+    IF_VERB(ctx, ctx.getDebugStream()
+                     << "(RelaxedModelSeedGenerator kept "
+                     << relaxedQuery.constraints.size() << " of "
+                     << q.constraints.size() << " constraints)\n");
+    if (relaxedQuery.constraints.size() == 0)
+      return false;
+
+    std::unique_ptr<Z3SolverOptions> options(new Z3SolverOptions());
+    options->timeoutInMs = timeoutInMs;
+    Z3Solver solver(std::move(options), ctx);
+    {
+      std::lock_guard<std::mutex> lock(solverMutex);
+      if (cancelled)
+        return false;
+      activeSolver = &solver;
+    }
+    auto response = solver.solve(relaxedQuery, /*produceModel=*/true);
+    {
+      std::lock_guard<std::mutex> lock(solverMutex);
+      activeSolver = nullptr;
+    }
+    IF_VERB(ctx, ctx.getDebugStream()
+                     << "(RelaxedModelSeedGenerator relaxed query is "
+                     << SolverResponse::getSatString(response->sat) << ")\n");
+    if (response->sat != SolverResponse::SAT)
+      return false;
+
+    auto model = response->getModel();
+    assert(model);
+    seed.assign((ba.computeWidth() + 7) / 8, 0);
+    for (const auto& be : ba) {
+      llvm::APInt bits;
+      bool encoded = getBits(model->getAssignment(be.getDecl()), bits) &&
+                     bits.getBitWidth() == be.getSortBitWidth();
+      if (encoded && be.hasInterval()) {
+        // Only the offset into the interval is stored in the buffer. The
+        // bounds were removed from the query so the model might not respect
+        // them. Such values wrap around like offsets past the interval do.
+        const uint64_t span = be.getIntervalHigh() - be.getIntervalLow();
+        uint64_t offset = bits.getZExtValue() - be.getIntervalLow();
+        if (span != UINT64_MAX)
+          offset %= (span + 1);
+        bits = llvm::APInt(be.getBitWidth(), offset);
+      } else if (encoded && be.hasDeadBits()) {
+        // Only the live bits are stored in the buffer.
+        bits = bits.lshr(be.getLiveLowBit()).trunc(be.getBitWidth());
+      }
+      if (!encoded) {
+        IF_VERB(ctx, ctx.getWarningStream()
+                         << "(warning RelaxedModelSeedGenerator failed to "
+                            "encode assignment to "
+                         << be.getName() << ")\n");
+        return false;
+      }
+      writeBitsToSeed(seed, be.getBitOffset(), bits);
+    }
+    return true;
+  }
+};
+
+RelaxedModelSeedGenerator::RelaxedModelSeedGenerator(JFSContext& ctx)
+    : impl(new RelaxedModelSeedGeneratorImpl(ctx)) {}
+
+RelaxedModelSeedGenerator::~RelaxedModelSeedGenerator() {}
+
+void RelaxedModelSeedGenerator::cancel() { impl->cancel(); }
+
+bool RelaxedModelSeedGenerator::generate(const Query& q,
+                                         const BufferAssignment& ba,
+                                         unsigned timeoutInMs,
+                                         std::vector<uint8_t>& seed) {
+  return impl->generate(q, ba, timeoutInMs, seed);
+}
+}
+}
@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/FuzzingCommon/SeedGenerator.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/Support/ErrorHandling.h"
+#include <algorithm>
+#include <assert.h>
+#include <set>
+
+using namespace jfs::core;
+
+namespace {
+typedef std::vector<llvm::APInt> SpecialValuesTy;
+
+SpecialValuesTy getBitVectorSpecialValues(unsigned width) {
+  return {
+      llvm::APInt::getNullValue(width),      // zero
+      llvm::APInt(width, 1),                 // one
+      llvm::APInt::getSignedMinValue(width), // signed min
+      llvm::APInt::getSignedMaxValue(width), // signed max
+      llvm::APInt::getAllOnesValue(width),   // unsigned max (i.e. -1)
+  };
+}
+
+SpecialValuesTy getFloatingPointSpecialValues(unsigned exponentBits,
+                                              unsigned significandBits) {
+  // IEEE-754 layout: sign | exponent | significand (without hidden bit).
+  const unsigned width = exponentBits + significandBits;
+  const unsigned storedBits = significandBits - 1;
+  const llvm::APInt sign = llvm::APInt::getOneBitSet(width, width - 1);
+  const llvm::APInt exponentMask =
+      llvm::APInt::getBitsSet(width, storedBits, storedBits + exponentBits);
+  const llvm::APInt significandMask =
+      llvm::APInt::getLowBitsSet(width, storedBits);
+  const llvm::APInt minNormal = llvm::APInt::getOneBitSet(width, storedBits);
+  const llvm::APInt infinity = exponentMask;
+  const llvm::APInt nan =
+      infinity | llvm::APInt::getOneBitSet(width, storedBits - 1);
+  const llvm::APInt one =
+      llvm::APInt::getBitsSet(width, storedBits, storedBits + exponentBits - 1);
+  return {
+      llvm::APInt::getNullValue(width),             // +zero
+      sign,                                         // -zero
+      infinity,                                     // +infinity
+      infinity | sign,                              // -infinity
+      nan,                                          // NaN
+      llvm::APInt(width, 1),                        // min subnormal
+      significandMask,                              // max subnormal
+      minNormal,                                    // min normal
+      (exponentMask - minNormal) | significandMask, // max normal
+      one,                                          // one
+  };
+}
+
+SpecialValuesTy getSpecialValues(const jfs::fuzzingCommon::BufferElement& be) {
+  Z3SortHandle sort = be.getSort();
+  switch (sort.getKind()) {
+  case Z3_BOOL_SORT:
+    return {llvm::APInt(1, 0), llvm::APInt(1, 1)};
+  case Z3_BV_SORT:
+    // Special values of the bits stored in the buffer. These are what the
+    // constraints see when the variable has dead bits.
+    return getBitVectorSpecialValues(be.getBitWidth());
+  case Z3_FLOATING_POINT_SORT:
+    return getFloatingPointSpecialValues(
+        sort.getFloatingPointExponentBitWidth(),
+        sort.getFloatingPointSignificandBitWidth());
+  default:
+    llvm_unreachable("Unhandled sort");
+  }
+}
+}
+
+namespace jfs {
+namespace fuzzingCommon {
+
+SeedListTy generateSortAwareSeeds(const BufferAssignment& ba,
+                                  size_t maxNumSeeds) {
+  SeedListTy seeds;
+  if (ba.size() == 0 || maxNumSeeds == 0)
+    return seeds;
+
+  // The first special value of every sort is zero.
+  std::vector<SpecialValuesTy> specialValues;
+  std::vector<unsigned> bitOffsets;
+  size_t maxNumSpecialValues = 0;
+  for (const auto& be : ba) {
+    specialValues.push_back(getSpecialValues(be));
+    bitOffsets.push_back(be.getBitOffset());
+    maxNumSpecialValues =
+        std::max(maxNumSpecialValues, specialValues.back().size());
+  }
+  const size_t numBytes = (ba.computeWidth() + 7) / 8;
+
+  std::set<std::vector<uint8_t>> seen;
+  auto addSeed = [&](std::vector<uint8_t>& seed) {
+    if (seeds.size() < maxNumSeeds && seen.insert(seed).second)
+      seeds.push_back(seed);
+  };
+
+  // Every variable takes its n-th special value. This covers queries where
+  // several variables need to be special at the same time (e.g. `x + y` is
+  // NaN).
+  for (size_t n = 0; n < maxNumSpecialValues; ++n) {
+    std::vector<uint8_t> seed(numBytes, 0);
+    for (size_t index = 0; index < specialValues.size(); ++index) {
+      const SpecialValuesTy& values = specialValues[index];
+      writeBitsToSeed(seed, bitOffsets[index], values[n % values.size()]);
+    }
+    addSeed(seed);
+  }
+
+  // A single variable takes a special value and the rest are zero.
+  for (size_t index = 0; index < specialValues.size(); ++index) {
+    for (const auto& value : specialValues[index]) {
+      std::vector<uint8_t> seed(numBytes, 0);
+      writeBitsToSeed(seed, bitOffsets[index], value);
+      addSeed(seed);
+    }
+    if (seeds.size() >= maxNumSeeds)
+      break;
+  }
+  return seeds;
+}
+
+void writeBitsToSeed(std::vector<uint8_t>& seed, unsigned bitOffset,
+                     const llvm::APInt& value) {
+  for (unsigned index = 0; index < value.getBitWidth(); ++index) {
+    unsigned bit = bitOffset + index;
+    assert((bit / 8) < seed.size());
+    uint8_t mask = 1 << (bit % 8);
+    if (value[index])
+      seed[bit / 8] |= mask;
+    else
+      seed[bit / 8] &= ~mask;
+  }
+}
+}
+}
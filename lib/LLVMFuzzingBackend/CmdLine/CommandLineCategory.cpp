@@ -0,0 +1,22 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/LLVMFuzzingBackend/CmdLine/CommandLineCategory.h"
+
+namespace jfs {
+namespace llvmfb {
+namespace cl {
+
+llvm::cl::OptionCategory
+    CommandLineCategory("LLVMFuzzingBackend",
+                        "Options that control the LLVMFuzzingBackend");
+}
+}
+}
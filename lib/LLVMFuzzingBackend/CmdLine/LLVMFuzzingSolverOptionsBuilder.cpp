@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/LLVMFuzzingBackend/CmdLine/LLVMFuzzingSolverOptionsBuilder.h"
+#include "jfs/LLVMFuzzingBackend/CmdLine/CommandLineCategory.h"
+#include "llvm/Support/CommandLine.h"
+#include <algorithm>
+#include <string>
+
+using namespace jfs::llvmfb;
+
+namespace {
+llvm::cl::opt<unsigned> JITOptimizationLevel(
+    "jit-opt-level",
+    llvm::cl::desc("Optimization level (0-3) used before JIT compiling the "
+                   "program (default: 2)"),
+    llvm::cl::init(2), llvm::cl::cat(jfs::llvmfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> JITTraceComparisons(
+    "jit-trace-cmp",
+    llvm::cl::desc("Report the operands of bitvector comparisons to LibFuzzer "
+                   "(default: true)"),
+    llvm::cl::init(true), llvm::cl::cat(jfs::llvmfb::cl::CommandLineCategory));
+
+llvm::cl::opt<uint64_t> JITMaxRuns(
+    "jit-max-runs",
+    llvm::cl::desc("Maximum number of inputs the in-process fuzzer will try. "
+                   "0 means no limit (default: 0)"),
+    llvm::cl::init(0), llvm::cl::cat(jfs::llvmfb::cl::CommandLineCategory));
+
+llvm::cl::opt<std::string> JITRuntimeBitcode(
+    "jit-runtime-bitcode",
+    llvm::cl::desc("Path to the SMTLIB runtime bitcode. If not set it is "
+                   "inferred from the location of jfs"),
+    llvm::cl::init(""), llvm::cl::cat(jfs::llvmfb::cl::CommandLineCategory));
+
+llvm::cl::opt<std::string> JITLibFuzzerLib(
+    "jit-libfuzzer-lib",
+    llvm::cl::desc("Path to LibFuzzer built as a shared library. If not set "
+                   "it is inferred from the location of jfs"),
+    llvm::cl::init(""), llvm::cl::cat(jfs::llvmfb::cl::CommandLineCategory));
+}
+
+namespace jfs {
+namespace llvmfb {
+namespace cl {
+
+std::unique_ptr<LLVMFuzzingSolverOptions>
+buildLLVMFuzzingSolverOptionsFromCmdLine(
+    llvm::StringRef pathToExecutable,
+    std::unique_ptr<jfs::fuzzingCommon::LibFuzzerOptions> libFuzzerOptions) {
+  // Tell LLVMFuzzingSolverOptions to try and infer the runtime path
+  std::unique_ptr<LLVMFuzzingSolverOptions> options(
+      new LLVMFuzzingSolverOptions(pathToExecutable,
+                                   std::move(libFuzzerOptions)));
+  if (JITRuntimeBitcode.size() > 0) {
+    options->pathToRuntimeBitcode = JITRuntimeBitcode;
+  }
+  if (JITLibFuzzerLib.size() > 0) {
+    options->pathToLibFuzzerSharedLib = JITLibFuzzerLib;
+  }
+  options->optimizationLevel = std::min(JITOptimizationLevel.getValue(), 3U);
+  options->traceComparisons = JITTraceComparisons;
+  options->maxRuns = JITMaxRuns;
+  return options;
+}
+}
+}
+}
@@ -0,0 +1,281 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/LLVMFuzzingBackend/InProcessFuzzer.h"
+#include "jfs/Core/IfVerbose.h"
+#include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/raw_ostream.h"
+#include <assert.h>
+#include <atomic>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+
+using namespace jfs::core;
+using namespace jfs::fuzzingCommon;
+
+namespace {
+// The LibFuzzer interface. See `runtime/LibFuzzer/Fuzzer/FuzzerJFS.h`.
+typedef int (*UserCallbackTy)(const uint8_t* data, size_t size);
+typedef int (*FuzzFnTy)(int argc, char** argv, UserCallbackTy callback,
+                        FILE* output);
+typedef void (*StopFnTy)(void);
+typedef void (*AddSeedFnTy)(const uint8_t* data, size_t size);
+typedef void (*SetExtraCountersFnTy)(uint8_t* begin, uint8_t* end);
+// Values returned by `jfs_libfuzzer_fuzz()`.
+const int fuzzDone = 0;
+const int fuzzNoInterestingInputs = 2;
+}
+
+namespace jfs {
+namespace llvmfb {
+
+InProcessFuzzerResponse::InProcessFuzzerResponse()
+    : outcome(ResponseTy::CANCELLED), numRuns(0) {}
+
+InProcessFuzzerResponse::~InProcessFuzzerResponse() {}
+
+class InProcessFuzzerImpl;
+
+namespace {
+// LibFuzzer is a singleton and its callback has no user data so the fuzzer
+// being run is kept here.
+std::mutex activeFuzzerMutex; // protects `activeFuzzer` and LibFuzzer
+InProcessFuzzerImpl* activeFuzzer = nullptr;
+
+int testOneInputTrampoline(const uint8_t* data, size_t size);
+}
+
+class InProcessFuzzerImpl {
+private:
+  JFSContext& ctx;
+  std::atomic<bool> cancelled;
+  FuzzFnTy fuzzFn;
+  StopFnTy stopFn;
+  AddSeedFnTy addSeedFn;
+  SetExtraCountersFnTy setExtraCountersFn;
+  // Only valid during `fuzz()`.
+  JITManager::EntryPointTy activeEntryPoint;
+  InProcessFuzzerResponse* activeResponse;
+
+  void addSeed(const std::vector<uint8_t>& seed) {
+    addSeedFn(seed.data(), seed.size());
+  }
+
+public:
+  InProcessFuzzerImpl(JFSContext& ctx)
+      : ctx(ctx), cancelled(false), fuzzFn(nullptr), stopFn(nullptr),
+        addSeedFn(nullptr), setExtraCountersFn(nullptr),
+        activeEntryPoint(nullptr), activeResponse(nullptr) {}
+
+  void cancel() { cancelled = true; }
+
+  bool loadLibFuzzer(llvm::StringRef path) {
+    std::string errorMsg;
+    // Loaded permanently so the JIT resolves the SanitizerCoverage hooks
+    // called by the program to it.
+    if (llvm::sys::DynamicLibrary::LoadLibraryPermanently(path.str().c_str(),
+                                                          &errorMsg)) {
+      ctx.getErrorStream() << "(error failed to load LibFuzzer \"" << path
+                           << "\" because " << errorMsg << ")\n";
+      return false;
+    }
+#define LOAD_SYMBOL(VAR, NAME)                                                 \
+  VAR = reinterpret_cast<decltype(VAR)>(                                       \
+      llvm::sys::DynamicLibrary::SearchForAddressOfSymbol(NAME));              \
+  if (VAR == nullptr) {                                                        \
+    ctx.getErrorStream() << "(error failed to find \"" << NAME                 \
+                         << "\" in LibFuzzer \"" << path << "\")\n";           \
+    return false;                                                              \
+  }
+    LOAD_SYMBOL(fuzzFn, "jfs_libfuzzer_fuzz");
+    LOAD_SYMBOL(stopFn, "jfs_libfuzzer_stop");
+    LOAD_SYMBOL(addSeedFn, "jfs_libfuzzer_add_seed");
+    LOAD_SYMBOL(setExtraCountersFn, "jfs_libfuzzer_set_extra_counters");
+#undef LOAD_SYMBOL
+    return true;
+  }
+
+  int testOneInput(const uint8_t* data, size_t size) {
+    if (cancelled) {
+      stopFn();
+      return 0;
+    }
+    // LibFuzzer may run a few more inputs after being stopped.
+    if (activeResponse->outcome ==
+        InProcessFuzzerResponse::ResponseTy::TARGET_FOUND)
+      return 0;
+    ++(activeResponse->numRuns);
+    if (activeEntryPoint(data, size) != 0) {
+      activeResponse->outcome =
+          InProcessFuzzerResponse::ResponseTy::TARGET_FOUND;
+      activeResponse->input.assign(data, data + size);
+      stopFn();
+    }
+    // LibFuzzer requires the callback to return 0.
+    return 0;
+  }
+
+  std::unique_ptr<InProcessFuzzerResponse>
+  fuzz(JITManager::EntryPointTy entryPoint, uint8_t* extraCounters,
+       size_t numExtraCounters, const LibFuzzerOptions* options,
+       uint64_t maxRuns) {
+    std::unique_ptr<InProcessFuzzerResponse> response(
+        new InProcessFuzzerResponse());
+
+    // Cancellation is permanent.
+    if (cancelled) {
+      response->outcome = InProcessFuzzerResponse::ResponseTy::CANCELLED;
+      return response;
+    }
+
+    const size_t maxLength = options->maxLength;
+    if (maxLength == 0) {
+      // No free variables. Only a single run is needed.
+      ++(response->numRuns);
+      if (entryPoint(nullptr, 0) != 0) {
+        response->outcome = InProcessFuzzerResponse::ResponseTy::TARGET_FOUND;
+      } else {
+        response->outcome =
+            InProcessFuzzerResponse::ResponseTy::SINGLE_RUN_TARGET_NOT_FOUND;
+      }
+      return response;
+    }
+    assert(fuzzFn != nullptr && "LibFuzzer was not loaded");
+
+    std::vector<std::string> args;
+    {
+      std::string underlyingString;
+      llvm::raw_string_ostream ss(underlyingString);
+#define ADD_ARG(X)                                                             \
+  ss << X;                                                                     \
+  args.push_back(ss.str());                                                    \
+  underlyingString.clear();
+
+      // LibFuzzer uses argv[0] as its name.
+      ADD_ARG("jfs");
+      ADD_ARG("-runs=" << (maxRuns > 0 ? static_cast<int64_t>(maxRuns) : -1));
+      ADD_ARG("-seed=" << options->seed);
+      ADD_ARG("-mutate_depth=" << options->mutationDepth);
+      ADD_ARG("-cross_over=" << (options->crossOver ? "1" : "0"));
+      ADD_ARG("-max_len=" << options->maxLength);
+      if (options->maxTotalTime > 0) {
+        ADD_ARG("-max_total_time=" << options->maxTotalTime);
+      }
+      ADD_ARG("-use_cmp=" << (options->useCmp ? "1" : "0"));
+      ADD_ARG("-print_final_stats=" << (options->printFinalStats ? "1" : "0"));
+      // The memory used belongs to JFS too.
+      ADD_ARG("-rss_limit_mb=0");
+      if (options->dictionaryFile.size() > 0) {
+        ADD_ARG("-dict=" << options->dictionaryFile);
+      }
+#undef ADD_ARG
+    }
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+      argv.push_back(&(arg[0]));
+    }
+
+    // LibFuzzer's output is only interesting when debugging.
+    FILE* output = nullptr;
+    IF_VERB_GT(ctx, 1, output = stderr);
+    if (output == nullptr) {
+      output = fopen("/dev/null", "w");
+      if (output == nullptr)
+        output = stderr;
+    }
+
+    int result = fuzzDone;
+    {
+      std::lock_guard<std::mutex> lock(activeFuzzerMutex);
+      // Seeds
+      bool addedSeed = false;
+      if (options->addAllZeroMaxLengthSeed) {
+        addSeed(std::vector<uint8_t>(maxLength, 0x00));
+        addedSeed = true;
+      }
+      if (options->addAllOneMaxLengthSeed) {
+        addSeed(std::vector<uint8_t>(maxLength, 0xff));
+        addedSeed = true;
+      }
+      for (const auto& s : options->extraSeeds) {
+        assert(s.size() == maxLength);
+        addSeed(s);
+        addedSeed = true;
+      }
+      if (!addedSeed) {
+        addSeed(std::vector<uint8_t>(maxLength, 0x00));
+      }
+      if (numExtraCounters > 0) {
+        setExtraCountersFn(extraCounters, extraCounters + numExtraCounters);
+      }
+
+      assert(activeFuzzer == nullptr);
+      activeFuzzer = this;
+      activeEntryPoint = entryPoint;
+      activeResponse = response.get();
+      response->outcome = InProcessFuzzerResponse::ResponseTy::CANCELLED;
+      result = fuzzFn(argv.size(), argv.data(), testOneInputTrampoline, output);
+      activeFuzzer = nullptr;
+      activeEntryPoint = nullptr;
+      activeResponse = nullptr;
+    }
+    if (output != stderr)
+      fclose(output);
+
+    if (response->outcome ==
+        InProcessFuzzerResponse::ResponseTy::TARGET_FOUND)
+      return response;
+    if (result == fuzzNoInterestingInputs) {
+      ctx.getErrorStream() << "(error LibFuzzer found no inputs that give "
+                              "coverage)\n";
+      response->outcome = InProcessFuzzerResponse::ResponseTy::FUZZER_FAILED;
+    } else if (result != fuzzDone) {
+      ctx.getErrorStream() << "(error LibFuzzer failed with " << result
+                           << ")\n";
+      response->outcome = InProcessFuzzerResponse::ResponseTy::FUZZER_FAILED;
+    } else if (cancelled) {
+      response->outcome = InProcessFuzzerResponse::ResponseTy::CANCELLED;
+    } else {
+      response->outcome =
+          InProcessFuzzerResponse::ResponseTy::MAX_RUNS_REACHED;
+    }
+    return response;
+  }
+};
+
+namespace {
+int testOneInputTrampoline(const uint8_t* data, size_t size) {
+  assert(activeFuzzer != nullptr);
+  return activeFuzzer->testOneInput(data, size);
+}
+}
+
+InProcessFuzzer::InProcessFuzzer(JFSContext& ctx)
+    : impl(new InProcessFuzzerImpl(ctx)) {}
+
+InProcessFuzzer::~InProcessFuzzer() {}
+
+void InProcessFuzzer::cancel() { impl->cancel(); }
+
+bool InProcessFuzzer::loadLibFuzzer(llvm::StringRef path) {
+  return impl->loadLibFuzzer(path);
+}
+
+std::unique_ptr<InProcessFuzzerResponse>
+InProcessFuzzer::fuzz(JITManager::EntryPointTy entryPoint,
+                      uint8_t* extraCounters, size_t numExtraCounters,
+                      const LibFuzzerOptions* options, uint64_t maxRuns) {
+  return impl->fuzz(entryPoint, extraCounters, numExtraCounters, options,
+                    maxRuns);
+}
+}
+}
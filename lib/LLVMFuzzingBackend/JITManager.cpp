@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/LLVMFuzzingBackend/JITManager.h"
+#include "jfs/Core/IfVerbose.h"
+#include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/ExecutionEngine/JITSymbol.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
+#include "llvm/ExecutionEngine/Orc/LambdaResolver.h"
+#include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
+#include "llvm/ExecutionEngine/RTDyldMemoryManager.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Mangler.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#include <mutex>
+
+using namespace jfs::core;
+
+namespace {
+std::once_flag initializeNativeTargetFlag;
+}
+
+namespace jfs {
+namespace llvmfb {
+
+class JITManagerImpl {
+private:
+  typedef llvm::orc::RTDyldObjectLinkingLayer ObjectLayerTy;
+  typedef llvm::orc::IRCompileLayer<ObjectLayerTy, llvm::orc::SimpleCompiler>
+      CompileLayerTy;
+  JFSContext& ctx;
+  std::unique_ptr<llvm::TargetMachine> tm;
+  const llvm::DataLayout dl;
+  ObjectLayerTy objectLayer;
+  CompileLayerTy compileLayer;
+
+  static llvm::TargetMachine* makeTargetMachine() {
+    std::call_once(initializeNativeTargetFlag, []() {
+      llvm::InitializeNativeTarget();
+      llvm::InitializeNativeTargetAsmPrinter();
+      // Make symbols in the host process (e.g. libm) available to JIT'ed code.
+      llvm::sys::DynamicLibrary::LoadLibraryPermanently(nullptr);
+    });
+    return llvm::EngineBuilder().selectTarget();
+  }
+
+  void optimize(llvm::Module& module, unsigned optimizationLevel) {
+    llvm::PassManagerBuilder pmb;
+    pmb.OptLevel = optimizationLevel;
+    if (optimizationLevel > 0) {
+      // The runtime is internalized so inlining it into the entry point
+      // is where most of the benefit comes from.
+      pmb.Inliner = llvm::createFunctionInliningPass(
+          optimizationLevel, /*SizeOptLevel=*/0,
+          /*DisableInlineHotCallSite=*/false);
+    }
+    tm->adjustPassManager(pmb);
+    llvm::legacy::FunctionPassManager fpm(&module);
+    llvm::legacy::PassManager mpm;
+    pmb.populateFunctionPassManager(fpm);
+    pmb.populateModulePassManager(mpm);
+    // Remove runtime functions that are not used by the entry point.
+    mpm.add(llvm::createGlobalDCEPass());
+    fpm.doInitialization();
+    for (auto& f : module) {
+      fpm.run(f);
+    }
+    fpm.doFinalization();
+    mpm.run(module);
+  }
+
+public:
+  JITManagerImpl(JFSContext& ctx)
+      : ctx(ctx), tm(makeTargetMachine()), dl(tm->createDataLayout()),
+        objectLayer(
+            []() { return std::make_shared<llvm::SectionMemoryManager>(); }),
+        compileLayer(objectLayer, llvm::orc::SimpleCompiler(*tm)) {}
+
+  JITManager::EntryPointTy compile(std::unique_ptr<llvm::Module> module,
+                                   llvm::StringRef entryPointName,
+                                   unsigned optimizationLevel) {
+    module->setDataLayout(dl);
+    module->setTargetTriple(tm->getTargetTriple().str());
+    std::string errorMsg;
+    llvm::raw_string_ostream errorStream(errorMsg);
+    if (llvm::verifyModule(*module, &errorStream)) {
+      errorStream.flush();
+      ctx.getErrorStream() << "(error generated module is invalid: "
+                           << errorMsg << ")\n";
+      return nullptr;
+    }
+    optimize(*module, optimizationLevel);
+    if (ctx.getVerbosity() > 2) {
+      ctx.getDebugStream() << "(JITManager optimized module\n\n";
+      module->print(ctx.getDebugStream(), nullptr);
+      ctx.getDebugStream() << "\n)\n";
+    }
+
+    auto resolver = llvm::orc::createLambdaResolver(
+        [this](const std::string& name) {
+          if (auto sym = compileLayer.findSymbol(name, false))
+            return sym;
+          return llvm::JITSymbol(nullptr);
+        },
+        [](const std::string& name) {
+          if (auto symAddr =
+                  llvm::RTDyldMemoryManager::getSymbolAddressInProcess(name))
+            return llvm::JITSymbol(symAddr, llvm::JITSymbolFlags::Exported);
+          return llvm::JITSymbol(nullptr);
+        });
+    auto handleOrError =
+        compileLayer.addModule(std::move(module), std::move(resolver));
+    if (auto err = handleOrError.takeError()) {
+      ctx.getErrorStream() << "(error failed to JIT compile module because "
+                           << llvm::toString(std::move(err)) << ")\n";
+      return nullptr;
+    }
+
+    return reinterpret_cast<JITManager::EntryPointTy>(
+        getSymbolAddress(entryPointName));
+  }
+
+  void* getSymbolAddress(llvm::StringRef name) {
+    std::string mangledName;
+    llvm::raw_string_ostream mangledNameStream(mangledName);
+    llvm::Mangler::getNameWithPrefix(mangledNameStream, name, dl);
+    auto sym = compileLayer.findSymbol(mangledNameStream.str(),
+                                       /*ExportedSymbolsOnly=*/true);
+    if (!sym) {
+      ctx.getErrorStream() << "(error failed to find \"" << name
+                           << "\" in JIT compiled code)\n";
+      return nullptr;
+    }
+    auto addressOrError = sym.getAddress();
+    if (!addressOrError) {
+      ctx.getErrorStream() << "(error failed to materialize \"" << name
+                           << "\" because "
+                           << llvm::toString(addressOrError.takeError())
+                           << ")\n";
+      return nullptr;
+    }
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(*addressOrError));
+  }
+};
+
+JITManager::JITManager(JFSContext& ctx) : impl(new JITManagerImpl(ctx)) {}
+
+JITManager::~JITManager() {}
+
+JITManager::EntryPointTy
+JITManager::compile(std::unique_ptr<llvm::Module> module,
+                    llvm::StringRef entryPointName,
+                    unsigned optimizationLevel) {
+  return impl->compile(std::move(module), entryPointName, optimizationLevel);
+}
+
+void* JITManager::getSymbolAddress(llvm::StringRef name) {
+  return impl->getSymbolAddress(name);
+}
+}
+}
@@ -0,0 +1,310 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/LLVMFuzzingBackend/LLVMFuzzingSolver.h"
+#include "jfs/Core/IfVerbose.h"
+#include "jfs/Core/JFSTimerMacros.h"
+#include "jfs/FuzzingCommon/BufferAssignmentModel.h"
+#include "jfs/FuzzingCommon/SeedGenerator.h"
+#include "jfs/FuzzingCommon/SortConformanceCheckPass.h"
+#include "jfs/LLVMFuzzingBackend/InProcessFuzzer.h"
+#include "jfs/LLVMFuzzingBackend/JITManager.h"
+#include "jfs/LLVMFuzzingBackend/LLVMFuzzingSolverOptions.h"
+#include "jfs/LLVMFuzzingBackend/LLVMProgramBuilderPass.h"
+#include "jfs/Transform/QueryPass.h"
+#include "jfs/Transform/QueryPassManager.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+
+using namespace jfs::core;
+using namespace jfs::fuzzingCommon;
+using namespace jfs::transform;
+
+namespace jfs {
+namespace llvmfb {
+
+class LLVMFuzzingSolverResponse : public SolverResponse {
+private:
+  std::shared_ptr<Model> model;
+
+public:
+  LLVMFuzzingSolverResponse(SolverResponse::SolverSatisfiability sat)
+      : SolverResponse(sat) {}
+  LLVMFuzzingSolverResponse(SolverResponse::SolverSatisfiability sat,
+                            std::shared_ptr<Model> model)
+      : SolverResponse(sat), model(model) {}
+  std::shared_ptr<Model> getModel() override { return model; }
+};
+
+class LLVMFuzzingSolverImpl {
+  std::mutex cancellablePassesMutex; // protects `cancellablePasses`
+  std::unordered_set<jfs::transform::QueryPass*> cancellablePasses;
+  std::atomic<bool> cancelled;
+  JFSContext& ctx;
+  // Raw pointer because we don't own the storage.
+  LLVMFuzzingSolverOptions* options;
+  InProcessFuzzer fuzzer;
+
+public:
+  friend class LLVMFuzzingSolver;
+  LLVMFuzzingSolverImpl(JFSContext& ctx, LLVMFuzzingSolverOptions* options)
+      : cancelled(false), ctx(ctx), options(options), fuzzer(ctx) {
+    assert(this->options != nullptr);
+    // Check paths
+    bool pathsOkay = options->checkPaths(ctx);
+    if (!pathsOkay) {
+      ctx.raiseFatalError("Path to bitcode runtime or LibFuzzer does not exist");
+    }
+    if (!fuzzer.loadLibFuzzer(options->pathToLibFuzzerSharedLib)) {
+      ctx.raiseFatalError("Failed to load LibFuzzer");
+    }
+  }
+  ~LLVMFuzzingSolverImpl() {}
+
+  llvm::StringRef getName() { return "LLVMFuzzingSolver"; }
+  void cancel() {
+    cancelled = true;
+    // Cancel any active passes
+    {
+      std::lock_guard<std::mutex> lock(cancellablePassesMutex);
+      for (const auto& pass : cancellablePasses) {
+        pass->cancel();
+      }
+    }
+    // Cancel active fuzzing
+    fuzzer.cancel();
+  }
+
+  void runCancellablePass(Query& q, std::shared_ptr<QueryPass> p) {
+    QueryPassManager pm;
+    {
+      // Make the pass cancellable
+      std::lock_guard<std::mutex> lock(cancellablePassesMutex);
+      cancellablePasses.insert(p.get());
+      pm.add(p);
+    }
+    pm.run(q);
+    {
+      // The pass is done remove it from set of cancellable passes
+      std::lock_guard<std::mutex> lock(cancellablePassesMutex);
+      cancellablePasses.erase(p.get());
+    }
+  }
+
+  // FIXME: Should be const Query.
+  bool sortsAreSupported(Query& q) {
+    JFSContext& ctx = q.getContext();
+    auto p = std::make_shared<SortConformanceCheckPass>([&ctx](Z3SortHandle s) {
+      switch (s.getKind()) {
+      case Z3_BOOL_SORT: {
+        return true;
+      }
+      case Z3_BV_SORT: {
+        unsigned width = s.getBitVectorWidth();
+        if (width <= 64) {
+          return true;
+        }
+        // Too wide
+        IF_VERB(ctx,
+                ctx.getWarningStream()
+                    << "(BitVector width " << width << " not supported)\n");
+        return false;
+      }
+      case Z3_FLOATING_POINT_SORT: {
+        unsigned ebits = s.getFloatingPointExponentBitWidth();
+        unsigned sbits = s.getFloatingPointSignificandBitWidth();
+        if (ebits == 8 && sbits == 24) {
+          // Float32
+          return true;
+        } else if (ebits == 11 && sbits == 53) {
+          // Float64
+          return true;
+        }
+        return false;
+      }
+      case Z3_ROUNDING_MODE_SORT:
+        return true;
+      default: {
+        // Sort not supported
+        IF_VERB(ctx,
+                ctx.getWarningStream()
+                    << "(Sort \"" << s.toStr() << "\" not supported)\n");
+        return false;
+      }
+      }
+    });
+    runCancellablePass(q, p);
+    return p->predicateAlwaysHeld();
+  }
+
+  std::unique_ptr<llvm::Module> loadRuntime(llvm::LLVMContext& llvmCtx) {
+    auto bufferOrError =
+        llvm::MemoryBuffer::getFile(options->pathToRuntimeBitcode);
+    if (auto ec = bufferOrError.getError()) {
+      std::string msg;
+      llvm::raw_string_ostream ss(msg);
+      ss << "Failed to open bitcode runtime \""
+         << options->pathToRuntimeBitcode << "\" because " << ec.message();
+      ss.flush();
+      ctx.raiseFatalError(msg);
+      return nullptr;
+    }
+    auto moduleOrError =
+        llvm::parseBitcodeFile(bufferOrError.get()->getMemBufferRef(), llvmCtx);
+    if (!moduleOrError) {
+      std::string msg;
+      llvm::raw_string_ostream ss(msg);
+      ss << "Failed to parse bitcode runtime \""
+         << options->pathToRuntimeBitcode << "\" because "
+         << llvm::toString(moduleOrError.takeError());
+      ss.flush();
+      ctx.raiseFatalError(msg);
+      return nullptr;
+    }
+    return std::move(moduleOrError.get());
+  }
+
+  std::unique_ptr<jfs::core::SolverResponse>
+  fuzz(jfs::core::Query& q, bool produceModel,
+       std::shared_ptr<FuzzingAnalysisInfo> info) {
+    assert(ctx == q.getContext());
+#define CHECK_CANCELLED()                                                      \
+  if (cancelled) {                                                             \
+    IF_VERB(ctx, ctx.getDebugStream() << "(" << getName() << " cancelled)\n"); \
+    return std::unique_ptr<SolverResponse>(                                    \
+        new LLVMFuzzingSolverResponse(SolverResponse::UNKNOWN));               \
+  }
+
+    // Check types are supported
+    if (!sortsAreSupported(q)) {
+      IF_VERB(ctx, ctx.getDebugStream() << "(unsupported sorts)\n");
+      return std::unique_ptr<SolverResponse>(
+          new LLVMFuzzingSolverResponse(SolverResponse::UNKNOWN));
+    }
+
+    // Cancellation point
+    CHECK_CANCELLED();
+
+    // NOTE: `llvmCtx` must outlive `jit` and everything built from it.
+    llvm::LLVMContext llvmCtx;
+    JITManager jit(ctx);
+    JITManager::EntryPointTy entryPoint = nullptr;
+    uint8_t* extraCounters = nullptr;
+    size_t numExtraCounters = 0;
+    {
+      JFS_SM_TIMER(compile, ctx);
+      // Generate program
+      auto pbp = std::make_shared<LLVMProgramBuilderPass>(
+          info, loadRuntime(llvmCtx), ctx, options->traceComparisons);
+      runCancellablePass(q, pbp);
+
+      // Cancellation point
+      CHECK_CANCELLED();
+
+      entryPoint = jit.compile(pbp->takeModule(),
+                               LLVMProgramBuilderPass::getEntryPointName(),
+                               options->optimizationLevel);
+      if (entryPoint == nullptr) {
+        return std::unique_ptr<SolverResponse>(
+            new LLVMFuzzingSolverResponse(SolverResponse::UNKNOWN));
+      }
+      extraCounters = reinterpret_cast<uint8_t*>(
+          jit.getSymbolAddress(LLVMProgramBuilderPass::getExtraCountersName()));
+      if (extraCounters != nullptr) {
+        numExtraCounters = pbp->getNumExtraCounters();
+      }
+    }
+
+    // Cancellation point
+    CHECK_CANCELLED();
+
+    JFS_SM_TIMER(fuzz, ctx);
+    LibFuzzerOptions* lfo = options->getLibFuzzerOptions();
+    // FIXME: We've already computed this earlier so we should cache it
+    // somewhere.
+    lfo->maxLength =
+        (info->freeVariableAssignment->bufferAssignment->computeWidth() + 7) /
+        8;
+    lfo->useCmp = options->traceComparisons;
+    lfo->extraSeeds.clear();
+    if (lfo->addSortAwareSeeds && lfo->maxLength > 0) {
+      lfo->extraSeeds = generateSortAwareSeeds(
+          *(info->freeVariableAssignment->bufferAssignment));
+    }
+    auto fuzzingResponse = fuzzer.fuzz(entryPoint, extraCounters,
+                                       numExtraCounters, lfo, options->maxRuns);
+    IF_VERB(ctx, ctx.getDebugStream() << "(" << getName() << " executed "
+                                      << fuzzingResponse->numRuns
+                                      << " inputs)\n");
+
+    switch (fuzzingResponse->outcome) {
+    case InProcessFuzzerResponse::ResponseTy::MAX_RUNS_REACHED:
+    case InProcessFuzzerResponse::ResponseTy::CANCELLED:
+    case InProcessFuzzerResponse::ResponseTy::FUZZER_FAILED: {
+      return std::unique_ptr<SolverResponse>(
+          new LLVMFuzzingSolverResponse(SolverResponse::UNKNOWN));
+    }
+    case InProcessFuzzerResponse::ResponseTy::SINGLE_RUN_TARGET_NOT_FOUND: {
+      // Special case where the fuzzer only does a single run due to
+      // empty buffer.
+      return std::unique_ptr<SolverResponse>(
+          new LLVMFuzzingSolverResponse(SolverResponse::UNSAT));
+    }
+    case InProcessFuzzerResponse::ResponseTy::TARGET_FOUND: {
+      // Solution found
+      std::shared_ptr<Model> model;
+      if (produceModel) {
+        model = std::make_shared<BufferAssignmentModel>(
+            *info, fuzzingResponse->input);
+      }
+      return std::unique_ptr<SolverResponse>(
+          new LLVMFuzzingSolverResponse(SolverResponse::SAT, model));
+    }
+    default:
+      llvm_unreachable("Unhandled InProcessFuzzerResponse");
+    }
+    return nullptr;
+  }
+};
+
+LLVMFuzzingSolver::LLVMFuzzingSolver(
+    std::unique_ptr<LLVMFuzzingSolverOptions> options,
+    std::unique_ptr<WorkingDirectoryManager> wdm, JFSContext& ctx)
+    : jfs::fuzzingCommon::FuzzingSolver(std::move(options), std::move(wdm),
+                                        ctx),
+      impl(new LLVMFuzzingSolverImpl(
+          ctx, static_cast<LLVMFuzzingSolverOptions*>(this->options.get()))) {}
+
+LLVMFuzzingSolver::~LLVMFuzzingSolver() {}
+
+std::unique_ptr<jfs::core::SolverResponse>
+LLVMFuzzingSolver::fuzz(jfs::core::Query& q, bool produceModel,
+                        std::shared_ptr<FuzzingAnalysisInfo> info) {
+  return impl->fuzz(q, produceModel, info);
+}
+
+llvm::StringRef LLVMFuzzingSolver::getName() const {
+  return "LLVMFuzzingSolver";
+}
+
+void LLVMFuzzingSolver::cancel() {
+  // Call parent
+  FuzzingSolver::cancel();
+  // Notify implementation
+  impl->cancel();
+}
+}
+}
@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/LLVMFuzzingBackend/LLVMFuzzingSolverOptions.h"
+#include "jfs/Core/IfVerbose.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+
+namespace jfs {
+namespace llvmfb {
+
+LLVMFuzzingSolverOptions::LLVMFuzzingSolverOptions(
+    llvm::StringRef pathToExecutable,
+    std::unique_ptr<jfs::fuzzingCommon::LibFuzzerOptions> libFuzzerOpt)
+    : jfs::core::SolverOptions(LLVM_FUZZING_SOLVER_KIND),
+      libFuzzerOpt(std::move(libFuzzerOpt)), pathToRuntimeBitcode(""),
+      pathToLibFuzzerSharedLib(""), optimizationLevel(2), traceComparisons(true),
+      maxRuns(0) {
+  if (pathToExecutable.size() == 0)
+    return;
+  // Try to infer paths to the bitcode runtime and LibFuzzer
+  assert(llvm::sys::path::is_absolute(llvm::Twine(pathToExecutable)));
+  llvm::SmallVector<char, 256> mutablePath(pathToExecutable.begin(),
+                                           pathToExecutable.end());
+  // Remove "/bin/jfs"
+  llvm::sys::path::remove_filename(mutablePath);
+  llvm::sys::path::remove_filename(mutablePath);
+  llvm::sys::path::append(mutablePath, "runtime", "bitcode",
+                          "JFSSMTLIBRuntime.bc");
+  pathToRuntimeBitcode = std::string(mutablePath.data(), mutablePath.size());
+  // Remove "bitcode/JFSSMTLIBRuntime.bc"
+  llvm::sys::path::remove_filename(mutablePath);
+  llvm::sys::path::remove_filename(mutablePath);
+  // FIXME: This is linux specific
+  llvm::sys::path::append(mutablePath, "LibFuzzer_RelWithDebInfo", "Fuzzer",
+                          "libLLVMFuzzerJFSInProcess.so");
+  pathToLibFuzzerSharedLib =
+      std::string(mutablePath.data(), mutablePath.size());
+}
+
+void LLVMFuzzingSolverOptions::print(llvm::raw_ostream& os) const {
+  os << "pathToRuntimeBitcode: \"" << pathToRuntimeBitcode << "\"\n";
+  os << "pathToLibFuzzerSharedLib: \"" << pathToLibFuzzerSharedLib << "\"\n";
+  os << "optimizationLevel: " << optimizationLevel << "\n";
+  os << "traceComparisons: " << traceComparisons << "\n";
+  os << "maxRuns: " << maxRuns << "\n";
+}
+
+bool LLVMFuzzingSolverOptions::checkPaths(jfs::core::JFSContext& ctx) const {
+  if (!llvm::sys::fs::exists(pathToRuntimeBitcode)) {
+    IF_VERB(ctx, ctx.getWarningStream()
+                     << "(warning path to bitcode runtime \""
+                     << pathToRuntimeBitcode << "\" does not exist)\n");
+    return false;
+  }
+  if (!llvm::sys::fs::exists(pathToLibFuzzerSharedLib)) {
+    IF_VERB(ctx, ctx.getWarningStream()
+                     << "(warning path to LibFuzzer shared library \""
+                     << pathToLibFuzzerSharedLib << "\" does not exist)\n");
+    return false;
+  }
+  return true;
+}
+}
+}
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "jfs/LLVMFuzzingBackend/LLVMProgramBuilderPass.h"
+#include "LLVMProgramBuilderPassImpl.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+
+using namespace jfs::core;
+using namespace jfs::fuzzingCommon;
+
+namespace jfs {
+namespace llvmfb {
+
+LLVMProgramBuilderPass::LLVMProgramBuilderPass(
+    std::shared_ptr<FuzzingAnalysisInfo> info,
+    std::unique_ptr<llvm::Module> runtimeModule, JFSContext& ctx,
+    bool traceComparisons)
+    : impl(new LLVMProgramBuilderPassImpl(info, std::move(runtimeModule), ctx,
+                                          traceComparisons)) {}
+
+LLVMProgramBuilderPass::~LLVMProgramBuilderPass() {}
+
+llvm::StringRef LLVMProgramBuilderPass::getName() {
+  return "LLVMProgramBuilder";
+}
+
+llvm::StringRef LLVMProgramBuilderPass::getEntryPointName() {
+  return "jfs_jit_test_one_input";
+}
+
+llvm::StringRef LLVMProgramBuilderPass::getExtraCountersName() {
+  return "jfs_extra_counters";
+}
+
+unsigned LLVMProgramBuilderPass::getNumExtraCounters() const {
+  return impl->numExtraCounters;
+}
+
+std::unique_ptr<llvm::Module> LLVMProgramBuilderPass::takeModule() {
+  return std::move(impl->module);
+}
+
+bool LLVMProgramBuilderPass::run(Query& q) {
+  JFSContext& ctx = q.getContext();
+  impl->build(q);
+
+  // Print final result
+  if (ctx.getVerbosity() >= 2) {
+    ctx.getDebugStream() << "(" << getName() << "\n\n";
+    // Only print the entry point. The rest of the module is the runtime.
+    impl->entryPoint->print(ctx.getDebugStream());
+    ctx.getDebugStream() << "\n)\n";
+  }
+  return false;
+}
+}
+}
@@ -0,0 +1,1031 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "LLVMProgramBuilderPassImpl.h"
+#include "jfs/Core/Z3Node.h"
+#include "jfs/Core/Z3NodeMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/raw_ostream.h"
+#include <list>
+
+using namespace jfs::core;
+using namespace jfs::fuzzingCommon;
+
+namespace jfs {
+namespace llvmfb {
+
+LLVMProgramBuilderPassImpl::LLVMProgramBuilderPassImpl(
+    std::shared_ptr<FuzzingAnalysisInfo> info,
+    std::unique_ptr<llvm::Module> runtimeModule, JFSContext& ctx,
+    bool traceComparisons)
+    : ctx(ctx), module(std::move(runtimeModule)), info(info),
+      builder(module->getContext()), entryPoint(nullptr),
+      earlyExitBlock(nullptr), entryPointFirstArg(nullptr),
+      entryPointSecondArg(nullptr), numConstraintBranches(0),
+      traceComparisons(traceComparisons), extraCounters(nullptr),
+      numExtraCounters(0) {}
+
+llvm::Type* LLVMProgramBuilderPassImpl::getOrInsertTy(Z3SortHandle sort) {
+  switch (sort.getKind()) {
+  case Z3_BOOL_SORT:
+    return builder.getInt1Ty();
+  case Z3_BV_SORT:
+    assert(sort.getBitVectorWidth() <= 64 &&
+           "Support for wide bitvectors not implemented");
+    return builder.getInt64Ty();
+  case Z3_FLOATING_POINT_SORT: {
+    unsigned exponentBits = sort.getFloatingPointExponentBitWidth();
+    unsigned significandBits = sort.getFloatingPointSignificandBitWidth();
+    if (exponentBits == 8 && significandBits == 24)
+      return builder.getFloatTy();
+    if (exponentBits == 11 && significandBits == 53)
+      return builder.getDoubleTy();
+    llvm_unreachable("Unhandled floating point sort");
+  }
+  default:
+    llvm_unreachable("Unhandled sort");
+  }
+}
+
+llvm::Function* LLVMProgramBuilderPassImpl::buildEntryPoint() {
+  llvm::LLVMContext& llvmCtx = module->getContext();
+  // Mimic `int (const uint8_t* data, size_t size)`.
+  llvm::Type* sizeTy = module->getDataLayout().getIntPtrType(llvmCtx);
+  llvm::Type* argTys[] = {builder.getInt8PtrTy(), sizeTy};
+  auto fnTy = llvm::FunctionType::get(builder.getInt32Ty(), argTys,
+                                      /*isVarArg=*/false);
+  if (module->getFunction(LLVMProgramBuilderPass::getEntryPointName())) {
+    ctx.raiseFatalError("Bitcode runtime already defines the entry point");
+  }
+  auto fn = llvm::Function::Create(fnTy, llvm::Function::ExternalLinkage,
+                                   LLVMProgramBuilderPass::getEntryPointName(),
+                                   module.get());
+  auto argIt = fn->arg_begin();
+  entryPointFirstArg = &(*argIt);
+  entryPointFirstArg->setName("data");
+  ++argIt;
+  entryPointSecondArg = &(*argIt);
+  entryPointSecondArg->setName("size");
+
+  auto entryBlock = llvm::BasicBlock::Create(llvmCtx, "entry", fn);
+
+  // Setup early exit block
+  earlyExitBlock = llvm::BasicBlock::Create(llvmCtx, "early_exit", fn);
+  builder.SetInsertPoint(earlyExitBlock);
+  builder.CreateRet(builder.getInt32(0));
+
+  builder.SetInsertPoint(entryBlock);
+  return fn;
+}
+
+void LLVMProgramBuilderPassImpl::insertExtraCounters(unsigned numCounters) {
+  // LibFuzzer clears the extra counters a word at a time so the size is
+  // rounded up to a multiple of 8 bytes.
+  numExtraCounters = (numCounters + 7) & ~7U;
+  auto countersTy =
+      llvm::ArrayType::get(builder.getInt8Ty(), numExtraCounters);
+  if (module->getNamedValue(LLVMProgramBuilderPass::getExtraCountersName())) {
+    ctx.raiseFatalError("Bitcode runtime already defines the extra counters");
+  }
+  // Not internalized so that the counters can be found and handed to
+  // LibFuzzer once the module has been JIT compiled.
+  extraCounters = new llvm::GlobalVariable(
+      *module, countersTy, /*isConstant=*/false,
+      llvm::GlobalValue::ExternalLinkage,
+      llvm::ConstantAggregateZero::get(countersTy),
+      LLVMProgramBuilderPass::getExtraCountersName());
+  extraCounters->setAlignment(8);
+}
+
+void LLVMProgramBuilderPassImpl::setExtraCounter(unsigned index) {
+  assert(index < numExtraCounters);
+  builder.CreateStore(
+      builder.getInt8(1),
+      builder.CreateConstInBoundsGEP2_32(extraCounters->getValueType(),
+                                         extraCounters, 0, index));
+}
+
+void LLVMProgramBuilderPassImpl::traceComparison(llvm::Value* lhs,
+                                                 llvm::Value* rhs) {
+  if (!traceComparisons)
+    return;
+  // Tell LibFuzzer (when run with `-use_cmp`) the operands so it can try
+  // mutations that make them equal.
+  assert(lhs->getType()->isIntegerTy(64) && rhs->getType()->isIntegerTy(64));
+  auto hook = module->getOrInsertFunction(
+      "__sanitizer_cov_trace_cmp8",
+      llvm::FunctionType::get(builder.getVoidTy(),
+                              {builder.getInt64Ty(), builder.getInt64Ty()},
+                              /*isVarArg=*/false));
+  builder.CreateCall(hook, {lhs, rhs});
+}
+
+void LLVMProgramBuilderPassImpl::insertBufferSizeGuard() {
+  bufferWidthInBits =
+      info->freeVariableAssignment->bufferAssignment->computeWidth();
+  if (bufferWidthInBits == 0) {
+    return;
+  }
+  // Round up to the number of bytes needed
+  unsigned bufferWidthInBytes = (bufferWidthInBits + 7) / 8;
+  llvm::Value* tooSmall = builder.CreateICmpULT(
+      entryPointSecondArg,
+      llvm::ConstantInt::get(entryPointSecondArg->getType(),
+                             bufferWidthInBytes),
+      "buffer_too_small");
+  auto continueBlock = llvm::BasicBlock::Create(
+      module->getContext(), "buffer_size_ok", entryPoint);
+  builder.CreateCondBr(tooSmall, earlyExitBlock, continueBlock);
+  builder.SetInsertPoint(continueBlock);
+}
+
+void LLVMProgramBuilderPassImpl::insertFreeVariableConstruction() {
+  const BufferAssignment& ba =
+      *(info->freeVariableAssignment->bufferAssignment.get());
+
+  // Walk through free variables and construct IR to initialize them
+  // from the buffer.
+  for (const auto& be : ba) {
+    unsigned currentBufferBit = be.getBitOffset();
+    unsigned endBufferBit = (currentBufferBit + be.getBitWidth()) - 1;
+    llvm::Value* value = nullptr;
+    switch (be.getSort().getKind()) {
+    case Z3_BOOL_SORT: {
+      assert((endBufferBit - currentBufferBit + 1) <= 8);
+      llvm::Value* bits = callRuntime(
+          "jfs_nr_make_bitvector",
+          {entryPointFirstArg, entryPointSecondArg, getI64(currentBufferBit),
+           getI64(endBufferBit)});
+      value = builder.CreateICmpNE(bits, getI64(0));
+      break;
+    }
+    case Z3_BV_SORT: {
+      value = callRuntime("jfs_nr_make_bitvector",
+                          {entryPointFirstArg, entryPointSecondArg,
+                           getI64(currentBufferBit), getI64(endBufferBit)});
+      if (be.hasInterval()) {
+        // The buffer stores the offset into the interval. Offsets past the
+        // end of the interval wrap around.
+        const uint64_t span = be.getIntervalHigh() - be.getIntervalLow();
+        if ((span & (span + 1)) != 0)
+          value = builder.CreateURem(value, getI64(span + 1));
+        value = builder.CreateAdd(value, getI64(be.getIntervalLow()));
+      } else if (be.hasDeadBits()) {
+        // Only the live bits are in the buffer. The rest are zero.
+        value = builder.CreateShl(value, getI64(be.getLiveLowBit()));
+      }
+      break;
+    }
+    case Z3_FLOATING_POINT_SORT: {
+      value = callRuntime(
+          getFloatRuntimeFunctionName(be.getSort(), "make") + "_from_buffer",
+          {entryPointFirstArg, entryPointSecondArg, getI64(currentBufferBit)});
+      break;
+    }
+    default:
+      llvm_unreachable("Unhandled sort");
+    }
+    value->setName(be.getName());
+    insertValue(be.declApp, value);
+
+    // Add equalities
+    for (const auto& e : be.equalities) {
+      assert(e.isFreeVariable() && "should be free variable");
+      assert(e.getSort() == be.getSort() && "sorts don't match");
+      insertValue(e, value);
+    }
+  }
+}
+
+void LLVMProgramBuilderPassImpl::insertConstantAssignments() {
+  // FIXME: Due to constant propagation constant assignments should not be
+  // present. We probably should just remove this entirely.
+  const ConstantAssignment& ca =
+      *(info->freeVariableAssignment->constantAssignments);
+  for (const auto& keyPair : ca.assignments) {
+    Z3ASTHandle key = keyPair.first;
+    Z3ASTHandle constantExpr = keyPair.second;
+    assert(key.isFreeVariable());
+    assert(constantExpr.isConstant());
+    Z3AppHandle constantExprAsApp = constantExpr.asApp();
+    llvm::Value* value = nullptr;
+    switch (constantExprAsApp.getSort().getKind()) {
+    case Z3_BOOL_SORT:
+      value = getBoolConstant(constantExprAsApp);
+      break;
+    case Z3_BV_SORT:
+      value = getBitVectorConstant(constantExprAsApp);
+      break;
+    case Z3_FLOATING_POINT_SORT:
+      value = getFloatingPointConstant(constantExprAsApp);
+      break;
+    default:
+      llvm_unreachable("Unhandled sort");
+    }
+    insertValue(key, value);
+  }
+}
+
+void LLVMProgramBuilderPassImpl::insertBranchForConstraint(
+    Z3ASTHandle constraint) {
+  assert(constraint.getSort().isBoolTy());
+  // Construct all values needed to get the constraint as an `i1`.
+  doDFSPostOrderTraversal(constraint);
+  llvm::Value* condition = getValueFor(constraint);
+  ++numConstraintBranches;
+  auto satBlock = llvm::BasicBlock::Create(module->getContext(),
+                                           "constraint_sat", entryPoint);
+  builder.CreateCondBr(condition, satBlock, earlyExitBlock);
+  builder.SetInsertPoint(satBlock);
+  // Inputs that get further through the constraints are new coverage.
+  setExtraCounter(numConstraintBranches);
+}
+
+void LLVMProgramBuilderPassImpl::insertFuzzingTarget() {
+  // Unlike the CXXFuzzingBackend we don't `abort()`. The caller is in the
+  // same process so we just report that the target was reached.
+  builder.CreateRet(builder.getInt32(1));
+}
+
+void LLVMProgramBuilderPassImpl::internalizeRuntime() {
+  // Only the entry point needs to be visible. Making everything else
+  // internal lets the optimizer inline the runtime and throw away the parts
+  // we don't use.
+  for (auto& f : *module) {
+    if (&f == entryPoint || f.isDeclaration())
+      continue;
+    f.setLinkage(llvm::GlobalValue::InternalLinkage);
+  }
+  for (auto& gv : module->globals()) {
+    if (&gv == extraCounters || gv.isDeclaration())
+      continue;
+    gv.setLinkage(llvm::GlobalValue::InternalLinkage);
+  }
+}
+
+void LLVMProgramBuilderPassImpl::build(const Query& q) {
+  entryPoint = buildEntryPoint();
+  // One counter for reaching each constraint and one for getting past the
+  // last one.
+  insertExtraCounters(q.constraints.size() + 1);
+
+  insertBufferSizeGuard();
+  // Always set so LibFuzzer keeps at least one input in its corpus.
+  setExtraCounter(0);
+  insertFreeVariableConstruction();
+  insertConstantAssignments();
+
+  // Generate constraint branches
+  for (const auto& constraint : q.constraints) {
+    insertBranchForConstraint(constraint);
+  }
+  insertFuzzingTarget();
+  internalizeRuntime();
+}
+
+llvm::Function*
+LLVMProgramBuilderPassImpl::getRuntimeFunction(llvm::StringRef name) {
+  llvm::Function* f = module->getFunction(name);
+  if (f == nullptr || f->isDeclaration()) {
+    std::string msg;
+    llvm::raw_string_ostream ss(msg);
+    ss << "Bitcode runtime is missing definition of \"" << name << "\"";
+    ss.flush();
+    ctx.raiseFatalError(msg);
+  }
+  return f;
+}
+
+llvm::Value*
+LLVMProgramBuilderPassImpl::callRuntime(llvm::StringRef name,
+                                        llvm::ArrayRef<llvm::Value*> args) {
+  llvm::Function* f = getRuntimeFunction(name);
+  llvm::FunctionType* fTy = f->getFunctionType();
+  assert(fTy->getNumParams() == args.size() && "wrong number of arguments");
+  llvm::SmallVector<llvm::Value*, 4> coercedArgs;
+  for (unsigned index = 0; index < args.size(); ++index) {
+    llvm::Value* arg = args[index];
+    llvm::Type* paramTy = fTy->getParamType(index);
+    if (arg->getType() != paramTy) {
+      // Integer parameters (e.g. `size_t` vs `uint64_t`) might not match
+      // exactly between what we emit and what Clang emitted for the runtime.
+      assert(arg->getType()->isIntegerTy() && paramTy->isIntegerTy());
+      arg = builder.CreateZExtOrTrunc(arg, paramTy);
+    }
+    coercedArgs.push_back(arg);
+  }
+  llvm::CallInst* call = builder.CreateCall(f, coercedArgs);
+  // Keep the ABI attributes (e.g. `zeroext` on `bool`) Clang gave the callee.
+  call->setCallingConv(f->getCallingConv());
+  call->setAttributes(f->getAttributes());
+  return call;
+}
+
+llvm::StringRef
+LLVMProgramBuilderPassImpl::getFloatRuntimeFunctionPrefix(Z3SortHandle sort) {
+  assert(sort.isFloatingPointTy());
+  llvm::Type* ty = getOrInsertTy(sort);
+  if (ty->isFloatTy())
+    return "float32";
+  assert(ty->isDoubleTy());
+  return "float64";
+}
+
+std::string
+LLVMProgramBuilderPassImpl::getFloatRuntimeFunctionName(Z3SortHandle sort,
+                                                        llvm::StringRef stem) {
+  // Builds names of the form `jfs_nr_<stem>_float<N>` for `make` and
+  // `jfs_nr_float<N>_<stem>` for everything else.
+  std::string underlyingString;
+  llvm::raw_string_ostream ss(underlyingString);
+  if (stem == "make") {
+    ss << "jfs_nr_make_" << getFloatRuntimeFunctionPrefix(sort);
+  } else {
+    ss << "jfs_nr_" << getFloatRuntimeFunctionPrefix(sort) << "_" << stem;
+  }
+  return ss.str();
+}
+
+llvm::Value* LLVMProgramBuilderPassImpl::getI64(uint64_t value) {
+  return builder.getInt64(value);
+}
+
+llvm::Value* LLVMProgramBuilderPassImpl::getBitWidth(Z3ASTHandle e) {
+  Z3SortHandle sort = e.getSort();
+  assert(sort.isBitVectorTy());
+  return getI64(sort.getBitVectorWidth());
+}
+
+llvm::Value* LLVMProgramBuilderPassImpl::getBoolConstant(Z3AppHandle e) {
+  switch (e.getKind()) {
+  case Z3_OP_TRUE:
+    return builder.getTrue();
+  case Z3_OP_FALSE:
+    return builder.getFalse();
+  default:
+    llvm_unreachable("Unexpected expr");
+  }
+}
+
+llvm::Value* LLVMProgramBuilderPassImpl::getBitVectorConstant(Z3AppHandle e) {
+  assert(e.isConstant());
+  assert(e.getSort().isBitVectorTy());
+  assert(e.getSort().getBitVectorWidth() <= 64 &&
+         "Support for wide bitvectors not implemented");
+  uint64_t value = 0;
+  bool success = e.getConstantAsUInt64(&value);
+  assert(success && "Failed to get numeral value");
+  (void)success;
+  return getI64(value);
+}
+
+llvm::Value*
+LLVMProgramBuilderPassImpl::getFloatingPointConstant(Z3AppHandle e) {
+  auto sort = e.getSort();
+  assert(sort.isFloatingPointTy());
+  Z3ASTHandle signExpr;
+  Z3ASTHandle exponentExpr;
+  Z3ASTHandle significandExpr;
+  switch (e.getKind()) {
+  case Z3_OP_FPA_FP: {
+    // Non constant folded form with three kids
+    assert(e.getNumKids() == 3);
+    signExpr = e.getKid(0);
+    exponentExpr = e.getKid(1);
+    significandExpr = e.getKid(2);
+    break;
+  }
+  case Z3_OP_FPA_NUM: {
+    // Constant folded form with no kids
+    assert(e.getNumKids() == 0);
+    signExpr =
+        Z3ASTHandle(::Z3_fpa_get_numeral_sign_bv(e.getContext(), e.asAST()),
+                    e.getContext());
+    exponentExpr =
+        Z3ASTHandle(::Z3_fpa_get_numeral_exponent_bv(e.getContext(), e.asAST(),
+                                                     /*biased=*/true),
+                    e.getContext());
+    significandExpr = Z3ASTHandle(
+        ::Z3_fpa_get_numeral_significand_bv(e.getContext(), e.asAST()),
+        e.getContext());
+    break;
+  }
+  default:
+    llvm_unreachable("Unhandled floating point constant kind");
+  }
+  assert(signExpr.isConstant() && signExpr.isApp());
+  assert(exponentExpr.isConstant() && exponentExpr.isApp());
+  assert(significandExpr.isConstant() && significandExpr.isApp());
+  return callRuntime(getFloatRuntimeFunctionName(sort, "make") + "_from_triple",
+                     {getBitVectorConstant(signExpr.asApp()),
+                      getBitVectorConstant(exponentExpr.asApp()),
+                      getBitVectorConstant(significandExpr.asApp())});
+}
+
+void LLVMProgramBuilderPassImpl::insertValue(Z3ASTHandle e, llvm::Value* v) {
+  assert(!(e.isNull()));
+  assert(v->getType() == getOrInsertTy(e.getSort()) && "wrong type");
+  auto statusPair = exprToValue.insert(std::make_pair(e, v));
+  assert(statusPair.second && "expr already has value");
+  (void)statusPair;
+}
+
+bool LLVMProgramBuilderPassImpl::hasBeenVisited(Z3ASTHandle e) const {
+  return exprToValue.count(e) > 0;
+}
+
+bool LLVMProgramBuilderPassImpl::shouldTraverseNode(Z3ASTHandle e) const {
+  if (!e.isApp())
+    return true;
+
+  switch (e.asApp().getKind()) {
+  case Z3_OP_FPA_RM_NEAREST_TIES_TO_EVEN:
+  case Z3_OP_FPA_RM_NEAREST_TIES_TO_AWAY:
+  case Z3_OP_FPA_RM_TOWARD_POSITIVE:
+  case Z3_OP_FPA_RM_TOWARD_NEGATIVE:
+  case Z3_OP_FPA_RM_TOWARD_ZERO:
+    // Do not visit rounding modes
+    return false;
+  default:
+    return true;
+  }
+}
+
+void LLVMProgramBuilderPassImpl::doDFSPostOrderTraversal(Z3ASTHandle e) {
+  // Do post-order DFS traversal. We do this non-recursively to avoid
+  // hitting any recursion bounds.
+  std::list<Z3ASTHandle> queue;
+  // Used to keep track of when we examine a node with children
+  // for a second time. This indicates that the children have been
+  // travsersed so that we can now do the "post order" visit
+  std::list<Z3ASTHandle> traversingBackUpQueue;
+  queue.push_front(e);
+  while (queue.size() > 0) {
+    Z3ASTHandle node = queue.front();
+    assert(node.isApp());
+
+    // Check for leaf node
+    if (node.asApp().getNumKids() == 0) {
+      queue.pop_front();
+      // Do "post order" visit
+      if (!hasBeenVisited(node) && shouldTraverseNode(node)) {
+        visit(node);
+      }
+      continue;
+    }
+
+    // Must be an internal node
+    if (!traversingBackUpQueue.empty() &&
+        traversingBackUpQueue.front() == node) {
+      // We are visiting the node for a second time. Do "post order" visit
+      queue.pop_front();
+      traversingBackUpQueue.pop_front();
+      if (!hasBeenVisited(node) && shouldTraverseNode(node)) {
+        visit(node);
+      }
+      continue;
+    }
+    // Visit an internal node for the first time. Add the children to the front
+    // of the queue but don't pop this node from the stack so we can visit it a
+    // second time when are walking back up the tree.
+    traversingBackUpQueue.push_front(node);
+    Z3AppHandle nodeAsApp = node.asApp();
+    const unsigned numKids = nodeAsApp.getNumKids();
+    for (unsigned index = 0; index < numKids; ++index) {
+      // Add the operands from right to left so that they popped
+      // off in left to right order
+      Z3ASTHandle childExpr = nodeAsApp.getKid((numKids - 1) - index);
+      if (!hasBeenVisited(childExpr) && shouldTraverseNode(node)) {
+        queue.push_front(childExpr);
+      }
+    }
+  }
+  assert(traversingBackUpQueue.size() == 0);
+}
+
+llvm::Value* LLVMProgramBuilderPassImpl::getValueFor(Z3ASTHandle e) const {
+  // Due to the post order DFS traversal the abort should never be called
+  // unless there's a bug in the DFS traversal or visitor methods.
+  auto it = exprToValue.find(e);
+  if (it == exprToValue.end()) {
+    ctx.getErrorStream()
+        << "(error attempt to use value before it has been defined)\n";
+    abort();
+  }
+  return it->second;
+}
+
+llvm::Value* LLVMProgramBuilderPassImpl::getRoundingMode(Z3AppHandle rm) {
+  // These must match `JFS_NR_RM` in `SMTLIB/NativeFloat.h`.
+  switch (rm.getKind()) {
+  case Z3_OP_FPA_RM_NEAREST_TIES_TO_EVEN:
+    return builder.getInt32(0);
+  case Z3_OP_FPA_RM_NEAREST_TIES_TO_AWAY:
+    return builder.getInt32(1);
+  case Z3_OP_FPA_RM_TOWARD_POSITIVE:
+    return builder.getInt32(2);
+  case Z3_OP_FPA_RM_TOWARD_NEGATIVE:
+    return builder.getInt32(3);
+  case Z3_OP_FPA_RM_TOWARD_ZERO:
+    return builder.getInt32(4);
+  default:
+    llvm_unreachable("Unhandled argument");
+  }
+}
+
+// Visitor methods
+void LLVMProgramBuilderPassImpl::visitUninterpretedFunc(Z3AppHandle e) {
+  auto eAsStr = e.toStr();
+  ctx.getErrorStream() << "(error Unhandled uninterpreted function \""
+                       << eAsStr << "\")\n";
+  abort();
+}
+
+void LLVMProgramBuilderPassImpl::visitEqual(Z3AppHandle e) {
+  assert(e.getNumKids() == 2);
+  auto arg0 = e.getKid(0);
+  auto arg1 = e.getKid(1);
+  if (arg0.getSort().isFloatingPointTy()) {
+    insertValue(e.asAST(),
+                callRuntime(getFloatRuntimeFunctionName(arg0.getSort(),
+                                                        "smtlib_equals"),
+                            {getValueFor(arg0), getValueFor(arg1)}));
+    return;
+  }
+  if (arg0.getSort().isBitVectorTy())
+    traceComparison(getValueFor(arg0), getValueFor(arg1));
+  insertValue(e.asAST(),
+              builder.CreateICmpEQ(getValueFor(arg0), getValueFor(arg1)));
+}
+
+void LLVMProgramBuilderPassImpl::visitDistinct(Z3AppHandle e) {
+  const unsigned numArgs = e.getNumKids();
+  assert(numArgs >= 2);
+  // Pairwise `!=` combinations.
+  llvm::Value* result = nullptr;
+  for (unsigned firstArgIndex = 0; firstArgIndex < numArgs; ++firstArgIndex) {
+    for (unsigned secondArgIndex = firstArgIndex + 1; secondArgIndex < numArgs;
+         ++secondArgIndex) {
+      auto arg0 = e.getKid(firstArgIndex);
+      auto arg1 = e.getKid(secondArgIndex);
+      llvm::Value* notEqual = nullptr;
+      if (arg0.getSort().isFloatingPointTy()) {
+        notEqual = builder.CreateNot(
+            callRuntime(getFloatRuntimeFunctionName(arg0.getSort(),
+                                                    "smtlib_equals"),
+                        {getValueFor(arg0), getValueFor(arg1)}));
+      } else {
+        if (arg0.getSort().isBitVectorTy())
+          traceComparison(getValueFor(arg0), getValueFor(arg1));
+        notEqual = builder.CreateICmpNE(getValueFor(arg0), getValueFor(arg1));
+      }
+      result = result ? builder.CreateAnd(result, notEqual) : notEqual;
+    }
+  }
+  insertValue(e.asAST(), result);
+}
+
+void LLVMProgramBuilderPassImpl::visitIfThenElse(Z3AppHandle e) {
+  assert(e.getNumKids() == 3);
+  insertValue(e.asAST(), builder.CreateSelect(getValueFor(e.getKid(0)),
+                                              getValueFor(e.getKid(1)),
+                                              getValueFor(e.getKid(2))));
+}
+
+void LLVMProgramBuilderPassImpl::visitImplies(Z3AppHandle e) {
+  assert(e.getNumKids() == 2);
+  // (a => b) === (!a) | b
+  insertValue(e.asAST(),
+              builder.CreateOr(builder.CreateNot(getValueFor(e.getKid(0))),
+                               getValueFor(e.getKid(1))));
+}
+
+void LLVMProgramBuilderPassImpl::visitIff(Z3AppHandle e) {
+  assert(e.getNumKids() == 2);
+  // (a <=> b) === (a == b)
+  insertValue(e.asAST(), builder.CreateICmpEQ(getValueFor(e.getKid(0)),
+                                              getValueFor(e.getKid(1))));
+}
+
+void LLVMProgramBuilderPassImpl::visitAnd(Z3AppHandle e) {
+  const unsigned numArgs = e.getNumKids();
+  assert(numArgs >= 2);
+  llvm::Value* result = getValueFor(e.getKid(0));
+  for (unsigned index = 1; index < numArgs; ++index) {
+    result = builder.CreateAnd(result, getValueFor(e.getKid(index)));
+  }
+  insertValue(e.asAST(), result);
+}
+
+void LLVMProgramBuilderPassImpl::visitOr(Z3AppHandle e) {
+  const unsigned numArgs = e.getNumKids();
+  assert(numArgs >= 2);
+  llvm::Value* result = getValueFor(e.getKid(0));
+  for (unsigned index = 1; index < numArgs; ++index) {
+    result = builder.CreateOr(result, getValueFor(e.getKid(index)));
+  }
+  insertValue(e.asAST(), result);
+}
+
+void LLVMProgramBuilderPassImpl::visitXor(Z3AppHandle e) {
+  assert(e.getNumKids() == 2);
+  insertValue(e.asAST(), builder.CreateXor(getValueFor(e.getKid(0)),
+                                           getValueFor(e.getKid(1))));
+}
+
+void LLVMProgramBuilderPassImpl::visitNot(Z3AppHandle e) {
+  assert(e.getNumKids() == 1);
+  insertValue(e.asAST(), builder.CreateNot(getValueFor(e.getKid(0))));
+}
+
+void LLVMProgramBuilderPassImpl::visitBvBinOp(Z3AppHandle e,
+                                              llvm::StringRef runtimeName) {
+  assert(e.getNumKids() == 2);
+  auto arg0 = e.getKid(0);
+  auto arg1 = e.getKid(1);
+  insertValue(e.asAST(),
+              callRuntime(runtimeName, {getValueFor(arg0), getValueFor(arg1),
+                                        getBitWidth(arg0)}));
+}
+
+void LLVMProgramBuilderPassImpl::visitBvCmpOp(Z3AppHandle e,
+                                              llvm::StringRef runtimeName) {
+  assert(e.getNumKids() == 2);
+  traceComparison(getValueFor(e.getKid(0)), getValueFor(e.getKid(1)));
+  visitBvBinOp(e, runtimeName);
+}
+
+void LLVMProgramBuilderPassImpl::visitBvNaryOp(Z3AppHandle e,
+                                               llvm::StringRef runtimeName) {
+  // Even though in SMT-LIBv2 these ops are binary Z3 allows n-ary versions
+  // which could be introduced by its simplication steps. We assume these
+  // operations are associative so it doesn't matter the order we apply them
+  // in.
+  const unsigned numArgs = e.getNumKids();
+  assert(numArgs >= 2);
+  auto arg0 = e.getKid(0);
+  llvm::Value* bitWidth = getBitWidth(arg0);
+  llvm::Value* result = getValueFor(arg0);
+  for (unsigned index = 1; index < numArgs; ++index) {
+    result = callRuntime(runtimeName,
+                         {result, getValueFor(e.getKid(index)), bitWidth});
+  }
+  insertValue(e.asAST(), result);
+}
+
+#define BV_UNARY_OP(NAME, RUNTIME_NAME)                                        \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    assert(e.getNumKids() == 1);                                               \
+    auto arg0 = e.getKid(0);                                                   \
+    insertValue(e.asAST(), callRuntime(#RUNTIME_NAME, {getValueFor(arg0),      \
+                                                       getBitWidth(arg0)}));   \
+  }
+BV_UNARY_OP(visitBvNeg, jfs_nr_bvneg)
+BV_UNARY_OP(visitBvNot, jfs_nr_bvnot)
+#undef BV_UNARY_OP
+
+#define BV_BIN_OP(NAME, RUNTIME_NAME)                                          \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    visitBvBinOp(e, #RUNTIME_NAME);                                            \
+  }
+BV_BIN_OP(visitBvSub, jfs_nr_bvsub)
+BV_BIN_OP(visitBvSDiv, jfs_nr_bvsdiv)
+BV_BIN_OP(visitBvUDiv, jfs_nr_bvudiv)
+BV_BIN_OP(visitBvSRem, jfs_nr_bvsrem)
+BV_BIN_OP(visitBvURem, jfs_nr_bvurem)
+BV_BIN_OP(visitBvSMod, jfs_nr_bvsmod)
+BV_BIN_OP(visitBvNand, jfs_nr_bvnand)
+BV_BIN_OP(visitBvNor, jfs_nr_bvnor)
+BV_BIN_OP(visitBvXnor, jfs_nr_bvxnor)
+BV_BIN_OP(visitBvShl, jfs_nr_bvshl)
+BV_BIN_OP(visitBvLShr, jfs_nr_bvlshr)
+BV_BIN_OP(visitBvAShr, jfs_nr_bvashr)
+#undef BV_BIN_OP
+
+#define BV_CMP_OP(NAME, RUNTIME_NAME)                                          \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    visitBvCmpOp(e, #RUNTIME_NAME);                                            \
+  }
+BV_CMP_OP(visitBvULE, jfs_nr_bvule)
+BV_CMP_OP(visitBvSLE, jfs_nr_bvsle)
+BV_CMP_OP(visitBvUGE, jfs_nr_bvuge)
+BV_CMP_OP(visitBvSGE, jfs_nr_bvsge)
+BV_CMP_OP(visitBvULT, jfs_nr_bvult)
+BV_CMP_OP(visitBvSLT, jfs_nr_bvslt)
+BV_CMP_OP(visitBvUGT, jfs_nr_bvugt)
+BV_CMP_OP(visitBvSGT, jfs_nr_bvsgt)
+#undef BV_CMP_OP
+
+#define BV_NARY_OP(NAME, RUNTIME_NAME)                                         \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    visitBvNaryOp(e, #RUNTIME_NAME);                                           \
+  }
+BV_NARY_OP(visitBvOr, jfs_nr_bvor)
+BV_NARY_OP(visitBvAnd, jfs_nr_bvand)
+BV_NARY_OP(visitBvXor, jfs_nr_bvxor)
+BV_NARY_OP(visitBvAdd, jfs_nr_bvadd)
+BV_NARY_OP(visitBvMul, jfs_nr_bvmul)
+#undef BV_NARY_OP
+
+void LLVMProgramBuilderPassImpl::visitBvComp(Z3AppHandle e) {
+  assert(e.getNumKids() == 2);
+  // Produces a BitVector<1>
+  traceComparison(getValueFor(e.getKid(0)), getValueFor(e.getKid(1)));
+  llvm::Value* equal =
+      builder.CreateICmpEQ(getValueFor(e.getKid(0)), getValueFor(e.getKid(1)));
+  insertValue(e.asAST(), builder.CreateZExt(equal, builder.getInt64Ty()));
+}
+
+#define BV_ROTATE_OP(NAME, RUNTIME_NAME)                                       \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    /* The rotation amount is not an argument */                               \
+    assert(e.getNumKids() == 1);                                               \
+    auto arg0 = e.getKid(0);                                                   \
+    auto funcDecl = e.getFuncDecl();                                           \
+    assert(funcDecl.getNumParams() == 1);                                      \
+    assert(funcDecl.getParamKind(0) == Z3_PARAMETER_INT);                      \
+    int rotation = funcDecl.getIntParam(0);                                    \
+    insertValue(e.asAST(), callRuntime(#RUNTIME_NAME,                          \
+                                       {getValueFor(arg0), getI64(rotation),   \
+                                        getBitWidth(arg0)}));                  \
+  }
+BV_ROTATE_OP(visitBvRotateLeft, jfs_nr_rotate_left)
+BV_ROTATE_OP(visitBvRotateRight, jfs_nr_rotate_right)
+#undef BV_ROTATE_OP
+
+void LLVMProgramBuilderPassImpl::visitBvConcat(Z3AppHandle e) {
+  const unsigned numArgs = e.getNumKids();
+  assert(numArgs >= 2);
+  auto arg0 = e.getKid(0);
+  llvm::Value* result = getValueFor(arg0);
+  uint64_t resultWidth = arg0.getSort().getBitVectorWidth();
+  for (unsigned index = 1; index < numArgs; ++index) {
+    auto argN = e.getKid(index);
+    uint64_t argNWidth = argN.getSort().getBitVectorWidth();
+    result = callRuntime("jfs_nr_concat", {result, getI64(resultWidth),
+                                           getValueFor(argN),
+                                           getI64(argNWidth)});
+    resultWidth += argNWidth;
+  }
+  insertValue(e.asAST(), result);
+}
+
+#define BV_EXTEND_OP(NAME, RUNTIME_NAME)                                       \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    /* The extension amount is not an argument */                              \
+    assert(e.getNumKids() == 1);                                               \
+    auto arg0 = e.getKid(0);                                                   \
+    auto funcDecl = e.getFuncDecl();                                           \
+    assert(funcDecl.getNumParams() == 1);                                      \
+    assert(funcDecl.getParamKind(0) == Z3_PARAMETER_INT);                      \
+    int numberOfNewBits = funcDecl.getIntParam(0);                             \
+    insertValue(e.asAST(),                                                     \
+                callRuntime(#RUNTIME_NAME, {getValueFor(arg0),                 \
+                                            getBitWidth(arg0),                 \
+                                            getI64(numberOfNewBits)}));        \
+  }
+BV_EXTEND_OP(visitBvSignExtend, jfs_nr_sign_extend)
+BV_EXTEND_OP(visitBvZeroExtend, jfs_nr_zero_extend)
+#undef BV_EXTEND_OP
+
+void LLVMProgramBuilderPassImpl::visitBvExtract(Z3AppHandle e) {
+  // The bit indices are not arguments
+  assert(e.getNumKids() == 1);
+  auto arg0 = e.getKid(0);
+  auto funcDecl = e.getFuncDecl();
+  assert(funcDecl.getNumParams() == 2);
+  assert(funcDecl.getParamKind(0) == Z3_PARAMETER_INT);
+  assert(funcDecl.getParamKind(1) == Z3_PARAMETER_INT);
+  int highBit = funcDecl.getIntParam(0);
+  int lowBit = funcDecl.getIntParam(1);
+  assert(highBit >= lowBit);
+  insertValue(e.asAST(),
+              callRuntime("jfs_nr_extract",
+                          {getValueFor(arg0), getBitWidth(arg0),
+                           getI64(highBit), getI64(lowBit)}));
+}
+
+void LLVMProgramBuilderPassImpl::visitBoolConstant(Z3AppHandle e) {
+  insertValue(e.asAST(), getBoolConstant(e));
+}
+
+void LLVMProgramBuilderPassImpl::visitBitVector(Z3AppHandle e) {
+  insertValue(e.asAST(), getBitVectorConstant(e));
+}
+
+// Floating point
+void LLVMProgramBuilderPassImpl::visitFloatingPointFromTriple(Z3AppHandle e) {
+  assert(e.getNumKids() == 3);
+  insertValue(e.asAST(),
+              callRuntime(getFloatRuntimeFunctionName(e.getSort(), "make") +
+                              "_from_triple",
+                          {getValueFor(e.getKid(0)), getValueFor(e.getKid(1)),
+                           getValueFor(e.getKid(2))}));
+}
+
+void LLVMProgramBuilderPassImpl::visitFloatingPointFromIEEEBitVector(
+    Z3AppHandle e) {
+  assert(e.getNumKids() == 1);
+  auto bvExpr = e.getKid(0);
+  assert(bvExpr.getSort().isBitVectorTy());
+  std::string name = "jfs_nr_bitcast_bv_to_";
+  name += getFloatRuntimeFunctionPrefix(e.getSort());
+  insertValue(e.asAST(), callRuntime(name, {getValueFor(bvExpr)}));
+}
+
+void LLVMProgramBuilderPassImpl::visitFloatUnaryOp(Z3AppHandle e,
+                                                   llvm::StringRef suffix) {
+  assert(e.getNumKids() == 1);
+  auto arg = e.getKid(0);
+  assert(arg.getSort().isFloatingPointTy());
+  insertValue(e.asAST(),
+              callRuntime(getFloatRuntimeFunctionName(arg.getSort(), suffix),
+                          {getValueFor(arg)}));
+}
+
+void LLVMProgramBuilderPassImpl::visitFloatBinOp(Z3AppHandle e,
+                                                 llvm::StringRef suffix) {
+  assert(e.getNumKids() == 2);
+  auto lhs = e.getKid(0);
+  auto rhs = e.getKid(1);
+  assert(lhs.getSort().isFloatingPointTy());
+  assert(rhs.getSort().isFloatingPointTy());
+  insertValue(e.asAST(),
+              callRuntime(getFloatRuntimeFunctionName(lhs.getSort(), suffix),
+                          {getValueFor(lhs), getValueFor(rhs)}));
+}
+
+void LLVMProgramBuilderPassImpl::visitFloatBinWithRMOp(Z3AppHandle e,
+                                                       llvm::StringRef suffix) {
+  assert(e.getNumKids() == 3);
+  assert(e.getKid(0).isApp());
+  auto lhs = e.getKid(1);
+  auto rhs = e.getKid(2);
+  assert(lhs.getSort().isFloatingPointTy());
+  assert(rhs.getSort().isFloatingPointTy());
+  insertValue(e.asAST(),
+              callRuntime(getFloatRuntimeFunctionName(lhs.getSort(), suffix),
+                          {getRoundingMode(e.getKid(0).asApp()),
+                           getValueFor(lhs), getValueFor(rhs)}));
+}
+
+void LLVMProgramBuilderPassImpl::visitFloatUnaryWithRMOp(
+    Z3AppHandle e, llvm::StringRef suffix) {
+  assert(e.getNumKids() == 2);
+  assert(e.getKid(0).isApp());
+  auto arg = e.getKid(1);
+  assert(arg.getSort().isFloatingPointTy());
+  insertValue(e.asAST(),
+              callRuntime(getFloatRuntimeFunctionName(arg.getSort(), suffix),
+                          {getRoundingMode(e.getKid(0).asApp()),
+                           getValueFor(arg)}));
+}
+
+#define FP_UNARY_OP(NAME, SUFFIX)                                              \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    visitFloatUnaryOp(e, #SUFFIX);                                             \
+  }
+FP_UNARY_OP(visitFloatIsNaN, is_nan)
+FP_UNARY_OP(visitFloatIsNormal, is_normal)
+FP_UNARY_OP(visitFloatIsSubnormal, is_subnormal)
+FP_UNARY_OP(visitFloatIsZero, is_zero)
+FP_UNARY_OP(visitFloatIsPositive, is_positive)
+FP_UNARY_OP(visitFloatIsNegative, is_negative)
+FP_UNARY_OP(visitFloatIsInfinite, is_infinite)
+FP_UNARY_OP(visitFloatAbs, abs)
+FP_UNARY_OP(visitFloatNeg, neg)
+#undef FP_UNARY_OP
+
+#define FP_BIN_OP(NAME, SUFFIX)                                                \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    visitFloatBinOp(e, #SUFFIX);                                               \
+  }
+FP_BIN_OP(visitFloatIEEEEquals, ieee_equals)
+FP_BIN_OP(visitFloatLessThan, lt)
+FP_BIN_OP(visitFloatLessThanOrEqual, leq)
+FP_BIN_OP(visitFloatGreaterThan, gt)
+FP_BIN_OP(visitFloatGreaterThanOrEqual, geq)
+FP_BIN_OP(visitFloatRem, rem)
+FP_BIN_OP(visitFloatMin, min)
+FP_BIN_OP(visitFloatMax, max)
+#undef FP_BIN_OP
+
+#define FP_SPECIAL_CONST(NAME, SUFFIX, ARG)                                    \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    assert(e.getNumKids() == 0);                                               \
+    insertValue(e.asAST(),                                                     \
+                callRuntime(getFloatRuntimeFunctionName(e.getSort(), #SUFFIX), \
+                            {builder.getInt1(ARG)}));                          \
+  }
+FP_SPECIAL_CONST(visitFloatPositiveZero, get_zero, true)
+FP_SPECIAL_CONST(visitFloatNegativeZero, get_zero, false)
+FP_SPECIAL_CONST(visitFloatPositiveInfinity, get_infinity, true)
+FP_SPECIAL_CONST(visitFloatNegativeInfinity, get_infinity, false)
+FP_SPECIAL_CONST(visitFloatNaN, get_nan, true)
+#undef FP_SPECIAL_CONST
+
+void LLVMProgramBuilderPassImpl::visitFloatingPointConstant(Z3AppHandle e) {
+  assert(e.getNumKids() == 0);
+  insertValue(e.asAST(), getFloatingPointConstant(e));
+}
+
+#define FP_BIN_WITH_RM_OP(NAME, SUFFIX)                                        \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    visitFloatBinWithRMOp(e, #SUFFIX);                                         \
+  }
+FP_BIN_WITH_RM_OP(visitFloatAdd, add)
+FP_BIN_WITH_RM_OP(visitFloatSub, sub)
+FP_BIN_WITH_RM_OP(visitFloatMul, mul)
+FP_BIN_WITH_RM_OP(visitFloatDiv, div)
+#undef FP_BIN_WITH_RM_OP
+
+#define FP_UNARY_WITH_RM_OP(NAME, SUFFIX)                                      \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    visitFloatUnaryWithRMOp(e, #SUFFIX);                                       \
+  }
+FP_UNARY_WITH_RM_OP(visitFloatSqrt, sqrt)
+FP_UNARY_WITH_RM_OP(visitFloatRoundToIntegral, round_to_integral)
+#undef FP_UNARY_WITH_RM_OP
+
+void LLVMProgramBuilderPassImpl::visitFloatFMA(Z3AppHandle e) {
+  assert(e.getNumKids() == 4);
+  assert(e.getKid(0).isApp());
+  auto a = e.getKid(1);
+  insertValue(e.asAST(),
+              callRuntime(getFloatRuntimeFunctionName(a.getSort(), "fma"),
+                          {getRoundingMode(e.getKid(0).asApp()),
+                           getValueFor(a), getValueFor(e.getKid(2)),
+                           getValueFor(e.getKid(3))}));
+}
+
+void LLVMProgramBuilderPassImpl::visitConvertToFloatFromFloat(Z3AppHandle e) {
+  assert(e.getNumKids() == 2);
+  assert(e.getKid(0).isApp());
+  auto arg = e.getKid(1);
+  llvm::Type* argTy = getOrInsertTy(arg.getSort());
+  llvm::Type* resultTy = getOrInsertTy(e.getSort());
+  if (argTy == resultTy) {
+    // No-op conversion
+    insertValue(e.asAST(), getValueFor(arg));
+    return;
+  }
+  if (resultTy->isDoubleTy()) {
+    // Widening is exact so the rounding mode is not needed.
+    insertValue(e.asAST(), callRuntime("jfs_nr_convert_float32_to_float64",
+                                       {getValueFor(arg)}));
+    return;
+  }
+  insertValue(e.asAST(), callRuntime("jfs_nr_convert_float64_to_float32",
+                                     {getRoundingMode(e.getKid(0).asApp()),
+                                      getValueFor(arg)}));
+}
+
+#define FP_CONVERT_FROM_BV_OP(NAME, KIND)                                      \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    assert(e.getNumKids() == 2);                                               \
+    assert(e.getKid(0).isApp());                                               \
+    auto arg = e.getKid(1);                                                    \
+    assert(arg.getSort().isBitVectorTy());                                     \
+    std::string name = "jfs_nr_convert_from_" #KIND "_bv_to_";                 \
+    name += getFloatRuntimeFunctionPrefix(e.getSort());                        \
+    insertValue(e.asAST(), callRuntime(name,                                   \
+                                       {getRoundingMode(e.getKid(0).asApp()),  \
+                                        getValueFor(arg), getBitWidth(arg)})); \
+  }
+FP_CONVERT_FROM_BV_OP(visitConvertToFloatFromUnsignedBitVector, unsigned)
+FP_CONVERT_FROM_BV_OP(visitConvertToFloatFromSignedBitVector, signed)
+#undef FP_CONVERT_FROM_BV_OP
+
+#define FP_CONVERT_TO_BV_OP(NAME, SUFFIX)                                      \
+  void LLVMProgramBuilderPassImpl::NAME(Z3AppHandle e) {                       \
+    assert(e.getNumKids() == 2);                                               \
+    assert(e.getKid(0).isApp());                                               \
+    auto arg = e.getKid(1);                                                    \
+    assert(e.getSort().isBitVectorTy());                                       \
+    insertValue(e.asAST(),                                                     \
+                callRuntime(getFloatRuntimeFunctionName(arg.getSort(),         \
+                                                        #SUFFIX),              \
+                            {getRoundingMode(e.getKid(0).asApp()),             \
+                             getValueFor(arg), getBitWidth(e.asAST())}));      \
+  }
+FP_CONVERT_TO_BV_OP(visitConvertToUnsignedBitVectorFromFloat,
+                    convert_to_unsigned_bv)
+FP_CONVERT_TO_BV_OP(visitConvertToSignedBitVectorFromFloat,
+                    convert_to_signed_bv)
+#undef FP_CONVERT_TO_BV_OP
+}
+}
@@ -0,0 +1,219 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_LLVM_FUZZING_BACKEND_LLVM_PROGRAM_BUILDER_PASS_IMPL_H
+#define JFS_LLVM_FUZZING_BACKEND_LLVM_PROGRAM_BUILDER_PASS_IMPL_H
+#include "jfs/Core/JFSContext.h"
+#include "jfs/Core/Z3ASTVisitor.h"
+#include "jfs/Core/Z3Node.h"
+#include "jfs/Core/Z3NodeMap.h"
+#include "jfs/FuzzingCommon/FuzzingAnalysisInfo.h"
+#include "jfs/LLVMFuzzingBackend/LLVMProgramBuilderPass.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Module.h"
+#include <memory>
+
+namespace jfs {
+namespace llvmfb {
+
+// Values are represented as follows
+//
+// * Bool -> i1
+// * BitVector (width <= 64) -> i64 with the unused high bits zero. This is
+//   the representation used by `jfs_nr_bitvector_ty` in the runtime.
+// * Float32 -> float
+// * Float64 -> double
+// * RoundingMode -> not materialized. Rounding modes are passed to the
+//   runtime as `JFS_NR_RM` constants.
+class LLVMProgramBuilderPassImpl : public jfs::core::Z3ASTVisitor {
+private:
+  unsigned bufferWidthInBits = 0;
+  jfs::core::JFSContext& ctx;
+  std::unique_ptr<llvm::Module> module;
+  std::shared_ptr<jfs::fuzzingCommon::FuzzingAnalysisInfo> info;
+  llvm::IRBuilder<> builder;
+  llvm::Function* entryPoint;
+  llvm::BasicBlock* earlyExitBlock;
+  llvm::Value* entryPointFirstArg;
+  llvm::Value* entryPointSecondArg;
+  jfs::core::Z3ASTMap<llvm::Value*> exprToValue;
+  unsigned numConstraintBranches;
+  const bool traceComparisons;
+  llvm::GlobalVariable* extraCounters;
+  unsigned numExtraCounters;
+
+  LLVMProgramBuilderPassImpl(
+      std::shared_ptr<jfs::fuzzingCommon::FuzzingAnalysisInfo> info,
+      std::unique_ptr<llvm::Module> runtimeModule, jfs::core::JFSContext& ctx,
+      bool traceComparisons);
+
+  void build(const jfs::core::Query& q);
+
+  // Function for building various parts of the program
+  llvm::Function* buildEntryPoint();
+  void insertExtraCounters(unsigned numCounters);
+  void insertBufferSizeGuard();
+  void insertFreeVariableConstruction();
+  void insertConstantAssignments();
+  void insertBranchForConstraint(jfs::core::Z3ASTHandle constraint);
+  void insertFuzzingTarget();
+  void internalizeRuntime();
+  // Only let LLVMProgramBuilderPass use the implementation.
+  friend class LLVMProgramBuilderPass;
+
+  // Helpers for calling into the runtime
+  llvm::Function* getRuntimeFunction(llvm::StringRef name);
+  llvm::Value* callRuntime(llvm::StringRef name,
+                           llvm::ArrayRef<llvm::Value*> args);
+  llvm::StringRef getFloatRuntimeFunctionPrefix(jfs::core::Z3SortHandle sort);
+  std::string getFloatRuntimeFunctionName(jfs::core::Z3SortHandle sort,
+                                          llvm::StringRef suffix);
+
+  // Helpers for giving LibFuzzer feedback
+  void setExtraCounter(unsigned index);
+  void traceComparison(llvm::Value* lhs, llvm::Value* rhs);
+
+  // Visitor and ConstantAssignment helper methods
+  llvm::Type* getOrInsertTy(jfs::core::Z3SortHandle sort);
+  llvm::Value* getBoolConstant(jfs::core::Z3AppHandle e);
+  llvm::Value* getBitVectorConstant(jfs::core::Z3AppHandle e);
+  llvm::Value* getFloatingPointConstant(jfs::core::Z3AppHandle e);
+  llvm::Value* getI64(uint64_t value);
+  llvm::Value* getBitWidth(jfs::core::Z3ASTHandle e);
+  void insertValue(jfs::core::Z3ASTHandle e, llvm::Value* v);
+  void doDFSPostOrderTraversal(jfs::core::Z3ASTHandle e);
+  bool hasBeenVisited(jfs::core::Z3ASTHandle e) const;
+  llvm::Value* getValueFor(jfs::core::Z3ASTHandle e) const;
+
+  // Visitor methods
+  bool shouldTraverseNode(jfs::core::Z3ASTHandle e) const;
+  llvm::Value* getRoundingMode(jfs::core::Z3AppHandle rm);
+  void visitBvNaryOp(jfs::core::Z3AppHandle e, llvm::StringRef runtimeName);
+  void visitBvBinOp(jfs::core::Z3AppHandle e, llvm::StringRef runtimeName);
+  void visitBvCmpOp(jfs::core::Z3AppHandle e, llvm::StringRef runtimeName);
+  void visitFloatUnaryOp(jfs::core::Z3AppHandle e, llvm::StringRef suffix);
+  void visitFloatBinOp(jfs::core::Z3AppHandle e, llvm::StringRef suffix);
+  void visitFloatBinWithRMOp(jfs::core::Z3AppHandle e, llvm::StringRef suffix);
+  void visitFloatUnaryWithRMOp(jfs::core::Z3AppHandle e,
+                               llvm::StringRef suffix);
+
+  void visitUninterpretedFunc(jfs::core::Z3AppHandle e) override;
+
+  // Overloaded operations
+  void visitEqual(jfs::core::Z3AppHandle e) override;
+  void visitDistinct(jfs::core::Z3AppHandle e) override;
+  void visitIfThenElse(jfs::core::Z3AppHandle e) override;
+  void visitImplies(jfs::core::Z3AppHandle e) override;
+  void visitIff(jfs::core::Z3AppHandle e) override;
+
+  // Boolean operations
+  void visitAnd(jfs::core::Z3AppHandle e) override;
+  void visitOr(jfs::core::Z3AppHandle e) override;
+  void visitXor(jfs::core::Z3AppHandle e) override;
+  void visitNot(jfs::core::Z3AppHandle e) override;
+
+  // Arithmetic BitVector operations
+  void visitBvNeg(jfs::core::Z3AppHandle e) override;
+  void visitBvAdd(jfs::core::Z3AppHandle e) override;
+  void visitBvSub(jfs::core::Z3AppHandle e) override;
+  void visitBvMul(jfs::core::Z3AppHandle e) override;
+  void visitBvSDiv(jfs::core::Z3AppHandle e) override;
+  void visitBvUDiv(jfs::core::Z3AppHandle e) override;
+  void visitBvSRem(jfs::core::Z3AppHandle e) override;
+  void visitBvURem(jfs::core::Z3AppHandle e) override;
+  void visitBvSMod(jfs::core::Z3AppHandle e) override;
+
+  // Comparison BitVector operations
+  void visitBvULE(jfs::core::Z3AppHandle e) override;
+  void visitBvSLE(jfs::core::Z3AppHandle e) override;
+  void visitBvUGE(jfs::core::Z3AppHandle e) override;
+  void visitBvSGE(jfs::core::Z3AppHandle e) override;
+  void visitBvULT(jfs::core::Z3AppHandle e) override;
+  void visitBvSLT(jfs::core::Z3AppHandle e) override;
+  void visitBvUGT(jfs::core::Z3AppHandle e) override;
+  void visitBvSGT(jfs::core::Z3AppHandle e) override;
+  void visitBvComp(jfs::core::Z3AppHandle e) override;
+
+  // Bitwise BitVector operations
+  void visitBvAnd(jfs::core::Z3AppHandle e) override;
+  void visitBvOr(jfs::core::Z3AppHandle e) override;
+  void visitBvNot(jfs::core::Z3AppHandle e) override;
+  void visitBvXor(jfs::core::Z3AppHandle e) override;
+  void visitBvNand(jfs::core::Z3AppHandle e) override;
+  void visitBvNor(jfs::core::Z3AppHandle e) override;
+  void visitBvXnor(jfs::core::Z3AppHandle e) override;
+
+  // Shift and rotation BitVector operations
+  void visitBvShl(jfs::core::Z3AppHandle e) override;
+  void visitBvLShr(jfs::core::Z3AppHandle e) override;
+  void visitBvAShr(jfs::core::Z3AppHandle e) override;
+  void visitBvRotateLeft(jfs::core::Z3AppHandle e) override;
+  void visitBvRotateRight(jfs::core::Z3AppHandle e) override;
+
+  // Sort changing BitVector operations
+  void visitBvConcat(jfs::core::Z3AppHandle e) override;
+  void visitBvSignExtend(jfs::core::Z3AppHandle e) override;
+  void visitBvZeroExtend(jfs::core::Z3AppHandle e) override;
+  void visitBvExtract(jfs::core::Z3AppHandle e) override;
+
+  // Constants
+  void visitBoolConstant(jfs::core::Z3AppHandle e) override;
+  void visitBitVector(jfs::core::Z3AppHandle e) override;
+
+  // Floating point
+  void visitFloatingPointFromTriple(jfs::core::Z3AppHandle e) override;
+  void visitFloatingPointFromIEEEBitVector(jfs::core::Z3AppHandle e) override;
+  void visitFloatIsNaN(jfs::core::Z3AppHandle e) override;
+  void visitFloatIsNormal(jfs::core::Z3AppHandle e) override;
+  void visitFloatIsSubnormal(jfs::core::Z3AppHandle e) override;
+  void visitFloatIsZero(jfs::core::Z3AppHandle e) override;
+  void visitFloatIsPositive(jfs::core::Z3AppHandle e) override;
+  void visitFloatIsNegative(jfs::core::Z3AppHandle e) override;
+  void visitFloatIsInfinite(jfs::core::Z3AppHandle e) override;
+
+  void visitFloatIEEEEquals(jfs::core::Z3AppHandle e) override;
+  void visitFloatLessThan(jfs::core::Z3AppHandle e) override;
+  void visitFloatLessThanOrEqual(jfs::core::Z3AppHandle e) override;
+  void visitFloatGreaterThan(jfs::core::Z3AppHandle e) override;
+  void visitFloatGreaterThanOrEqual(jfs::core::Z3AppHandle e) override;
+
+  void visitFloatPositiveZero(jfs::core::Z3AppHandle e) override;
+  void visitFloatNegativeZero(jfs::core::Z3AppHandle e) override;
+  void visitFloatPositiveInfinity(jfs::core::Z3AppHandle e) override;
+  void visitFloatNegativeInfinity(jfs::core::Z3AppHandle e) override;
+  void visitFloatNaN(jfs::core::Z3AppHandle e) override;
+  void visitFloatingPointConstant(jfs::core::Z3AppHandle e) override;
+
+  void visitFloatAbs(jfs::core::Z3AppHandle e) override;
+  void visitFloatNeg(jfs::core::Z3AppHandle e) override;
+  void visitFloatMin(jfs::core::Z3AppHandle e) override;
+  void visitFloatMax(jfs::core::Z3AppHandle e) override;
+  void visitFloatAdd(jfs::core::Z3AppHandle e) override;
+  void visitFloatSub(jfs::core::Z3AppHandle e) override;
+  void visitFloatMul(jfs::core::Z3AppHandle e) override;
+  void visitFloatDiv(jfs::core::Z3AppHandle e) override;
+  void visitFloatFMA(jfs::core::Z3AppHandle e) override;
+  void visitFloatSqrt(jfs::core::Z3AppHandle e) override;
+  void visitFloatRem(jfs::core::Z3AppHandle e) override;
+  void visitFloatRoundToIntegral(jfs::core::Z3AppHandle e) override;
+  void visitConvertToFloatFromFloat(jfs::core::Z3AppHandle e) override;
+  void
+  visitConvertToFloatFromUnsignedBitVector(jfs::core::Z3AppHandle e) override;
+  void
+  visitConvertToFloatFromSignedBitVector(jfs::core::Z3AppHandle e) override;
+  void
+  visitConvertToUnsignedBitVectorFromFloat(jfs::core::Z3AppHandle e) override;
+  void
+  visitConvertToSignedBitVectorFromFloat(jfs::core::Z3AppHandle e) override;
+};
+}
+}
+#endif
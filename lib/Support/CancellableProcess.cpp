@@ -12,9 +12,13 @@
 #include "llvm/Support/Program.h"
 #include "llvm/Support/raw_ostream.h"
 #include <atomic>
+#include <fcntl.h>
 #include <mutex>
+#include <pthread.h>
 #include <signal.h>
+#include <string>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 namespace jfs {
@@ -83,8 +87,35 @@ public:
     }
   }
 
+  // Writes to the pipe `fd` with `stdinWriter` and then closes it.
+  void writeToStdin(int fd, CancellableProcess::StdinWriterTy& stdinWriter) {
+    // If the process exits (e.g. it was cancelled) before reading all of its
+    // input writing to the pipe raises SIGPIPE which would kill us. Block it
+    // in this thread and afterwards discard it if it became pending.
+    // FIXME: This is POSIX specific
+    sigset_t sigPipeSet;
+    sigset_t oldSet;
+    sigemptyset(&sigPipeSet);
+    sigaddset(&sigPipeSet, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &sigPipeSet, &oldSet);
+    {
+      llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+      stdinWriter(os);
+      os.close();
+      // A write error just means the process stopped reading. Its exit code
+      // will say why.
+      if (os.has_error())
+        os.clear_error();
+    }
+    struct timespec noWait = {0, 0};
+    while (sigtimedwait(&sigPipeSet, nullptr, &noWait) > 0)
+      ;
+    pthread_sigmask(SIG_SETMASK, &oldSet, nullptr);
+  }
+
   int execute(llvm::StringRef program, std::vector<const char*>& args,
-              std::vector<llvm::StringRef>& redirects) {
+              std::vector<llvm::StringRef>& redirects,
+              CancellableProcess::StdinWriterTy& stdinWriter) {
     if (cancelled) {
       return -1;
     }
@@ -104,6 +135,20 @@ public:
       }
     }
 
+    // The process reads stdin from a pipe which it opens by path. Both ends
+    // are close-on-exec so that the process doesn't inherit the write end,
+    // otherwise it would never see EOF.
+    int stdinPipe[2] = {-1, -1};
+    std::string stdinPipePath;
+    if (stdinWriter) {
+      if (::pipe2(stdinPipe, O_CLOEXEC) != 0) {
+        return -1;
+      }
+      stdinPipePath = "/dev/fd/" + std::to_string(stdinPipe[0]);
+      redirectOptionals[0] = llvm::Optional<llvm::StringRef>(stdinPipePath);
+    }
+    bool useRedirects = redirects.size() > 0 || stdinWriter;
+
     std::string errorMsg;
     bool executionFailed = false;
     {
@@ -115,12 +160,21 @@ public:
           /*Program=*/program,
           /*args=*/args.data(),
           /*env=*/nullptr,
-          /*redirects=*/((redirects.size() == 0) ? (llvm::ArrayRef<llvm::Optional<llvm::StringRef>>()) : redirectOptionals),
+          /*redirects=*/((!useRedirects) ? (llvm::ArrayRef<llvm::Optional<llvm::StringRef>>()) : redirectOptionals),
           /*memoryLimit=*/0,
           /*ErrMsg=*/&errorMsg,
           /*ExecutionFailed=*/&executionFailed);
     }
 
+    if (stdinWriter) {
+      ::close(stdinPipe[0]);
+      if (executionFailed) {
+        ::close(stdinPipe[1]);
+      } else {
+        writeToStdin(stdinPipe[1], stdinWriter);
+      }
+    }
+
     if (executionFailed) {
       // FIXME: emit to an interface
       // llvm::errs() << "Execution failed: " << errorMsg << "\n";
@@ -161,8 +215,9 @@ CancellableProcess::~CancellableProcess() {}
 void CancellableProcess::cancel() { impl->cancel(); }
 int CancellableProcess::execute(llvm::StringRef program,
                                 std::vector<const char*>& args,
-                                std::vector<llvm::StringRef>& redirects) {
-  return impl->execute(program, args, redirects);
+                                std::vector<llvm::StringRef>& redirects,
+                                StdinWriterTy stdinWriter) {
+  return impl->execute(program, args, redirects, stdinWriter);
 }
 }
 }
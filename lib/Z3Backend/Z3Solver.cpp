@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #include "jfs/Z3Backend/Z3Solver.h"
 #include "jfs/Core/IfVerbose.h"
+#include "jfs/Z3Backend/Z3SolverOptions.h"
 
 using namespace jfs::core;
 
@@ -74,6 +75,15 @@ namespace jfs {
     assert(z3Ctx == q.getContext().getZ3Ctx());
     // Use default solver behaviour
     Z3SolverHandle solver = Z3SolverHandle(::Z3_mk_solver(z3Ctx), z3Ctx);
+    const Z3SolverOptions* z3Options =
+        llvm::dyn_cast_or_null<Z3SolverOptions>(options.get());
+    if (z3Options && z3Options->timeoutInMs > 0) {
+      Z3ParamsHandle params = Z3ParamsHandle(::Z3_mk_params(z3Ctx), z3Ctx);
+      ::Z3_params_set_uint(z3Ctx, params,
+                           ::Z3_mk_string_symbol(z3Ctx, "timeout"),
+                           z3Options->timeoutInMs);
+      ::Z3_solver_set_params(z3Ctx, solver, params);
+    }
 
     for (auto ci = q.constraints.cbegin(), ce = q.constraints.cend(); ci != ce;
          ++ci) {
@@ -157,6 +157,8 @@ inline uint64_t Bswap(uint64_t x) { return __builtin_bswap64(x); }
 uint8_t *ExtraCountersBegin();
 uint8_t *ExtraCountersEnd();
 void ClearExtraCounters();
+// JFS: Use [Begin, End) as the extra counters (see FuzzerJFS.h).
+void JFSSetExtraCounters(uint8_t *Begin, uint8_t *End);
 
 uint64_t *ClangCountersBegin();
 uint64_t *ClangCountersEnd();
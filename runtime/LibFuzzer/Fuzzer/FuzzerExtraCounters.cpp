@@ -16,8 +16,24 @@ __attribute__((weak)) extern uint8_t __start___libfuzzer_extra_counters;
 __attribute__((weak)) extern uint8_t __stop___libfuzzer_extra_counters;
 
 namespace fuzzer {
-uint8_t *ExtraCountersBegin() { return &__start___libfuzzer_extra_counters; }
-uint8_t *ExtraCountersEnd() { return &__stop___libfuzzer_extra_counters; }
+// JFS: Counters registered with `jfs_libfuzzer_set_extra_counters()`.
+static uint8_t *JFSExtraCountersBegin;
+static uint8_t *JFSExtraCountersEnd;
+void JFSSetExtraCounters(uint8_t *Begin, uint8_t *End) {
+  JFSExtraCountersBegin = Begin;
+  JFSExtraCountersEnd = End;
+}
+
+uint8_t *ExtraCountersBegin() {
+  if (JFSExtraCountersBegin)
+    return JFSExtraCountersBegin;
+  return &__start___libfuzzer_extra_counters;
+}
+uint8_t *ExtraCountersEnd() {
+  if (JFSExtraCountersBegin)
+    return JFSExtraCountersEnd;
+  return &__stop___libfuzzer_extra_counters;
+}
 ATTRIBUTE_NO_SANITIZE_ALL
 void ClearExtraCounters() {  // hand-written memset, don't asan-ify.
   uintptr_t *Beg = reinterpret_cast<uintptr_t*>(ExtraCountersBegin());
@@ -36,6 +52,7 @@ namespace fuzzer {
 uint8_t *ExtraCountersBegin() { return nullptr; }
 uint8_t *ExtraCountersEnd() { return nullptr; }
 void ClearExtraCounters() {}
+void JFSSetExtraCounters(uint8_t *Begin, uint8_t *End) {}
 }  // namespace fuzzer
 
 #endif
@@ -126,4 +126,8 @@ void Printf(const char *Fmt, ...) {
   fflush(OutputFile);
 }
 
+void JFSSetOutputFile(FILE *F) {
+  OutputFile = F;
+}
+
 }  // namespace fuzzer
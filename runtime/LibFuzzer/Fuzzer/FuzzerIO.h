@@ -13,6 +13,7 @@
 #define LLVM_FUZZER_IO_H
 
 #include "FuzzerDefs.h"
+#include <cstdio>
 
 namespace fuzzer {
 
@@ -48,6 +49,9 @@ void CloseStdout();
 
 void Printf(const char *Fmt, ...);
 
+// JFS: Send the output of `Printf()` to `F`.
+void JFSSetOutputFile(FILE *F);
+
 // Print using raw syscalls, useful when printing at early init stages.
 void RawPrint(const char *Str);
 
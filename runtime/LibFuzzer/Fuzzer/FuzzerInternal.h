@@ -150,6 +150,23 @@ private:
   static thread_local bool IsMyThread;
 };
 
+// JFS: Seeds added via `jfs_libfuzzer_add_seed()` (see FuzzerJFS.h).
+const Vector<Unit> &GetJFSInMemorySeeds();
+// JFS: Print the final stats of the running fuzzer (if any).
+void JFSPrintFinalStats();
+// JFS: Apply `jfs_libfuzzer_set_custom_mutators()` to `EF`.
+void JFSOverrideExternalFunctions(ExternalFunctions *EF);
+// JFS: `FuzzerDriver()` for `jfs_libfuzzer_fuzz()`.
+int JFSFuzzInProcess(int argc, char **argv, UserCallback Callback);
+// JFS: True while `jfs_libfuzzer_fuzz()` is running.
+bool JFSRunningInProcess();
+// JFS: True once `jfs_libfuzzer_stop()` has been called during
+// `jfs_libfuzzer_fuzz()`.
+bool JFSStopRequested();
+// JFS: Stop `jfs_libfuzzer_fuzz()` and make it return `Result` (one of the
+// `JFS_LIBFUZZER_FUZZ_*` values).
+void JFSStopWithResult(int Result);
+
 } // namespace fuzzer
 
 #endif // LLVM_FUZZER_INTERNAL_H
@@ -0,0 +1,116 @@
+//===- FuzzerJFS.cpp - JFS extensions to LibFuzzer ------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+// JFS specific interface for driving LibFuzzer from inside another process.
+//===----------------------------------------------------------------------===//
+
+#include "FuzzerJFS.h"
+#include "FuzzerDefs.h"
+#include "FuzzerExtFunctions.h"
+#include "FuzzerIO.h"
+#include "FuzzerInternal.h"
+#include <atomic>
+
+namespace fuzzer {
+
+static Vector<Unit> *JFSSeeds;
+static JFSLibFuzzerTargetFoundCallback JFSTargetFoundCallback;
+static JFSLibFuzzerCustomMutator JFSCustomMutator;
+static JFSLibFuzzerCustomCrossOver JFSCustomCrossOver;
+static bool JFSInProcess;
+static std::atomic<bool> JFSStop;
+static int JFSResult;
+
+const Vector<Unit> &GetJFSInMemorySeeds() {
+  static Vector<Unit> Empty;
+  return JFSSeeds ? *JFSSeeds : Empty;
+}
+
+void JFSOverrideExternalFunctions(ExternalFunctions *EF) {
+  if (JFSCustomMutator)
+    EF->LLVMFuzzerCustomMutator = JFSCustomMutator;
+  if (JFSCustomCrossOver)
+    EF->LLVMFuzzerCustomCrossOver = JFSCustomCrossOver;
+}
+
+bool JFSRunningInProcess() { return JFSInProcess; }
+
+bool JFSStopRequested() { return JFSStop; }
+
+void JFSStopWithResult(int Result) {
+  JFSResult = Result;
+  JFSStop = true;
+}
+
+} // namespace fuzzer
+
+extern "C" {
+using namespace fuzzer;
+
+void jfs_libfuzzer_add_seed(const uint8_t *Data, size_t Size) {
+  if (!JFSSeeds)
+    JFSSeeds = new Vector<Unit>();
+  JFSSeeds->push_back(Unit(Data, Data + Size));
+}
+
+void jfs_libfuzzer_set_target_found_callback(
+    JFSLibFuzzerTargetFoundCallback Callback) {
+  JFSTargetFoundCallback = Callback;
+}
+
+void jfs_libfuzzer_set_custom_mutators(JFSLibFuzzerCustomMutator Mutator,
+                                       JFSLibFuzzerCustomCrossOver CrossOver) {
+  JFSCustomMutator = Mutator;
+  JFSCustomCrossOver = CrossOver;
+}
+
+void jfs_libfuzzer_set_extra_counters(uint8_t *Begin, uint8_t *End) {
+  JFSSetExtraCounters(Begin, End);
+}
+
+void jfs_libfuzzer_target_found(const uint8_t *Data, size_t Size) {
+  if (JFSTargetFoundCallback) {
+    // The callback is not expected to return so print the stats that
+    // LibFuzzer would normally print on exit.
+    JFSPrintFinalStats();
+    JFSTargetFoundCallback(Data, Size);
+    return;
+  }
+  // No callback registered. Behave like the `abort()` target used
+  // by standalone fuzzing binaries.
+  abort();
+}
+
+int jfs_libfuzzer_run(int argc, char **argv,
+                      JFSLibFuzzerUserCallback Callback) {
+  return FuzzerDriver(&argc, &argv, Callback);
+}
+
+int jfs_libfuzzer_fuzz(int argc, char **argv, JFSLibFuzzerUserCallback Callback,
+                       FILE *Output) {
+  assert(!JFSInProcess && "Calls must not overlap");
+  JFSInProcess = true;
+  JFSStop = false;
+  JFSResult = JFS_LIBFUZZER_FUZZ_DONE;
+  JFSSetOutputFile(Output);
+  int Result = JFSFuzzInProcess(argc, argv, Callback);
+  if (Result == JFS_LIBFUZZER_FUZZ_DONE)
+    Result = JFSResult;
+  JFSSetOutputFile(stderr);
+  // The seeds and counters belong to the caller's target which is about to
+  // go away.
+  delete JFSSeeds;
+  JFSSeeds = nullptr;
+  JFSSetExtraCounters(nullptr, nullptr);
+  JFSInProcess = false;
+  return Result;
+}
+
+void jfs_libfuzzer_stop(void) { JFSStop = true; }
+
+} // extern "C"
@@ -0,0 +1,95 @@
+//===- FuzzerJFS.h - JFS extensions to LibFuzzer ----------------*- C++ -* ===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+// JFS specific interface for driving LibFuzzer from inside another process.
+// This is not part of upstream LibFuzzer.
+// WARNING: keep the interface in C.
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_FUZZER_JFS_H
+#define LLVM_FUZZER_JFS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+typedef int (*JFSLibFuzzerUserCallback)(const uint8_t *Data, size_t Size);
+typedef void (*JFSLibFuzzerTargetFoundCallback)(const uint8_t *Data,
+                                                size_t Size);
+typedef size_t (*JFSLibFuzzerCustomMutator)(uint8_t *Data, size_t Size,
+                                            size_t MaxSize, unsigned int Seed);
+typedef size_t (*JFSLibFuzzerCustomCrossOver)(const uint8_t *Data1,
+                                              size_t Size1,
+                                              const uint8_t *Data2,
+                                              size_t Size2, uint8_t *Out,
+                                              size_t MaxOutSize,
+                                              unsigned int Seed);
+
+// Add an input to the seed corpus without writing it to disk. Must be called
+// before `jfs_libfuzzer_run()` or `jfs_libfuzzer_fuzz()`.
+void jfs_libfuzzer_add_seed(const uint8_t *Data, size_t Size);
+
+// Set the function `jfs_libfuzzer_target_found()` forwards to.
+void jfs_libfuzzer_set_target_found_callback(
+    JFSLibFuzzerTargetFoundCallback Callback);
+
+// Use `LLVMFuzzerCustomMutator()` and `LLVMFuzzerCustomCrossOver()`
+// implementations that could not be found when LibFuzzer was loaded (e.g.
+// because they are defined by a target loaded later). Either may be null.
+// Must be called before `jfs_libfuzzer_run()` or `jfs_libfuzzer_fuzz()`.
+void jfs_libfuzzer_set_custom_mutators(JFSLibFuzzerCustomMutator Mutator,
+                                       JFSLibFuzzerCustomCrossOver CrossOver);
+
+// Use [Begin, End) as the extra coverage counters rather than the
+// `__libfuzzer_extra_counters` section of the binary LibFuzzer was linked
+// into. Needed when the counters are defined by a target loaded later. The
+// size must be a multiple of `sizeof(uintptr_t)`. Must be called before
+// `jfs_libfuzzer_run()` or `jfs_libfuzzer_fuzz()`.
+void jfs_libfuzzer_set_extra_counters(uint8_t *Begin, uint8_t *End);
+
+// Called by the fuzz target when the input satisfies the constraints.
+void jfs_libfuzzer_target_found(const uint8_t *Data, size_t Size);
+
+// Run the LibFuzzer driver against `Callback`. Like `FuzzerDriver()` this
+// normally does not return.
+int jfs_libfuzzer_run(int argc, char **argv, JFSLibFuzzerUserCallback Callback);
+
+// Values returned by `jfs_libfuzzer_fuzz()`.
+enum {
+  JFS_LIBFUZZER_FUZZ_DONE = 0,
+  // The flags or the dictionary are invalid.
+  JFS_LIBFUZZER_FUZZ_INVALID_ARGS = 1,
+  // No input gave any coverage so there was nothing to mutate.
+  JFS_LIBFUZZER_FUZZ_NO_INTERESTING_INPUTS = 2,
+};
+
+// Fuzz `Callback` without taking over the process, e.g. when the target was
+// JIT compiled into the caller. Unlike `jfs_libfuzzer_run()` this returns
+// once `-runs` or `-max_total_time` is reached or `jfs_libfuzzer_stop()` is
+// called, and installs no signal handlers, threads or `atexit()` handlers.
+// Only fuzzing is supported so corpus directories and flags that select
+// other modes (e.g. `-merge`) are not. LibFuzzer's output goes to `Output`
+// rather than stderr. The seeds and extra counters set before the call only
+// apply to it. Calls must not overlap. Returns one of the
+// `JFS_LIBFUZZER_FUZZ_*` values.
+int jfs_libfuzzer_fuzz(int argc, char **argv, JFSLibFuzzerUserCallback Callback,
+                       FILE *Output);
+
+// Make the active `jfs_libfuzzer_fuzz()` return once the input being
+// executed is done. Can be called from the callback or another thread.
+void jfs_libfuzzer_stop(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // __cplusplus
+
+#endif // LLVM_FUZZER_JFS_H
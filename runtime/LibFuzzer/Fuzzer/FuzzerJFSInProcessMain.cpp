@@ -0,0 +1,149 @@
+//===- FuzzerJFSInProcessMain.cpp - main() for shared object targets ------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+// JFS: main() of the helper that JFS spawns to fuzz a target built as a
+// shared object. This is not part of upstream LibFuzzer.
+//
+// Usage: LLVMFuzzerJFSInProcessDriver <target.so> [LibFuzzer flags...]
+//
+// File descriptor 3 is a socket connected to JFS. JFS first writes the seeds,
+// each as a 64-bit size followed by the data, and then shuts down its end
+// for writing. When an input satisfies the constraints the 64-bit size of
+// the input followed by the input is written back and the process exits.
+//===----------------------------------------------------------------------===//
+
+#include "FuzzerJFS.h"
+#include <dlfcn.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const int JFSChannelFd = 3;
+const int SetupFailedExitCode = 70;
+
+typedef int (*InitializeFn)(int *, char ***);
+
+bool WriteAll(int Fd, const uint8_t *Data, size_t Size) {
+  while (Size > 0) {
+    ssize_t Written = write(Fd, Data, Size);
+    if (Written < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    Data += Written;
+    Size -= Written;
+  }
+  return true;
+}
+
+// Returns the number of bytes read which is less than `Size` at end of file.
+size_t ReadAll(int Fd, uint8_t *Data, size_t Size) {
+  size_t Total = 0;
+  while (Total < Size) {
+    ssize_t Read = read(Fd, Data + Total, Size - Total);
+    if (Read < 0) {
+      if (errno == EINTR)
+        continue;
+      perror("Failed to read seeds");
+      _exit(SetupFailedExitCode);
+    }
+    if (Read == 0)
+      break;
+    Total += Read;
+  }
+  return Total;
+}
+
+void ReadSeeds() {
+  while (true) {
+    uint64_t Size = 0;
+    size_t Read =
+        ReadAll(JFSChannelFd, reinterpret_cast<uint8_t *>(&Size), sizeof(Size));
+    if (Read == 0)
+      return;
+    std::vector<uint8_t> Seed(Size);
+    if (Read != sizeof(Size) ||
+        ReadAll(JFSChannelFd, Seed.data(), Seed.size()) != Size) {
+      fprintf(stderr, "Truncated seed received\n");
+      _exit(SetupFailedExitCode);
+    }
+    jfs_libfuzzer_add_seed(Seed.data(), Seed.size());
+  }
+}
+
+void TargetFound(const uint8_t *Data, size_t Size) {
+  uint64_t Size64 = Size;
+  bool Ok = WriteAll(JFSChannelFd, reinterpret_cast<uint8_t *>(&Size64),
+                     sizeof(Size64)) &&
+            WriteAll(JFSChannelFd, Data, Size);
+  // Don't give LibFuzzer a chance to report the input as a crash.
+  _exit(Ok ? 0 : SetupFailedExitCode);
+}
+
+void *LoadSymbol(void *Handle, const char *Name) {
+  void *Sym = dlsym(Handle, Name);
+  if (!Sym) {
+    fprintf(stderr, "Failed to find \"%s\": %s\n", Name, dlerror());
+    _exit(SetupFailedExitCode);
+  }
+  return Sym;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <target.so> [LibFuzzer flags...]\n", argv[0]);
+    return SetupFailedExitCode;
+  }
+  // LibFuzzer is linked into this binary so the SanitizerCoverage hooks and
+  // `jfs_libfuzzer_target_found()` referenced by the target resolve to it.
+  void *Target = dlopen(argv[1], RTLD_NOW);
+  if (!Target) {
+    fprintf(stderr, "Failed to load fuzzing target: %s\n", dlerror());
+    return SetupFailedExitCode;
+  }
+  auto TestOneInput = reinterpret_cast<JFSLibFuzzerUserCallback>(
+      LoadSymbol(Target, "LLVMFuzzerTestOneInput"));
+
+  ReadSeeds();
+  jfs_libfuzzer_set_target_found_callback(TargetFound);
+  // LibFuzzer looked for the target's optional custom mutators before the
+  // target was loaded.
+  jfs_libfuzzer_set_custom_mutators(
+      reinterpret_cast<JFSLibFuzzerCustomMutator>(
+          dlsym(Target, "LLVMFuzzerCustomMutator")),
+      reinterpret_cast<JFSLibFuzzerCustomCrossOver>(
+          dlsym(Target, "LLVMFuzzerCustomCrossOver")));
+  // The extra counters (if any) are in the target's
+  // `__libfuzzer_extra_counters` section which LibFuzzer only looks for in
+  // its own binary.
+  auto ExtraCounters =
+      reinterpret_cast<uint8_t *>(dlsym(Target, "jfs_extra_counters"));
+  auto NumExtraCounters = reinterpret_cast<const size_t *>(
+      dlsym(Target, "jfs_num_extra_counters"));
+  if (ExtraCounters && NumExtraCounters)
+    jfs_libfuzzer_set_extra_counters(ExtraCounters,
+                                     ExtraCounters + *NumExtraCounters);
+
+  // LibFuzzer only looks at argv[0] for its name so drop our own.
+  --argc;
+  ++argv;
+  // Likewise LibFuzzer can't call the optional `LLVMFuzzerInitialize()`.
+  auto Initialize =
+      reinterpret_cast<InitializeFn>(dlsym(Target, "LLVMFuzzerInitialize"));
+  if (Initialize)
+    Initialize(&argc, &argv);
+  // LibFuzzer calls `exit()` when it is done.
+  return jfs_libfuzzer_run(argc, argv, TestOneInput);
+}
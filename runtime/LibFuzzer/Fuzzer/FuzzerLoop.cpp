@@ -12,6 +12,7 @@
 #include "FuzzerCorpus.h"
 #include "FuzzerIO.h"
 #include "FuzzerInternal.h"
+#include "FuzzerJFS.h"
 #include "FuzzerMutate.h"
 #include "FuzzerRandom.h"
 #include "FuzzerShmem.h"
@@ -163,7 +164,13 @@ Fuzzer::Fuzzer(UserCallback CB, InputCorpus &Corpus, MutationDispatcher &MD,
   memset(BaseSha1, 0, sizeof(BaseSha1));
 }
 
-Fuzzer::~Fuzzer() {}
+// JFS: Only `JFSFuzzInProcess()` destroys its fuzzer. Allow another one to
+// be created after it.
+Fuzzer::~Fuzzer() {
+  assert(F == this);
+  F = nullptr;
+  delete[] CurrentUnitData;
+}
 
 void Fuzzer::AllocateCurrentUnitData() {
   if (CurrentUnitData || MaxInputLen == 0)
@@ -352,6 +359,15 @@ void Fuzzer::PrintFinalStats() {
   Printf("stat::new_units_added:          %zd\n", NumberOfNewUnitsAdded);
   Printf("stat::slowest_unit_time_sec:    %zd\n", TimeOfLongestUnitInSeconds);
   Printf("stat::peak_rss_mb:              %zd\n", GetPeakRSSMb());
+  // JFS: Used to report how useful the dictionary JFS generated was.
+  Printf("stat::jfs_used_dict_entries:      %zd\n",
+         MD.JFSGetNumUsedManualDictionaryEntries());
+}
+
+// JFS: Used when the target is reported through a callback that never returns.
+void JFSPrintFinalStats() {
+  if (F)
+    F->PrintFinalStats();
 }
 
 void Fuzzer::SetMaxInputLen(size_t MaxInputLen) {
@@ -636,6 +652,9 @@ void Fuzzer::MutateAndTestOne() {
   for (int i = 0; i < Options.MutateDepth; i++) {
     if (TotalNumberOfRuns >= Options.MaxNumberOfRuns)
       break;
+    // JFS: Stop requested with `jfs_libfuzzer_stop()`.
+    if (JFSStopRequested())
+      break;
     MaybeExitGracefully();
     size_t NewSize = 0;
     NewSize = MD.Mutate(CurrentUnitData, Size, CurrentMaxMutationLen);
@@ -700,7 +719,17 @@ void Fuzzer::ReadAndExecuteSeedCorpora(const Vector<std::string> &CorpusDirs) {
   uint8_t dummy = 0;
   ExecuteCallback(&dummy, 0);
 
-  if (SizedFiles.empty()) {
+  // JFS: Seeds handed to us in memory by `jfs_libfuzzer_add_seed()`.
+  const Vector<Unit> &InMemorySeeds = GetJFSInMemorySeeds();
+  for (auto &U : InMemorySeeds) {
+    size_t Size = std::min(U.size(), MaxInputLen);
+    RunOne(U.data(), Size);
+    CheckExitOnSrcPosOrItem();
+    if (JFSStopRequested())
+      return;
+  }
+
+  if (SizedFiles.empty() && InMemorySeeds.empty()) {
     Printf("INFO: A corpus is not provided, starting from an empty corpus\n");
     Unit U({'\n'}); // Valid ASCII input.
     RunOne(U.data(), U.size());
@@ -731,6 +760,11 @@ void Fuzzer::ReadAndExecuteSeedCorpora(const Vector<std::string> &CorpusDirs) {
   if (Corpus.empty()) {
     Printf("ERROR: no interesting inputs were found. "
            "Is the code instrumented for coverage? Exiting.\n");
+    // JFS: Don't take the host process down with us.
+    if (JFSRunningInProcess()) {
+      JFSStopWithResult(JFS_LIBFUZZER_FUZZ_NO_INTERESTING_INPUTS);
+      return;
+    }
     exit(1);
   }
 }
@@ -753,6 +787,9 @@ void Fuzzer::Loop(const Vector<std::string> &CorpusDirs) {
       break;
     if (TimedOut())
       break;
+    // JFS: Stop requested with `jfs_libfuzzer_stop()`.
+    if (JFSStopRequested())
+      break;
 
     // Update TmpMaxMutationLen
     if (Options.ExperimentalLenControl) {
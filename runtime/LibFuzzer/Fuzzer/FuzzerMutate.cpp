@@ -525,6 +525,12 @@ size_t MutationDispatcher::MutateImpl(uint8_t *Data, size_t Size,
   return 1;   // Fallback, should not happen frequently.
 }
 
+size_t MutationDispatcher::JFSGetNumUsedManualDictionaryEntries() const {
+  return std::count_if(
+      ManualDictionary.begin(), ManualDictionary.end(),
+      [](const DictionaryEntry &DE) { return DE.GetUseCount() > 0; });
+}
+
 void MutationDispatcher::AddWordToManualDictionary(const Word &W) {
   ManualDictionary.push_back(
       {W, std::numeric_limits<size_t>::max()});
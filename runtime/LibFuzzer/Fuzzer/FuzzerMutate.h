@@ -82,6 +82,9 @@ public:
 
   void PrintRecommendedDictionary();
 
+  // JFS: Number of -dict=DICT_FILE entries that have been used at least once.
+  size_t JFSGetNumUsedManualDictionaryEntries() const;
+
   void SetCorpus(const InputCorpus *Corpus) { this->Corpus = Corpus; }
 
   Random &GetRand() { return Rand; }
@@ -72,6 +72,7 @@ public:
     return BufferRef<uint8_t>(
         reinterpret_cast<uint8_t*>(const_cast<dataTy*>(&data)), sizeof(dataTy));
   }
+  uint64_t getRawBits() const { return data; }
   // Operators producing values of width != N
 
   // Repeat operation producing a width that is native
@@ -437,4 +438,42 @@ BitVector<BITWIDTH> makeBitVectorFrom(BufferRef<const uint8_t> buffer,
   return BitVector<BITWIDTH>(data);
 }
 
+// Like `makeBitVectorFrom(buffer, lowBit, highBit)` but the bit offsets are
+// known at compile time (see `readBitsFrom()`).
+template <uint64_t BITWIDTH, uint64_t LOWBIT, uint64_t HIGHBIT>
+BitVector<BITWIDTH> makeBitVectorFrom(BufferRef<const uint8_t> buffer) {
+  static_assert(((HIGHBIT - LOWBIT) + 1) == BITWIDTH, "wrong width");
+  return BitVector<BITWIDTH>(readBitsFrom<LOWBIT, HIGHBIT>(buffer));
+}
+
+// Make a BitVector where only some bits are stored in the buffer because the
+// others can't affect the constraints. Bits [LOWBIT, HIGHBIT] of `buffer`
+// become the bits starting at LIVELOWBIT and the other bits are zero.
+template <uint64_t BITWIDTH, uint64_t LIVELOWBIT, uint64_t LOWBIT,
+          uint64_t HIGHBIT>
+BitVector<BITWIDTH> makeBitVectorFromLiveBits(BufferRef<const uint8_t> buffer) {
+  static_assert(BITWIDTH <= JFS_NR_BITVECTOR_TY_BITWIDTH, "too many bits");
+  static_assert((LIVELOWBIT + (HIGHBIT - LOWBIT) + 1) <= BITWIDTH,
+                "live bits out of range");
+  return BitVector<BITWIDTH>(readBitsFrom<LOWBIT, HIGHBIT>(buffer)
+                             << LIVELOWBIT);
+}
+
+// Make a BitVector known to be in [RANGELOW, RANGEHIGH] (unsigned). Bits
+// [LOWBIT, HIGHBIT] of `buffer` store the offset from RANGELOW. Offsets past
+// RANGEHIGH wrap around so every buffer decodes to a value in the range.
+template <uint64_t BITWIDTH, uint64_t RANGELOW, uint64_t RANGEHIGH,
+          uint64_t LOWBIT, uint64_t HIGHBIT>
+BitVector<BITWIDTH> makeBitVectorInRangeFrom(BufferRef<const uint8_t> buffer) {
+  static_assert(BITWIDTH <= JFS_NR_BITVECTOR_TY_BITWIDTH, "too many bits");
+  static_assert(RANGELOW <= RANGEHIGH, "empty range");
+  static_assert((RANGEHIGH >> (BITWIDTH - 1)) <= 1, "range out of bounds");
+  const uint64_t span = RANGEHIGH - RANGELOW;
+  uint64_t offset = readBitsFrom<LOWBIT, HIGHBIT>(buffer);
+  // Every offset is in range when the span is all ones.
+  if ((span & (span + 1)) != 0)
+    offset %= (span + 1);
+  return BitVector<BITWIDTH>(RANGELOW + offset);
+}
+
 #endif
@@ -10,7 +10,10 @@
 //===----------------------------------------------------------------------===//
 #ifndef JFS_RUNTIME_SMTLIB_BUFFER_REF_H
 #define JFS_RUNTIME_SMTLIB_BUFFER_REF_H
+#include "jassert.h"
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 template <typename T> class BufferRef {
 private:
@@ -24,4 +27,29 @@ public:
   size_t getSize() const { return size; }
 };
 
+// Read bits [LOWBIT, HIGHBIT] of `buffer` where bit 0 is the least
+// significant bit of the first byte. Because the bit offsets are template
+// parameters the compiler can fold this into a (possibly unaligned) load,
+// a shift and a mask. Like `jfs_nr_make_bitvector()` this assumes a
+// little-endian host.
+template <uint64_t LOWBIT, uint64_t HIGHBIT>
+uint64_t readBitsFrom(BufferRef<const uint8_t> buffer) {
+  static_assert(HIGHBIT >= LOWBIT, "invalid LOWBIT and HIGHBIT");
+  static_assert(((HIGHBIT - LOWBIT) + 1) <= 64, "too many bits");
+  jassert(HIGHBIT < (buffer.getSize() * 8));
+  const uint64_t bitWidth = (HIGHBIT - LOWBIT) + 1;
+  const uint64_t shiftOffset = LOWBIT % 8;
+  // Only 64 bits wide reads that aren't byte aligned touch a ninth byte.
+  const uint64_t numBytes = (shiftOffset + bitWidth + 7) / 8;
+  const uint8_t* bytes = buffer.get() + (LOWBIT / 8);
+  uint64_t data = 0;
+  memcpy(&data, bytes, numBytes < 8 ? numBytes : 8);
+  if (shiftOffset != 0) {
+    data >>= shiftOffset;
+    if (numBytes > 8)
+      data |= static_cast<uint64_t>(bytes[8]) << (64 - shiftOffset);
+  }
+  return data & (UINT64_MAX >> (64 - bitWidth));
+}
+
 #endif
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "SMTLIB/ConstantTable.h"
+#include "jassert.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const uint64_t* jfs_constant_table = nullptr;
+
+int jfs_load_constant_table(int* argc, char*** argv, uint64_t expectedSize) {
+  const char flag[] = "--jfs_constants=";
+  const char* path = nullptr;
+  for (int index = 0; index < *argc; ++index) {
+    const char* arg = (*argv)[index];
+    if (strncmp(arg, flag, sizeof(flag) - 1) == 0) {
+      path = arg + sizeof(flag) - 1;
+    }
+  }
+  if (path == nullptr) {
+    fprintf(stderr, "JFS constant table not specified\n");
+    JFS_RUNTIME_FAIL();
+  }
+  // Allocate at least one element so that an empty table is non-null.
+  size_t allocSize = expectedSize > 0 ? expectedSize : 1;
+  uint64_t* table = (uint64_t*)malloc(sizeof(uint64_t) * allocSize);
+  FILE* f = fopen(path, "rb");
+  if (table == nullptr || f == nullptr) {
+    fprintf(stderr, "Failed to open JFS constant table \"%s\"\n", path);
+    JFS_RUNTIME_FAIL();
+  }
+  size_t numRead = fread(table, sizeof(uint64_t), expectedSize, f);
+  // The table should contain exactly `expectedSize` values.
+  bool atEnd = fgetc(f) == EOF;
+  fclose(f);
+  if (numRead != expectedSize || !atEnd) {
+    fprintf(stderr,
+            "JFS constant table \"%s\" does not contain %llu constants\n", path,
+            (unsigned long long)expectedSize);
+    JFS_RUNTIME_FAIL();
+  }
+  jfs_constant_table = table;
+  return 0;
+}
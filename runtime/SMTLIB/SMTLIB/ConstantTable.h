@@ -0,0 +1,26 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_RUNTIME_SMTLIB_CONSTANT_TABLE_H
+#define JFS_RUNTIME_SMTLIB_CONSTANT_TABLE_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Programs generated with constants lifted out read their constant values
+// from this table rather than having them compiled in. This lets programs
+// that only differ in their constants share a binary.
+extern const uint64_t* jfs_constant_table;
+
+// Load `jfs_constant_table` from the file named by the
+// `--jfs_constants=<path>` argument in `argv`. The file contains
+// `expectedSize` host endian `uint64_t` values. Intended to be called from
+// `LLVMFuzzerInitialize()`. On failure the program exits.
+int jfs_load_constant_table(int* argc, char*** argv, uint64_t expectedSize);
+#endif
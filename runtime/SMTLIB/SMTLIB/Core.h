@@ -19,4 +19,12 @@
 
 bool makeBoolFrom(BufferRef<const uint8_t> buffer, const uint64_t lowBit,
                   const uint64_t highBit);
+
+// Like `makeBoolFrom(buffer, lowBit, highBit)` but the bit offsets are known
+// at compile time (see `readBitsFrom()`).
+template <uint64_t LOWBIT, uint64_t HIGHBIT>
+bool makeBoolFrom(BufferRef<const uint8_t> buffer) {
+  static_assert(((HIGHBIT - LOWBIT) + 1) <= 8, "Too many bits");
+  return readBitsFrom<LOWBIT, HIGHBIT>(buffer) != 0;
+}
 #endif
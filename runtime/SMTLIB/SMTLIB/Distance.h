@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_RUNTIME_SMTLIB_DISTANCE_H
+#define JFS_RUNTIME_SMTLIB_DISTANCE_H
+#include "BitVector.h"
+#include "Float.h"
+#include <stdint.h>
+
+// Feedback on how close an input is to satisfying a comparison. Each
+// comparison owns `JFS_DISTANCE_COUNTERS_PER_CMP` LibFuzzer extra counters.
+// The counter for the number of significant bits of the distance is set so
+// that an input that gets a comparison closer than any previous input gives
+// LibFuzzer a new feature and is kept in the corpus. A distance of zero means
+// the comparison is satisfied.
+#define JFS_DISTANCE_COUNTERS_PER_CMP 65
+
+inline void jfs_record_distance(uint8_t* counters, uint64_t distance) {
+  counters[distance == 0 ? 0 : (64 - __builtin_clzll(distance))] = 1;
+}
+
+// Bitvectors
+
+template <uint64_t N>
+uint64_t jfs_distance_bv_eq(const BitVector<N>& lhs, const BitVector<N>& rhs) {
+  const uint64_t a = lhs.getRawBits();
+  const uint64_t b = rhs.getRawBits();
+  return a > b ? (a - b) : (b - a);
+}
+
+template <uint64_t N>
+uint64_t jfs_distance_bvult(const BitVector<N>& lhs, const BitVector<N>& rhs) {
+  const uint64_t a = lhs.getRawBits();
+  const uint64_t b = rhs.getRawBits();
+  return a < b ? 0 : (a - b) + 1;
+}
+
+template <uint64_t N>
+uint64_t jfs_distance_bvule(const BitVector<N>& lhs, const BitVector<N>& rhs) {
+  const uint64_t a = lhs.getRawBits();
+  const uint64_t b = rhs.getRawBits();
+  return a <= b ? 0 : (a - b);
+}
+
+// Flipping the sign bit maps signed order onto unsigned order.
+template <uint64_t N>
+uint64_t jfs_distance_bvslt(const BitVector<N>& lhs, const BitVector<N>& rhs) {
+  const uint64_t signBit = UINT64_C(1) << (N - 1);
+  const uint64_t a = lhs.getRawBits() ^ signBit;
+  const uint64_t b = rhs.getRawBits() ^ signBit;
+  return a < b ? 0 : (a - b) + 1;
+}
+
+template <uint64_t N>
+uint64_t jfs_distance_bvsle(const BitVector<N>& lhs, const BitVector<N>& rhs) {
+  const uint64_t signBit = UINT64_C(1) << (N - 1);
+  const uint64_t a = lhs.getRawBits() ^ signBit;
+  const uint64_t b = rhs.getRawBits() ^ signBit;
+  return a <= b ? 0 : (a - b);
+}
+
+// Floating point. Distances are in ULPs. Comparisons involving NaN are as
+// far from being satisfied as possible unless they are SMT-LIB equality
+// (`=`) of two NaNs.
+
+// Map a non-NaN float onto an integer so that adjacent floats are adjacent
+// integers and +0 and -0 are the same integer.
+template <uint64_t EB, uint64_t SB>
+int64_t jfs_float_to_ordered(const Float<EB, SB>& f) {
+  const uint64_t signBit = UINT64_C(1) << (EB + SB - 1);
+  const uint64_t bits = f.getRawBits();
+  const int64_t magnitude = static_cast<int64_t>(bits & (signBit - 1));
+  return (bits & signBit) ? -magnitude : magnitude;
+}
+
+inline uint64_t jfs_ordered_difference(int64_t a, int64_t b) {
+  // Unsigned arithmetic so the difference can't overflow.
+  return static_cast<uint64_t>(a) - static_cast<uint64_t>(b);
+}
+
+template <uint64_t EB, uint64_t SB>
+uint64_t jfs_distance_fp_smt_eq(const Float<EB, SB>& lhs,
+                                const Float<EB, SB>& rhs) {
+  if (lhs.isNaN() || rhs.isNaN())
+    return (lhs.isNaN() && rhs.isNaN()) ? 0 : UINT64_MAX;
+  // Unlike IEEE equality -0 and +0 are not equal.
+  if (lhs.isZero() && rhs.isZero())
+    return lhs.getRawBits() == rhs.getRawBits() ? 0 : 1;
+  const int64_t a = jfs_float_to_ordered(lhs);
+  const int64_t b = jfs_float_to_ordered(rhs);
+  return a > b ? jfs_ordered_difference(a, b) : jfs_ordered_difference(b, a);
+}
+
+template <uint64_t EB, uint64_t SB>
+uint64_t jfs_distance_fp_eq(const Float<EB, SB>& lhs,
+                            const Float<EB, SB>& rhs) {
+  if (lhs.isNaN() || rhs.isNaN())
+    return UINT64_MAX;
+  const int64_t a = jfs_float_to_ordered(lhs);
+  const int64_t b = jfs_float_to_ordered(rhs);
+  return a > b ? jfs_ordered_difference(a, b) : jfs_ordered_difference(b, a);
+}
+
+template <uint64_t EB, uint64_t SB>
+uint64_t jfs_distance_fp_lt(const Float<EB, SB>& lhs,
+                            const Float<EB, SB>& rhs) {
+  if (lhs.isNaN() || rhs.isNaN())
+    return UINT64_MAX;
+  const int64_t a = jfs_float_to_ordered(lhs);
+  const int64_t b = jfs_float_to_ordered(rhs);
+  return a < b ? 0 : jfs_ordered_difference(a, b) + 1;
+}
+
+template <uint64_t EB, uint64_t SB>
+uint64_t jfs_distance_fp_leq(const Float<EB, SB>& lhs,
+                             const Float<EB, SB>& rhs) {
+  if (lhs.isNaN() || rhs.isNaN())
+    return UINT64_MAX;
+  const int64_t a = jfs_float_to_ordered(lhs);
+  const int64_t b = jfs_float_to_ordered(rhs);
+  return a <= b ? 0 : jfs_ordered_difference(a, b);
+}
+#endif
@@ -14,6 +14,7 @@
 #include "BufferRef.h"
 #include "NativeFloat.h"
 #include <stdint.h>
+#include <string.h>
 #include <type_traits>
 
 // Arbitary precision floating point with
@@ -298,4 +299,29 @@ Float32 makeFloatFrom(BufferRef<const uint8_t> buffer, uint64_t lowBit,
 template <>
 Float64 makeFloatFrom(BufferRef<const uint8_t> buffer, uint64_t lowBit,
                       uint64_t highBit);
+
+// The native type used to store `Float<EB, SB>`.
+template <uint64_t EB, uint64_t SB> struct NativeFloatTy {};
+template <> struct NativeFloatTy<8, 24> { typedef jfs_nr_float32 type; };
+template <> struct NativeFloatTy<11, 53> { typedef jfs_nr_float64 type; };
+
+// Like `makeFloatFrom(buffer, lowBit, highBit)` but the bit offsets are known
+// at compile time. When the float starts on a byte boundary this is just a
+// `memcpy()`.
+template <uint64_t EB, uint64_t SB, uint64_t LOWBIT, uint64_t HIGHBIT>
+Float<EB, SB> makeFloatFrom(BufferRef<const uint8_t> buffer) {
+  typedef typename NativeFloatTy<EB, SB>::type NativeTy;
+  static_assert(((HIGHBIT - LOWBIT) + 1) == (EB + SB), "wrong width");
+  static_assert((sizeof(NativeTy) * 8) == (EB + SB), "wrong native type");
+  NativeTy value;
+  if ((LOWBIT % 8) == 0) {
+    jassert(HIGHBIT < (buffer.getSize() * 8));
+    memcpy(&value, buffer.get() + (LOWBIT / 8), sizeof(NativeTy));
+  } else {
+    // Assumes a little-endian host.
+    const uint64_t bits = readBitsFrom<LOWBIT, HIGHBIT>(buffer);
+    memcpy(&value, &bits, sizeof(NativeTy));
+  }
+  return Float<EB, SB>(value);
+}
 #endif
@@ -0,0 +1,227 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "SMTLIB/Mutator.h"
+#include "jassert.h"
+#include <random>
+#include <string.h>
+
+// Provided by LibFuzzer.
+extern "C" size_t LLVMFuzzerMutate(uint8_t* data, size_t size, size_t maxSize);
+
+namespace {
+typedef std::minstd_rand RNGTy;
+
+uint64_t getMask(uint32_t bitWidth) {
+  return bitWidth >= 64 ? ~UINT64_C(0) : ((UINT64_C(1) << bitWidth) - 1);
+}
+
+uint64_t getRandom64(RNGTy& rng) {
+  // `minstd_rand` only gives 31 random bits per call.
+  return (static_cast<uint64_t>(rng()) << 62) ^
+         (static_cast<uint64_t>(rng()) << 31) ^ static_cast<uint64_t>(rng());
+}
+
+size_t getBufferSize(const jfs_buffer_element* layout, size_t layoutSize) {
+  uint64_t numBits = 0;
+  for (size_t index = 0; index < layoutSize; ++index) {
+    uint64_t endBit = layout[index].bitOffset + layout[index].bitWidth;
+    numBits = endBit > numBits ? endBit : numBits;
+  }
+  return (numBits + 7) / 8;
+}
+
+uint64_t readBits(const uint8_t* data, uint64_t bitOffset, uint32_t bitWidth) {
+  jassert(bitWidth <= 64);
+  uint64_t value = 0;
+  for (uint32_t index = 0; index < bitWidth; ++index) {
+    uint64_t bit = bitOffset + index;
+    value |= static_cast<uint64_t>((data[bit / 8] >> (bit % 8)) & 1) << index;
+  }
+  return value;
+}
+
+void writeBits(uint8_t* data, uint64_t bitOffset, uint32_t bitWidth,
+               uint64_t value) {
+  jassert(bitWidth <= 64);
+  for (uint32_t index = 0; index < bitWidth; ++index) {
+    uint64_t bit = bitOffset + index;
+    uint8_t mask = 1 << (bit % 8);
+    if ((value >> index) & 1)
+      data[bit / 8] |= mask;
+    else
+      data[bit / 8] &= ~mask;
+  }
+}
+
+void copyBits(uint8_t* dest, const uint8_t* src, uint64_t bitOffset,
+              uint32_t bitWidth) {
+  for (uint32_t done = 0; done < bitWidth; done += 64) {
+    uint32_t chunkWidth = (bitWidth - done) < 64 ? (bitWidth - done) : 64;
+    writeBits(dest, bitOffset + done, chunkWidth,
+              readBits(src, bitOffset + done, chunkWidth));
+  }
+}
+
+uint64_t mutateBitVector(RNGTy& rng, uint64_t value, uint32_t bitWidth) {
+  jassert(bitWidth > 0 && bitWidth <= 64);
+  const uint64_t signBit = UINT64_C(1) << (bitWidth - 1);
+  switch (rng() % 4) {
+  case 0: {
+    // Boundary values
+    const uint64_t boundaries[] = {
+        0,                 // zero
+        1,                 // one
+        getMask(bitWidth), // unsigned max (i.e. -1)
+        signBit,           // signed min
+        signBit - 1,       // signed max
+    };
+    return boundaries[rng() % (sizeof(boundaries) / sizeof(uint64_t))];
+  }
+  case 1: {
+    // Small arithmetic delta. Wraps around like bitvector arithmetic.
+    uint64_t delta = 1 + (rng() % 16);
+    return (rng() % 2) ? (value + delta) : (value - delta);
+  }
+  case 2:
+    return value ^ (UINT64_C(1) << (rng() % bitWidth));
+  default:
+    return getRandom64(rng);
+  }
+}
+
+uint64_t mutateFloat(RNGTy& rng, uint64_t value, uint32_t exponentBits,
+                     uint32_t significandBits) {
+  // IEEE-754 layout: sign | exponent | significand (without hidden bit).
+  const uint32_t storedSignificandBits = significandBits - 1;
+  const uint64_t signBit = UINT64_C(1)
+                           << (exponentBits + storedSignificandBits);
+  const uint64_t significandMask = getMask(storedSignificandBits);
+  const uint64_t maxExponent = getMask(exponentBits);
+  const uint64_t exponentMask = maxExponent << storedSignificandBits;
+  const uint64_t magnitude = value & ~signBit;
+  switch (rng() % 4) {
+  case 0: {
+    // Special values with a random sign.
+    const uint64_t quietBit = UINT64_C(1) << (storedSignificandBits - 1);
+    const uint64_t minNormal = UINT64_C(1) << storedSignificandBits;
+    const uint64_t specials[] = {
+        0,                                             // zero
+        exponentMask,                                  // infinity
+        exponentMask | quietBit,                       // NaN
+        1,                                             // min subnormal
+        significandMask,                               // max subnormal
+        minNormal,                                     // min normal
+        (exponentMask - minNormal) | significandMask,  // max normal
+        (maxExponent >> 1) << storedSignificandBits,   // one
+    };
+    uint64_t special = specials[rng() % (sizeof(specials) / sizeof(uint64_t))];
+    return (rng() % 2) ? (special | signBit) : special;
+  }
+  case 1: {
+    // Step to an adjacent float. Finite floats of the same sign are ordered
+    // like their bit patterns so this moves by one ULP.
+    if ((rng() % 2) && magnitude < exponentMask)
+      return value + 1;
+    if (magnitude > 0)
+      return value - 1;
+    return value ^ signBit;
+  }
+  case 2:
+    return value ^ signBit;
+  default: {
+    // Scale by a small power of two.
+    uint64_t exponent = (value & exponentMask) >> storedSignificandBits;
+    uint64_t delta = 1 + (rng() % 4);
+    if (rng() % 2)
+      exponent = (maxExponent - exponent) > delta ? (exponent + delta)
+                                                  : maxExponent;
+    else
+      exponent = exponent > delta ? (exponent - delta) : 0;
+    return (value & ~exponentMask) | (exponent << storedSignificandBits);
+  }
+  }
+}
+
+void mutateElement(RNGTy& rng, const jfs_buffer_element& e, uint8_t* data) {
+  uint64_t bitOffset = e.bitOffset;
+  uint32_t bitWidth = e.bitWidth;
+  if (bitWidth == 0)
+    return;
+  if (bitWidth > 64) {
+    // Wide elements are mutated one 64-bit chunk at a time.
+    uint32_t chunk = rng() % ((bitWidth + 63) / 64);
+    bitOffset += chunk * 64;
+    bitWidth = (bitWidth - (chunk * 64)) < 64 ? (bitWidth - (chunk * 64)) : 64;
+    uint64_t value = readBits(data, bitOffset, bitWidth);
+    writeBits(data, bitOffset, bitWidth,
+              mutateBitVector(rng, value, bitWidth));
+    return;
+  }
+  uint64_t value = readBits(data, bitOffset, bitWidth);
+  switch (e.kind) {
+  case JFS_BUFFER_ELEMENT_BOOL:
+    value = ~value;
+    break;
+  case JFS_BUFFER_ELEMENT_FLOAT:
+    if (e.exponentBits >= 2 && e.significandBits >= 2 &&
+        (e.exponentBits + e.significandBits) == bitWidth) {
+      value = mutateFloat(rng, value, e.exponentBits, e.significandBits);
+      break;
+    }
+    value = mutateBitVector(rng, value, bitWidth);
+    break;
+  default:
+    value = mutateBitVector(rng, value, bitWidth);
+  }
+  writeBits(data, bitOffset, bitWidth, value & getMask(bitWidth));
+}
+}
+
+size_t jfs_custom_mutate(const jfs_buffer_element* layout, size_t layoutSize,
+                         uint8_t* data, size_t size, size_t maxSize,
+                         unsigned int seed) {
+  RNGTy rng(seed);
+  const size_t bufferSize = getBufferSize(layout, layoutSize);
+  // Leave a quarter of the mutations (and inputs we can't make large enough)
+  // to LibFuzzer's own mutators so they can still make progress on
+  // constraints that relate bits of different variables.
+  if (layoutSize == 0 || bufferSize > maxSize || (rng() % 4) == 0)
+    return LLVMFuzzerMutate(data, size, maxSize);
+  if (size < bufferSize)
+    memset(data + size, 0, bufferSize - size);
+  // Usually mutate a single variable.
+  unsigned numMutations = 1;
+  if ((rng() % 8) == 0)
+    numMutations += 1 + (rng() % 3);
+  for (unsigned index = 0; index < numMutations; ++index) {
+    mutateElement(rng, layout[rng() % layoutSize], data);
+  }
+  // Bytes beyond the buffer are never read so drop them.
+  return bufferSize;
+}
+
+size_t jfs_custom_cross_over(const jfs_buffer_element* layout,
+                             size_t layoutSize, const uint8_t* data1,
+                             size_t size1, const uint8_t* data2, size_t size2,
+                             uint8_t* out, size_t maxOutSize,
+                             unsigned int seed) {
+  RNGTy rng(seed);
+  const size_t bufferSize = getBufferSize(layout, layoutSize);
+  if (layoutSize == 0 || bufferSize > maxOutSize || size1 < bufferSize ||
+      size2 < bufferSize)
+    return 0;
+  memcpy(out, data1, bufferSize);
+  for (size_t index = 0; index < layoutSize; ++index) {
+    if (rng() % 2)
+      copyBits(out, data2, layout[index].bitOffset, layout[index].bitWidth);
+  }
+  return bufferSize;
+}
@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_RUNTIME_SMTLIB_MUTATOR_H
+#define JFS_RUNTIME_SMTLIB_MUTATOR_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Mutators that know where each free variable lives in the fuzzing input.
+// Generated programs emit a layout table describing the buffer and forward
+// `LLVMFuzzerCustomMutator()` and `LLVMFuzzerCustomCrossOver()` to the
+// functions below.
+
+enum jfs_buffer_element_kind {
+  JFS_BUFFER_ELEMENT_BOOL = 0,
+  JFS_BUFFER_ELEMENT_BITVECTOR = 1,
+  JFS_BUFFER_ELEMENT_FLOAT = 2,
+};
+
+// A free variable in the buffer. Bits are numbered from the least
+// significant bit of the first byte, the same as `makeBitVectorFrom()`.
+struct jfs_buffer_element {
+  uint32_t kind; // A `jfs_buffer_element_kind`
+  uint64_t bitOffset;
+  uint32_t bitWidth;
+  // Only used by JFS_BUFFER_ELEMENT_FLOAT. `significandBits` includes the
+  // hidden bit, as in SMT-LIB.
+  uint32_t exponentBits;
+  uint32_t significandBits;
+};
+
+// Mutate `data` in place, one variable at a time, using mutations suited to
+// the variable's sort. Some mutations are left to LibFuzzer's byte level
+// mutators. Returns the new size of `data` which is at most `maxSize`.
+size_t jfs_custom_mutate(const jfs_buffer_element* layout, size_t layoutSize,
+                         uint8_t* data, size_t size, size_t maxSize,
+                         unsigned int seed);
+
+// Write to `out` an input that takes each variable from either `data1` or
+// `data2`. Returns the size of `out` or zero if the inputs are too small.
+size_t jfs_custom_cross_over(const jfs_buffer_element* layout,
+                             size_t layoutSize, const uint8_t* data1,
+                             size_t size1, const uint8_t* data2, size_t size2,
+                             uint8_t* out, size_t maxOutSize,
+                             unsigned int seed);
+#endif
@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "SMTLIB/RejectionProfile.h"
+#include "jassert.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+const char* profilePath = nullptr;
+const uint64_t* profileCounts = nullptr;
+uint64_t profileNumCounts = 0;
+
+// LibFuzzer calls `exit()` once it is done fuzzing so this runs when the
+// fuzzer stops at `-max_total_time`.
+void writeRejectionProfile() {
+  FILE* f = fopen(profilePath, "w");
+  if (f == nullptr) {
+    fprintf(stderr, "Failed to open JFS rejection profile \"%s\"\n",
+            profilePath);
+    return;
+  }
+  for (uint64_t index = 0; index < profileNumCounts; ++index) {
+    fprintf(f, "%llu\n", (unsigned long long)profileCounts[index]);
+  }
+  fclose(f);
+}
+}
+
+void jfs_setup_rejection_profile(int* argc, char*** argv,
+                                 const uint64_t* counts, uint64_t numCounts) {
+  const char flag[] = "--jfs_rejection_profile=";
+  for (int index = 0; index < *argc; ++index) {
+    const char* arg = (*argv)[index];
+    if (strncmp(arg, flag, sizeof(flag) - 1) == 0) {
+      profilePath = arg + sizeof(flag) - 1;
+    }
+  }
+  if (profilePath == nullptr)
+    return;
+  profileCounts = counts;
+  profileNumCounts = numCounts;
+  if (atexit(writeRejectionProfile) != 0) {
+    fprintf(stderr, "Failed to register JFS rejection profile writer\n");
+    JFS_RUNTIME_FAIL();
+  }
+}
@@ -0,0 +1,26 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_RUNTIME_SMTLIB_REJECTION_PROFILE_H
+#define JFS_RUNTIME_SMTLIB_REJECTION_PROFILE_H
+#include <stddef.h>
+#include <stdint.h>
+
+// Programs generated to record rejections count, for each constraint, how
+// many inputs it was the first constraint not to be satisfied by in
+// `counts[0, numCounts - 1)`. The last element counts every input.
+
+// If `argv` contains a `--jfs_rejection_profile=<path>` argument then write
+// `counts` to `<path>` when the program exits, one decimal value per line.
+// Intended to be called from `LLVMFuzzerInitialize()`. On failure the
+// program exits.
+void jfs_setup_rejection_profile(int* argc, char*** argv,
+                                 const uint64_t* counts, uint64_t numCounts);
+#endif
@@ -0,0 +1,26 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_RUNTIME_SMTLIB_RUNTIME_H
+#define JFS_RUNTIME_SMTLIB_RUNTIME_H
+// Umbrella header for the whole runtime. This is what the precompiled
+// headers used by `jfs` are built from. Generated programs include the
+// individual headers they need.
+#include "SMTLIB/BitVector.h"
+#include "SMTLIB/ConstantTable.h"
+#include "SMTLIB/Core.h"
+#include "SMTLIB/Distance.h"
+#include "SMTLIB/Float.h"
+#include "SMTLIB/Mutator.h"
+#include "SMTLIB/RejectionProfile.h"
+#include "SMTLIB/TraceCmp.h"
+#include <stdint.h>
+#include <stdlib.h>
+#endif
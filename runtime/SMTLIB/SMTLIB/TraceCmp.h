@@ -0,0 +1,43 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#ifndef JFS_RUNTIME_SMTLIB_TRACE_CMP_H
+#define JFS_RUNTIME_SMTLIB_TRACE_CMP_H
+#include "Float.h"
+#include <stdint.h>
+
+// SanitizerCoverage's `trace-cmp` only instruments integer comparisons so
+// floating point comparisons are traced by hand. The operands are passed as
+// their raw bits. That is how floats are stored in the fuzzing input so
+// LibFuzzer can substitute one operand for the other when it mutates using
+// its table of recently compared values (`-use_cmp=1`).
+//
+// The hooks are normally provided by LibFuzzer. They are weak so programs
+// that are not linked against it still link.
+extern "C" {
+__attribute__((weak)) void __sanitizer_cov_trace_cmp4(uint32_t arg1,
+                                                      uint32_t arg2);
+__attribute__((weak)) void __sanitizer_cov_trace_cmp8(uint64_t arg1,
+                                                      uint64_t arg2);
+}
+
+// Always inlined so LibFuzzer sees a different caller for every comparison.
+__attribute__((always_inline)) inline void
+jfs_trace_fp_cmp(const Float32& lhs, const Float32& rhs) {
+  if (__sanitizer_cov_trace_cmp4)
+    __sanitizer_cov_trace_cmp4(lhs.getRawBits(), rhs.getRawBits());
+}
+
+__attribute__((always_inline)) inline void
+jfs_trace_fp_cmp(const Float64& lhs, const Float64& rhs) {
+  if (__sanitizer_cov_trace_cmp8)
+    __sanitizer_cov_trace_cmp8(lhs.getRawBits(), rhs.getRawBits());
+}
+#endif
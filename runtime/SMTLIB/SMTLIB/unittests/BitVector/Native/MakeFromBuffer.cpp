@@ -121,3 +121,68 @@ MAKE_FROM_LARGE(3, 1990, true)
 MAKE_FROM_LARGE(3, 1990, false)
 MAKE_FROM_LARGE(4, 1990, true)
 MAKE_FROM_LARGE(4, 1990, false)
+
+TEST(MakeFromBuffer, ConstantOffsets) {
+  uint8_t buffer[17];
+  for (unsigned index = 0; index < sizeof(buffer); ++index) {
+    buffer[index] = static_cast<uint8_t>((index * 37) + 11);
+  }
+  BufferRef<const uint8_t> bufferRef(buffer, sizeof(buffer));
+#define CHECK_CONSTANT_OFFSET(N, L)                                            \
+  {                                                                            \
+    BitVector<N> a = makeBitVectorFrom<N, L, L + (N - 1)>(bufferRef);          \
+    BitVector<N> b = makeBitVectorFrom<N>(bufferRef, L, L + (N - 1));          \
+    ASSERT_EQ(a, b);                                                           \
+  }
+  CHECK_CONSTANT_OFFSET(1, 0)
+  CHECK_CONSTANT_OFFSET(1, 7)
+  CHECK_CONSTANT_OFFSET(3, 6)
+  CHECK_CONSTANT_OFFSET(8, 0)
+  CHECK_CONSTANT_OFFSET(8, 5)
+  CHECK_CONSTANT_OFFSET(17, 3)
+  CHECK_CONSTANT_OFFSET(32, 0)
+  CHECK_CONSTANT_OFFSET(32, 17)
+  CHECK_CONSTANT_OFFSET(57, 7)
+  CHECK_CONSTANT_OFFSET(63, 1)
+  CHECK_CONSTANT_OFFSET(64, 0)
+  CHECK_CONSTANT_OFFSET(64, 8)
+  CHECK_CONSTANT_OFFSET(64, 1)
+  CHECK_CONSTANT_OFFSET(64, 7)
+  CHECK_CONSTANT_OFFSET(64, 72)
+#undef CHECK_CONSTANT_OFFSET
+}
+
+TEST(MakeFromBuffer, LiveBits) {
+  uint8_t buffer[2];
+  buffer[0] = 0b10101100;
+  buffer[1] = 0b00000011;
+  BufferRef<const uint8_t> bufferRef(buffer, 2);
+  // Bits [9:2] of the buffer become bits [11:4] of the result.
+  BitVector<16> a = makeBitVectorFromLiveBits<16, 4, 2, 9>(bufferRef);
+  ASSERT_EQ(a, 0xeb0);
+  BitVector<64> b = makeBitVectorFromLiveBits<64, 0, 0, 15>(bufferRef);
+  ASSERT_EQ(b, 0x3ac);
+}
+
+TEST(MakeFromBuffer, InRange) {
+  uint8_t buffer[2];
+  buffer[0] = 0b10101100;
+  buffer[1] = 0b00000011;
+  BufferRef<const uint8_t> bufferRef(buffer, 2);
+  // The span is all ones so the offset is used as is.
+  BitVector<16> a = makeBitVectorInRangeFrom<16, 1000, 1255, 0, 7>(bufferRef);
+  ASSERT_EQ(a, 1172);
+  // Offsets past the end of the range wrap around.
+  BitVector<16> b = makeBitVectorInRangeFrom<16, 1000, 1100, 0, 7>(bufferRef);
+  ASSERT_EQ(b, 1000 + (172 % 101));
+  BitVector<32> c = makeBitVectorInRangeFrom<32, 5, 5, 0, 0>(bufferRef);
+  ASSERT_EQ(c, 5);
+  BitVector<8> d = makeBitVectorInRangeFrom<8, 200, 255, 2, 7>(bufferRef);
+  ASSERT_EQ(d, 200 + 0b101011);
+  uint8_t allOnes[8];
+  memset(allOnes, 0xff, sizeof(allOnes));
+  BufferRef<const uint8_t> allOnesRef(allOnes, sizeof(allOnes));
+  BitVector<64> e =
+      makeBitVectorInRangeFrom<64, 1, UINT64_MAX, 0, 63>(allOnesRef);
+  ASSERT_EQ(e, 1);
+}
@@ -169,3 +169,18 @@ MAKE_FROM_LARGE(5, 1024, false)
 MAKE_FROM_LARGE(6, 1024, false)
 MAKE_FROM_LARGE(7, 1024, false)
 MAKE_FROM_LARGE(8, 1024, false)
+
+TEST(MakeFromBuffer, ConstantOffsets) {
+  uint8_t buffer[3];
+  buffer[0] = 0b10000000;
+  buffer[1] = 0b00000001;
+  buffer[2] = 0b00000000;
+  BufferRef<const uint8_t> bufferRef(buffer, 3);
+  ASSERT_EQ((makeBoolFrom<0, 0>(bufferRef)), false);
+  ASSERT_EQ((makeBoolFrom<7, 7>(bufferRef)), true);
+  ASSERT_EQ((makeBoolFrom<8, 8>(bufferRef)), true);
+  ASSERT_EQ((makeBoolFrom<9, 15>(bufferRef)), false);
+  ASSERT_EQ((makeBoolFrom<3, 10>(bufferRef)), true);
+  ASSERT_EQ((makeBoolFrom<9, 16>(bufferRef)), false);
+  ASSERT_EQ((makeBoolFrom<16, 23>(bufferRef)), false);
+}
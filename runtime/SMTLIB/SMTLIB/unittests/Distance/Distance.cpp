@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "SMTLIB/Distance.h"
+#include "gtest/gtest.h"
+#include <math.h>
+#include <string.h>
+
+TEST(Distance, RecordDistance) {
+  uint8_t counters[JFS_DISTANCE_COUNTERS_PER_CMP];
+  memset(counters, 0, sizeof(counters));
+  jfs_record_distance(counters, 0);
+  jfs_record_distance(counters, 1);
+  jfs_record_distance(counters, 6);
+  jfs_record_distance(counters, UINT64_MAX);
+  for (unsigned index = 0; index < JFS_DISTANCE_COUNTERS_PER_CMP; ++index) {
+    bool expected = index == 0 || index == 1 || index == 3 || index == 64;
+    ASSERT_EQ(counters[index], expected ? 1 : 0);
+  }
+}
+
+TEST(Distance, BitVectorEqual) {
+  ASSERT_EQ(jfs_distance_bv_eq(BitVector<8>(5), BitVector<8>(5)), 0u);
+  ASSERT_EQ(jfs_distance_bv_eq(BitVector<8>(5), BitVector<8>(9)), 4u);
+  ASSERT_EQ(jfs_distance_bv_eq(BitVector<8>(9), BitVector<8>(5)), 4u);
+  ASSERT_EQ(jfs_distance_bv_eq(BitVector<64>(0), BitVector<64>(UINT64_MAX)),
+            UINT64_MAX);
+}
+
+TEST(Distance, BitVectorUnsigned) {
+  ASSERT_EQ(jfs_distance_bvult(BitVector<8>(1), BitVector<8>(2)), 0u);
+  ASSERT_EQ(jfs_distance_bvult(BitVector<8>(2), BitVector<8>(2)), 1u);
+  ASSERT_EQ(jfs_distance_bvult(BitVector<8>(5), BitVector<8>(2)), 4u);
+  ASSERT_EQ(jfs_distance_bvule(BitVector<8>(2), BitVector<8>(2)), 0u);
+  ASSERT_EQ(jfs_distance_bvule(BitVector<8>(5), BitVector<8>(2)), 3u);
+}
+
+TEST(Distance, BitVectorSigned) {
+  // -1 < 0
+  ASSERT_EQ(jfs_distance_bvslt(BitVector<8>(0xff), BitVector<8>(0)), 0u);
+  // 0 < -1 is one away from 0 < 0
+  ASSERT_EQ(jfs_distance_bvslt(BitVector<8>(0), BitVector<8>(0xff)), 2u);
+  ASSERT_EQ(jfs_distance_bvsle(BitVector<8>(0x80), BitVector<8>(0x7f)), 0u);
+  ASSERT_EQ(jfs_distance_bvsle(BitVector<8>(0x7f), BitVector<8>(0x80)),
+            0xffu);
+}
+
+TEST(Distance, FloatULPs) {
+  Float32 one(1.0f);
+  Float32 next(nextafterf(1.0f, 2.0f));
+  ASSERT_EQ(jfs_distance_fp_eq(one, one), 0u);
+  ASSERT_EQ(jfs_distance_fp_eq(one, next), 1u);
+  ASSERT_EQ(jfs_distance_fp_eq(next, one), 1u);
+  // The smallest subnormals either side of zero are two ULPs apart.
+  Float64 minSubnormal(nextafter(0.0, 1.0));
+  ASSERT_EQ(jfs_distance_fp_eq(minSubnormal, minSubnormal.neg()), 2u);
+  ASSERT_EQ(jfs_distance_fp_lt(one, next), 0u);
+  ASSERT_EQ(jfs_distance_fp_lt(next, one), 2u);
+  ASSERT_EQ(jfs_distance_fp_leq(one, one), 0u);
+  ASSERT_EQ(jfs_distance_fp_leq(next, one), 1u);
+}
+
+TEST(Distance, FloatZeros) {
+  // IEEE equality treats the zeros as equal, SMT-LIB equality doesn't.
+  ASSERT_EQ(jfs_distance_fp_eq(Float32::getPositiveZero(),
+                               Float32::getNegativeZero()),
+            0u);
+  ASSERT_EQ(jfs_distance_fp_smt_eq(Float32::getPositiveZero(),
+                                   Float32::getNegativeZero()),
+            1u);
+}
+
+TEST(Distance, FloatNaN) {
+  ASSERT_EQ(jfs_distance_fp_eq(Float32::getNaN(), Float32::getNaN()),
+            UINT64_MAX);
+  ASSERT_EQ(jfs_distance_fp_smt_eq(Float32::getNaN(), Float32::getNaN()), 0u);
+  ASSERT_EQ(jfs_distance_fp_smt_eq(Float32::getNaN(), Float32(1.0f)),
+            UINT64_MAX);
+  ASSERT_EQ(jfs_distance_fp_lt(Float64::getNaN(), Float64(1.0)), UINT64_MAX);
+}
@@ -122,3 +122,35 @@ TEST(MakeFromBuffer, simpleValuesFloat64) {
               jfs_nr_float64_get_raw_bits(values[index]));
   }
 }
+
+TEST(MakeFromBuffer, ConstantOffsetsFloat32) {
+  float values[] = {1.0f, 2.0f, 0.1f, 256.0f};
+  uint8_t* view = reinterpret_cast<uint8_t*>(values);
+  BufferRef<const uint8_t> bufferRef(view, sizeof(values));
+  // Byte aligned
+  ASSERT_EQ((makeFloatFrom<8, 24, 0, 31>(bufferRef)).getRawBits(),
+            jfs_nr_float32_get_raw_bits(values[0]));
+  ASSERT_EQ((makeFloatFrom<8, 24, 96, 127>(bufferRef)).getRawBits(),
+            jfs_nr_float32_get_raw_bits(values[3]));
+  // Not byte aligned
+  ASSERT_EQ((makeFloatFrom<8, 24, 5, 36>(bufferRef)).getRawBits(),
+            (makeFloatFrom<8, 24>(bufferRef, 5, 36)).getRawBits());
+  ASSERT_EQ((makeFloatFrom<8, 24, 67, 98>(bufferRef)).getRawBits(),
+            (makeFloatFrom<8, 24>(bufferRef, 67, 98)).getRawBits());
+}
+
+TEST(MakeFromBuffer, ConstantOffsetsFloat64) {
+  double values[] = {1.0, 2.0, 0.1, 256.0};
+  uint8_t* view = reinterpret_cast<uint8_t*>(values);
+  BufferRef<const uint8_t> bufferRef(view, sizeof(values));
+  // Byte aligned
+  ASSERT_EQ((makeFloatFrom<11, 53, 0, 63>(bufferRef)).getRawBits(),
+            jfs_nr_float64_get_raw_bits(values[0]));
+  ASSERT_EQ((makeFloatFrom<11, 53, 128, 191>(bufferRef)).getRawBits(),
+            jfs_nr_float64_get_raw_bits(values[2]));
+  // Not byte aligned
+  ASSERT_EQ((makeFloatFrom<11, 53, 3, 66>(bufferRef)).getRawBits(),
+            (makeFloatFrom<11, 53>(bufferRef, 3, 66)).getRawBits());
+  ASSERT_EQ((makeFloatFrom<11, 53, 129, 192>(bufferRef)).getRawBits(),
+            (makeFloatFrom<11, 53>(bufferRef, 129, 192)).getRawBits());
+}
@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "SMTLIB/Mutator.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <string.h>
+#include <vector>
+
+// Normally provided by LibFuzzer. Leaves the input unchanged so tests can
+// tell that the mutation was delegated.
+static unsigned numDelegatedMutations = 0;
+extern "C" size_t LLVMFuzzerMutate(uint8_t* data, size_t size,
+                                   size_t maxSize) {
+  ++numDelegatedMutations;
+  return size;
+}
+
+TEST(Mutator, GrowsShortInputs) {
+  const jfs_buffer_element layout[] = {
+      {JFS_BUFFER_ELEMENT_BITVECTOR, 0, 32, 0, 0},
+      {JFS_BUFFER_ELEMENT_BOOL, 32, 1, 0, 0},
+  };
+  numDelegatedMutations = 0;
+  for (unsigned seed = 0; seed < 100; ++seed) {
+    uint8_t data[16];
+    memset(data, 0xff, sizeof(data));
+    unsigned delegatedBefore = numDelegatedMutations;
+    size_t newSize = jfs_custom_mutate(layout, 2, data, 0, sizeof(data), seed);
+    if (numDelegatedMutations != delegatedBefore) {
+      ASSERT_EQ(newSize, 0u);
+      continue;
+    }
+    ASSERT_EQ(newSize, 5u);
+  }
+  // Some, but not all, mutations are left to LibFuzzer.
+  ASSERT_GT(numDelegatedMutations, 0u);
+  ASSERT_LT(numDelegatedMutations, 100u);
+}
+
+TEST(Mutator, DelegatesWhenBufferDoesNotFit) {
+  const jfs_buffer_element layout[] = {
+      {JFS_BUFFER_ELEMENT_BITVECTOR, 0, 64, 0, 0},
+  };
+  uint8_t data[4] = {0};
+  numDelegatedMutations = 0;
+  ASSERT_EQ(jfs_custom_mutate(layout, 1, data, 4, 4, 0), 4u);
+  ASSERT_EQ(numDelegatedMutations, 1u);
+}
+
+TEST(Mutator, FloatSpecialValues) {
+  const jfs_buffer_element layout[] = {
+      {JFS_BUFFER_ELEMENT_FLOAT, 0, 32, 8, 24},
+  };
+  bool seenInfinity = false;
+  bool seenNaN = false;
+  bool seenNegative = false;
+  for (unsigned seed = 0; seed < 1000; ++seed) {
+    float value = 1.0f;
+    uint8_t data[sizeof(float)];
+    memcpy(data, &value, sizeof(float));
+    jfs_custom_mutate(layout, 1, data, sizeof(data), sizeof(data), seed);
+    memcpy(&value, data, sizeof(float));
+    seenInfinity |= std::isinf(value);
+    seenNaN |= std::isnan(value);
+    seenNegative |= std::signbit(value);
+  }
+  ASSERT_TRUE(seenInfinity);
+  ASSERT_TRUE(seenNaN);
+  ASSERT_TRUE(seenNegative);
+}
+
+TEST(Mutator, CrossOverTakesWholeElements) {
+  // Elements deliberately straddle byte boundaries.
+  const jfs_buffer_element layout[] = {
+      {JFS_BUFFER_ELEMENT_BOOL, 0, 1, 0, 0},
+      {JFS_BUFFER_ELEMENT_BITVECTOR, 1, 12, 0, 0},
+      {JFS_BUFFER_ELEMENT_BITVECTOR, 13, 19, 0, 0},
+  };
+  const uint8_t zeros[4] = {0x00, 0x00, 0x00, 0x00};
+  const uint8_t ones[4] = {0xff, 0xff, 0xff, 0xff};
+  for (unsigned seed = 0; seed < 100; ++seed) {
+    uint8_t out[8];
+    ASSERT_EQ(jfs_custom_cross_over(layout, 3, zeros, 4, ones, 4, out,
+                                    sizeof(out), seed),
+              4u);
+    uint32_t result = 0;
+    memcpy(&result, out, sizeof(result));
+    for (const auto& e : layout) {
+      uint32_t mask = ((UINT32_C(1) << e.bitWidth) - 1) << e.bitOffset;
+      uint32_t bits = result & mask;
+      ASSERT_TRUE(bits == 0 || bits == mask);
+    }
+  }
+}
+
+TEST(Mutator, CrossOverRejectsShortInputs) {
+  const jfs_buffer_element layout[] = {
+      {JFS_BUFFER_ELEMENT_BITVECTOR, 0, 32, 0, 0},
+  };
+  const uint8_t data[4] = {0};
+  uint8_t out[4];
+  ASSERT_EQ(jfs_custom_cross_over(layout, 1, data, 2, data, 4, out,
+                                  sizeof(out), 0),
+            0u);
+}
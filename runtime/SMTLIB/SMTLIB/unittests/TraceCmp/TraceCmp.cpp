@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+//                        JFS - The JIT Fuzzing Solver
+//
+// Copyright 2017-2018 Daniel Liew
+//
+// This file is distributed under the MIT license.
+// See LICENSE.txt for details.
+//
+//===----------------------------------------------------------------------===//
+#include "SMTLIB/TraceCmp.h"
+#include "gtest/gtest.h"
+
+// Normally provided by LibFuzzer. Record the traced operands.
+static uint64_t lastArg1 = 0;
+static uint64_t lastArg2 = 0;
+static unsigned lastSize = 0;
+extern "C" void __sanitizer_cov_trace_cmp4(uint32_t arg1, uint32_t arg2) {
+  lastArg1 = arg1;
+  lastArg2 = arg2;
+  lastSize = 4;
+}
+extern "C" void __sanitizer_cov_trace_cmp8(uint64_t arg1, uint64_t arg2) {
+  lastArg1 = arg1;
+  lastArg2 = arg2;
+  lastSize = 8;
+}
+
+TEST(TraceCmp, Float32) {
+  Float32 lhs = Float32::getPositiveInfinity();
+  Float32 rhs = Float32::getNegativeZero();
+  jfs_trace_fp_cmp(lhs, rhs);
+  ASSERT_EQ(lastSize, 4u);
+  ASSERT_EQ(lastArg1, UINT64_C(0x7f800000));
+  ASSERT_EQ(lastArg2, UINT64_C(0x80000000));
+}
+
+TEST(TraceCmp, Float64) {
+  Float64 lhs = Float64::getNaN();
+  Float64 rhs = Float64::getPositiveZero();
+  jfs_trace_fp_cmp(lhs, rhs);
+  ASSERT_EQ(lastSize, 8u);
+  ASSERT_EQ(lastArg1, lhs.getRawBits());
+  ASSERT_EQ(lastArg2, UINT64_C(0));
+}
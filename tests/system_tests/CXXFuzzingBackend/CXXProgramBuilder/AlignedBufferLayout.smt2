@@ -0,0 +1,30 @@
+; RUN: %jfs-smt2cxx -sort-free-variable-strategy=aligned %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+; RUN: %jfs-smt2cxx %s > %t.packed.cpp
+; RUN: %FileCheck -check-prefix=CHECK-PACKED -input-file=%t.packed.cpp %s
+(declare-fun p () Bool)
+(declare-fun x () (_ BitVec 3))
+(declare-fun f () (_ FloatingPoint 11 53))
+(declare-fun q () Bool)
+(declare-fun y () (_ BitVec 16))
+(assert (or p (bvugt x #b010)))
+(assert (or (fp.isNormal f) q))
+(assert (bvugt y #x0100))
+(check-sat)
+; Elements are ordered by decreasing alignment and booleans go last.
+; CHECK: LLVMFuzzerTestOneInput
+; CHECK: if (size < 12)
+; CHECK-DAG: f = makeFloatFrom<11, 53, 0, 63>(jfs_buffer_ref);
+; CHECK-DAG: y = makeBitVectorFrom<16, 64, 79>(jfs_buffer_ref);
+; CHECK-DAG: x = makeBitVectorFrom<3, 80, 82>(jfs_buffer_ref);
+; CHECK-DAG: p = makeBoolFrom<88, 88>(jfs_buffer_ref);
+; CHECK-DAG: q = makeBoolFrom<89, 89>(jfs_buffer_ref);
+
+; CHECK-PACKED: LLVMFuzzerTestOneInput
+; CHECK-PACKED: if (size < 11)
+; CHECK-PACKED-DAG: p = makeBoolFrom<0, 0>(jfs_buffer_ref);
+; CHECK-PACKED-DAG: x = makeBitVectorFrom<3, 1, 3>(jfs_buffer_ref);
+; CHECK-PACKED-DAG: f = makeFloatFrom<11, 53, 4, 67>(jfs_buffer_ref);
+; CHECK-PACKED-DAG: q = makeBoolFrom<68, 68>(jfs_buffer_ref);
+; CHECK-PACKED-DAG: y = makeBitVectorFrom<16, 69, 84>(jfs_buffer_ref);
@@ -0,0 +1,26 @@
+; RUN: %jfs-smt2cxx -sort-free-variable-strategy=constraint_locality %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+; RUN: %jfs-smt2cxx %s > %t.first_observed.cpp
+; RUN: %FileCheck -check-prefix=CHECK-FIRST-OBSERVED -input-file=%t.first_observed.cpp %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(declare-fun x () (_ BitVec 32))
+(declare-fun y () (_ BitVec 32))
+(assert (bvult a b))
+(assert (bvult x y))
+(assert (bvugt y b))
+(check-sat)
+; The first constraint's variables come first. `y` is used with `b` so it is
+; placed next to it.
+; CHECK: LLVMFuzzerTestOneInput
+; CHECK-DAG: a = makeBitVectorFrom<32, 0, 31>(jfs_buffer_ref);
+; CHECK-DAG: b = makeBitVectorFrom<32, 32, 63>(jfs_buffer_ref);
+; CHECK-DAG: y = makeBitVectorFrom<32, 64, 95>(jfs_buffer_ref);
+; CHECK-DAG: x = makeBitVectorFrom<32, 96, 127>(jfs_buffer_ref);
+
+; CHECK-FIRST-OBSERVED: LLVMFuzzerTestOneInput
+; CHECK-FIRST-OBSERVED-DAG: a = makeBitVectorFrom<32, 0, 31>(jfs_buffer_ref);
+; CHECK-FIRST-OBSERVED-DAG: b = makeBitVectorFrom<32, 32, 63>(jfs_buffer_ref);
+; CHECK-FIRST-OBSERVED-DAG: x = makeBitVectorFrom<32, 64, 95>(jfs_buffer_ref);
+; CHECK-FIRST-OBSERVED-DAG: y = makeBitVectorFrom<32, 96, 127>(jfs_buffer_ref);
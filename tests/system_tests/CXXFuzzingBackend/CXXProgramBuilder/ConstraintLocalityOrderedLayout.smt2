@@ -0,0 +1,29 @@
+; RUN: %jfs-smt2cxx -sort-free-variable-strategy=constraint_locality -order-constraints %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+; RUN: %jfs-smt2cxx -sort-free-variable-strategy=constraint_locality %s > %t.unordered.cpp
+; RUN: %FileCheck -check-prefix=CHECK-UNORDERED -input-file=%t.unordered.cpp %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(declare-fun x () (_ BitVec 32))
+(declare-fun y () (_ BitVec 32))
+; Expensive and often true.
+(assert (not (= (bvmul x y) #x00000000)))
+; Cheap and almost always false.
+(assert (= (bvadd a b) #x12345678))
+(check-sat)
+; The layout follows the order the constraints are checked in so the
+; variables of the `bvadd` constraint come first when it is checked first.
+; CHECK: LLVMFuzzerTestOneInput
+; CHECK-DAG: a = makeBitVectorFrom<32, 0, 31>(jfs_buffer_ref);
+; CHECK-DAG: b = makeBitVectorFrom<32, 32, 63>(jfs_buffer_ref);
+; CHECK-DAG: x = makeBitVectorFrom<32, 64, 95>(jfs_buffer_ref);
+; CHECK-DAG: y = makeBitVectorFrom<32, 96, 127>(jfs_buffer_ref);
+; CHECK: .bvadd(
+; CHECK: .bvmul(
+
+; CHECK-UNORDERED: LLVMFuzzerTestOneInput
+; CHECK-UNORDERED-DAG: x = makeBitVectorFrom<32, 0, 31>(jfs_buffer_ref);
+; CHECK-UNORDERED-DAG: y = makeBitVectorFrom<32, 32, 63>(jfs_buffer_ref);
+; CHECK-UNORDERED-DAG: a = makeBitVectorFrom<32, 64, 95>(jfs_buffer_ref);
+; CHECK-UNORDERED-DAG: b = makeBitVectorFrom<32, 96, 127>(jfs_buffer_ref);
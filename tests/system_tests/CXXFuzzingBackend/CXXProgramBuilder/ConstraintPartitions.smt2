@@ -0,0 +1,25 @@
+; RUN: %jfs-smt2cxx -constraint-partitions=2 %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvugt a #x00001000))
+(assert (bvult a b))
+(assert (bvult b #x00100000))
+(check-sat)
+; CHECK: int jfs_check_constraints_0(const uint8_t* data, size_t size);
+; CHECK: int jfs_check_constraints_1(const uint8_t* data, size_t size);
+; CHECK: LLVMFuzzerTestOneInput
+; CHECK: if (jfs_check_constraints_0(data, size)) {}
+; CHECK: if (jfs_check_constraints_1(data, size)) {}
+; CHECK: abort()
+; CHECK: #include "SMTLIB/BitVector.h"
+; CHECK: int jfs_check_constraints_0(const uint8_t* data, size_t size)
+; CHECK-NEXT: {
+; CHECK: makeBitVectorFrom<32,
+; CHECK: return 1;
+; CHECK: #include "SMTLIB/BitVector.h"
+; CHECK: int jfs_check_constraints_1(const uint8_t* data, size_t size)
+; CHECK-NEXT: {
+; CHECK: makeBitVectorFrom<32,
+; CHECK: return 1;
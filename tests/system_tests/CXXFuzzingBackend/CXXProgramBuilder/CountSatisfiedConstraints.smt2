@@ -0,0 +1,26 @@
+; RUN: %jfs-smt2cxx -count-satisfied-constraints %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvugt a #x00001000))
+(assert (bvult a b))
+(assert (bvult b #x00100000))
+(check-sat)
+; CHECK: uint8_t jfs_extra_counters[8] = {}
+; CHECK: const size_t jfs_num_extra_counters = 8
+; CHECK: LLVMFuzzerTestOneInput
+; CHECK: uint64_t [[N:jfs_num_satisfied[a-z0-9_]*]] = 0;
+; CHECK: jfs_extra_counters[0] |= [[C0:[a-z0-9_]+]];
+; CHECK-NEXT: [[N]] += [[C0]];
+; CHECK-NOT: return 0;
+; CHECK: jfs_extra_counters[1] |= [[C1:[a-z0-9_]+]];
+; CHECK-NEXT: [[N]] += [[C1]];
+; CHECK-NOT: return 0;
+; CHECK: jfs_extra_counters[2] |= [[C2:[a-z0-9_]+]];
+; CHECK-NEXT: [[N]] += [[C2]];
+; CHECK-NEXT: jfs_extra_counters[3 + [[N]]] = 1;
+; CHECK-NEXT: if ([[N]] == 3) {}
+; CHECK-NEXT: else {
+; CHECK-NEXT: return 0;
+; CHECK: abort()
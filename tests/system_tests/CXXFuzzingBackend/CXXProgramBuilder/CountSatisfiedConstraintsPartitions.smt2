@@ -0,0 +1,27 @@
+; RUN: %jfs-smt2cxx -count-satisfied-constraints -constraint-partitions=2 %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvugt a #x00001000))
+(assert (bvult a b))
+(assert (bvult b #x00100000))
+(check-sat)
+; CHECK: LLVMFuzzerTestOneInput
+; CHECK: uint64_t [[N:jfs_num_satisfied[a-z0-9_]*]] = 0;
+; CHECK: [[N]] += jfs_check_constraints_0(data, size);
+; CHECK-NEXT: [[N]] += jfs_check_constraints_1(data, size);
+; CHECK-NEXT: jfs_extra_counters[3 + [[N]]] = 1;
+; CHECK-NEXT: if ([[N]] == 3) {}
+; CHECK: abort()
+; CHECK: extern "C" uint8_t jfs_extra_counters[];
+; CHECK: int jfs_check_constraints_0(const uint8_t* data, size_t size)
+; CHECK: uint64_t [[N0:jfs_num_satisfied[a-z0-9_]*]] = 0;
+; CHECK: jfs_extra_counters[0] |=
+; CHECK: jfs_extra_counters[1] |=
+; CHECK: return [[N0]];
+; CHECK: extern "C" uint8_t jfs_extra_counters[];
+; CHECK: int jfs_check_constraints_1(const uint8_t* data, size_t size)
+; CHECK: uint64_t [[N1:jfs_num_satisfied[a-z0-9_]*]] = 0;
+; CHECK: jfs_extra_counters[2] |=
+; CHECK: return [[N1]];
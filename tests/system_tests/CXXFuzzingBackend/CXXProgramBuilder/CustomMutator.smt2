@@ -0,0 +1,20 @@
+; RUN: %jfs-smt2cxx -custom-mutator %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+(declare-fun a () Bool)
+(declare-fun b () (_ BitVec 16))
+(declare-fun c () (_ FloatingPoint 8 24))
+(assert a)
+(assert (bvugt b #x0010))
+(assert (fp.isNegative c))
+(check-sat)
+; CHECK: #include "SMTLIB/Mutator.h"
+; CHECK: static const jfs_buffer_element jfs_buffer_layout[] = {
+; CHECK-DAG: {JFS_BUFFER_ELEMENT_BOOL, {{[0-9]+}}, 1, 0, 0},
+; CHECK-DAG: {JFS_BUFFER_ELEMENT_BITVECTOR, {{[0-9]+}}, 16, 0, 0},
+; CHECK-DAG: {JFS_BUFFER_ELEMENT_FLOAT, {{[0-9]+}}, 32, 8, 24},
+; CHECK: };
+; CHECK: size_t LLVMFuzzerCustomMutator(uint8_t* data, size_t size, size_t maxSize, unsigned int seed)
+; CHECK: return jfs_custom_mutate(jfs_buffer_layout, 3, data, size, maxSize, seed);
+; CHECK: size_t LLVMFuzzerCustomCrossOver(const uint8_t* data1, size_t size1, const uint8_t* data2, size_t size2, uint8_t* out, size_t maxOutSize, unsigned int seed)
+; CHECK: return jfs_custom_cross_over(jfs_buffer_layout, 3, data1, size1, data2, size2, out, maxOutSize, seed);
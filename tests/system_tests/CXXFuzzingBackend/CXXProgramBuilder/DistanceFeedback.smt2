@@ -0,0 +1,15 @@
+; RUN: %jfs-smt2cxx -distance-feedback %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+(declare-fun a () Bool)
+(declare-fun b () (_ BitVec 16))
+(declare-fun c () (_ FloatingPoint 8 24))
+(assert a)
+(assert (bvugt b #x0010))
+(assert (fp.lt c (fp #b0 #x7f #b10000000000000000000000)))
+(check-sat)
+; CHECK: #include "SMTLIB/Distance.h"
+; CHECK: uint8_t jfs_extra_counters[136] = {}
+; CHECK: const size_t jfs_num_extra_counters = 136
+; CHECK: jfs_record_distance(jfs_extra_counters + 0, jfs_distance_bvult(
+; CHECK: jfs_record_distance(jfs_extra_counters + 65, jfs_distance_fp_lt(
@@ -0,0 +1,30 @@
+; RUN: %jfs-smt2cxx -narrow-bv-intervals %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+; RUN: %jfs-smt2cxx %s > %t.default.cpp
+; RUN: %FileCheck -check-prefix=CHECK-DEFAULT -input-file=%t.default.cpp %s
+(declare-fun x () (_ BitVec 32))
+(declare-fun y () (_ BitVec 16))
+(declare-fun z () (_ BitVec 8))
+(assert (bvule x #x000003e8))
+(assert (bvuge x #x00000064))
+(assert (not (bvult y #x0010)))
+(assert (bvult #x05 z))
+(assert (bvugt ((_ zero_extend 16) y) x))
+(assert (= ((_ extract 7 0) x) z))
+(check-sat)
+; Each variable is stored as an offset into its bounds which are no longer
+; checked.
+; CHECK: LLVMFuzzerTestOneInput
+; CHECK: if (size < 5)
+; CHECK-DAG: y = makeBitVectorInRangeFrom<16, UINT64_C(16), UINT64_C(65535), 0, 15>(jfs_buffer_ref);
+; CHECK-DAG: x = makeBitVectorInRangeFrom<32, UINT64_C(100), UINT64_C(1000), 16, 25>(jfs_buffer_ref);
+; CHECK-DAG: z = makeBitVectorInRangeFrom<8, UINT64_C(6), UINT64_C(255), 26, 33>(jfs_buffer_ref);
+; CHECK-NOT: bvul
+; CHECK-NOT: bvuge
+
+; CHECK-DEFAULT: LLVMFuzzerTestOneInput
+; CHECK-DEFAULT: if (size < 7)
+; CHECK-DEFAULT-DAG: x = makeBitVectorFrom<32, 0, 31>(jfs_buffer_ref);
+; CHECK-DEFAULT-DAG: y = makeBitVectorFrom<16, 32, 47>(jfs_buffer_ref);
+; CHECK-DEFAULT-DAG: z = makeBitVectorFrom<8, 48, 55>(jfs_buffer_ref);
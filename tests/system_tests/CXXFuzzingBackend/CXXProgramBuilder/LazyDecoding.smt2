@@ -0,0 +1,37 @@
+; RUN: %jfs-smt2cxx -lazy-decoding %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+; RUN: %jfs-smt2cxx -lazy-decoding -constraint-partitions=2 %s > %t.partitions.cpp
+; RUN: %cxx-rt-syntax %t.partitions.cpp
+; RUN: %FileCheck -check-prefix=CHECK-PARTITIONS -input-file=%t.partitions.cpp %s
+; RUN: %jfs-smt2cxx %s > %t.eager.cpp
+; RUN: %FileCheck -check-prefix=CHECK-EAGER -input-file=%t.eager.cpp %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvugt a #x00001000))
+(assert (bvult a b))
+(assert (bvult b #x00100000))
+(check-sat)
+; CHECK: LLVMFuzzerTestOneInput
+; CHECK: jfs_buffer_ref
+; CHECK: makeBitVectorFrom<32, 0, 31>(jfs_buffer_ref);
+; CHECK-NOT: makeBitVectorFrom
+; CHECK: if (
+; CHECK: makeBitVectorFrom<32, 32, 63>(jfs_buffer_ref);
+; CHECK-NOT: makeBitVectorFrom
+; CHECK: if (
+; CHECK-NOT: makeBitVectorFrom
+; CHECK: abort()
+
+; Each partition only decodes the variables its constraints use.
+; CHECK-PARTITIONS: int jfs_check_constraints_0(const uint8_t* data, size_t size)
+; CHECK-PARTITIONS: makeBitVectorFrom<32, 0, 31>(jfs_buffer_ref);
+; CHECK-PARTITIONS: makeBitVectorFrom<32, 32, 63>(jfs_buffer_ref);
+; CHECK-PARTITIONS: int jfs_check_constraints_1(const uint8_t* data, size_t size)
+; CHECK-PARTITIONS-NOT: makeBitVectorFrom<32, 0, 31>(jfs_buffer_ref);
+; CHECK-PARTITIONS: makeBitVectorFrom<32, 32, 63>(jfs_buffer_ref);
+
+; CHECK-EAGER: LLVMFuzzerTestOneInput
+; CHECK-EAGER: makeBitVectorFrom<32, 0, 31>(jfs_buffer_ref);
+; CHECK-EAGER-NEXT: makeBitVectorFrom<32, 32, 63>(jfs_buffer_ref);
+; CHECK-EAGER: if (
@@ -0,0 +1,13 @@
+; RUN: %jfs-smt2cxx -lift-constants %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+; CHECK: #include "SMTLIB/ConstantTable.h"
+; CHECK-NOT: UINT64_C(4096)
+; CHECK: BitVector<32>(jfs_constant_table[0])
+; CHECK: extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv)
+; CHECK: return jfs_load_constant_table(argc, argv, UINT64_C(1));
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvult a b))
+(assert (bvugt a #x00001000))
+(check-sat)
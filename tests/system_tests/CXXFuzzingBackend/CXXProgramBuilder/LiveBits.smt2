@@ -0,0 +1,24 @@
+; RUN: %jfs-smt2cxx %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+; RUN: %jfs-smt2cxx -buffer-live-bits-only=0 %s > %t.all_bits.cpp
+; RUN: %FileCheck -check-prefix=CHECK-ALL-BITS -input-file=%t.all_bits.cpp %s
+(declare-fun x () (_ BitVec 64))
+(declare-fun y () (_ BitVec 32))
+(declare-fun z () (_ BitVec 16))
+(assert (= ((_ extract 7 0) x) #x41))
+(assert (bvult ((_ zero_extend 16) ((_ extract 23 8) x)) y))
+(assert (bvugt ((_ extract 15 8) z) #x10))
+(check-sat)
+; Only bits [23:0] of `x` and [15:8] of `z` are stored in the buffer.
+; CHECK: LLVMFuzzerTestOneInput
+; CHECK: if (size < 8)
+; CHECK-DAG: x = makeBitVectorFromLiveBits<64, 0, 0, 23>(jfs_buffer_ref);
+; CHECK-DAG: y = makeBitVectorFrom<32, 24, 55>(jfs_buffer_ref);
+; CHECK-DAG: z = makeBitVectorFromLiveBits<16, 8, 56, 63>(jfs_buffer_ref);
+
+; CHECK-ALL-BITS: LLVMFuzzerTestOneInput
+; CHECK-ALL-BITS: if (size < 14)
+; CHECK-ALL-BITS-DAG: x = makeBitVectorFrom<64, 0, 63>(jfs_buffer_ref);
+; CHECK-ALL-BITS-DAG: y = makeBitVectorFrom<32, 64, 95>(jfs_buffer_ref);
+; CHECK-ALL-BITS-DAG: z = makeBitVectorFrom<16, 96, 111>(jfs_buffer_ref);
@@ -0,0 +1,24 @@
+; RUN: %jfs-smt2cxx -order-constraints %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+; RUN: %jfs-smt2cxx %s > %t.unordered.cpp
+; RUN: %FileCheck -check-prefix=CHECK-UNORDERED -input-file=%t.unordered.cpp %s
+(declare-fun a () (_ FloatingPoint 11 53))
+(declare-fun b () (_ FloatingPoint 11 53))
+(declare-fun x () (_ BitVec 32))
+(declare-fun y () (_ BitVec 32))
+; Expensive and often true.
+(assert (not (= (bvmul x y) #x00000000)))
+; Expensive and true half the time.
+(assert (fp.lt (fp.sqrt RNE (fp.mul RNE a a)) b))
+; Cheap and almost always false.
+(assert (= (bvadd x y) #x12345678))
+(check-sat)
+; CHECK: LLVMFuzzerTestOneInput
+; CHECK: .bvadd(
+; CHECK: .sqrt(
+; CHECK: .bvmul(
+; CHECK-UNORDERED: LLVMFuzzerTestOneInput
+; CHECK-UNORDERED: .bvmul(
+; CHECK-UNORDERED: .sqrt(
+; CHECK-UNORDERED: .bvadd(
@@ -0,0 +1,41 @@
+; RUN: %jfs-smt2cxx -record-rejections %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+; RUN: %jfs-smt2cxx -record-rejections -constraint-partitions=2 %s > %t.partitions.cpp
+; RUN: %cxx-rt-syntax %t.partitions.cpp
+; RUN: %FileCheck -check-prefix=CHECK-PARTITIONS -input-file=%t.partitions.cpp %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvugt a #x00001000))
+(assert (bvult a b))
+(assert (bvult b #x00100000))
+(check-sat)
+; CHECK: #include "SMTLIB/RejectionProfile.h"
+; CHECK: extern "C" uint64_t jfs_rejection_counts[4] = {};
+; CHECK: LLVMFuzzerTestOneInput
+; CHECK: ++jfs_rejection_counts[3];
+; CHECK: else {
+; CHECK-NEXT: ++jfs_rejection_counts[0];
+; CHECK-NEXT: return 0;
+; CHECK: else {
+; CHECK-NEXT: ++jfs_rejection_counts[1];
+; CHECK-NEXT: return 0;
+; CHECK: else {
+; CHECK-NEXT: ++jfs_rejection_counts[2];
+; CHECK-NEXT: return 0;
+; CHECK: abort()
+; CHECK: extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv)
+; CHECK: jfs_setup_rejection_profile(argc, argv, jfs_rejection_counts, UINT64_C(4));
+; CHECK-NEXT: return 0;
+
+; CHECK-PARTITIONS: extern "C" uint64_t jfs_rejection_counts[4] = {};
+; CHECK-PARTITIONS: LLVMFuzzerTestOneInput
+; CHECK-PARTITIONS: ++jfs_rejection_counts[3];
+; CHECK-PARTITIONS: if (jfs_check_constraints_0(data, size)) {}
+; CHECK-PARTITIONS: extern "C" uint64_t jfs_rejection_counts[];
+; CHECK-PARTITIONS: int jfs_check_constraints_0(const uint8_t* data, size_t size)
+; CHECK-PARTITIONS: ++jfs_rejection_counts[0];
+; CHECK-PARTITIONS: ++jfs_rejection_counts[1];
+; CHECK-PARTITIONS: extern "C" uint64_t jfs_rejection_counts[];
+; CHECK-PARTITIONS: int jfs_check_constraints_1(const uint8_t* data, size_t size)
+; CHECK-PARTITIONS: ++jfs_rejection_counts[2];
@@ -0,0 +1,11 @@
+; RUN: %jfs-smt2cxx %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+; CHECK-NOT: SMTLIB/Core.h
+; CHECK-NOT: SMTLIB/Float.h
+; CHECK: #include "SMTLIB/BitVector.h"
+; CHECK-NOT: SMTLIB/Core.h
+; CHECK-NOT: SMTLIB/Float.h
+(declare-fun a () (_ BitVec 8))
+(assert (bvugt a #x10))
+(check-sat)
@@ -0,0 +1,12 @@
+; RUN: %jfs-smt2cxx %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+; CHECK-NOT: SMTLIB/BitVector.h
+; CHECK-NOT: SMTLIB/Float.h
+; CHECK: #include "SMTLIB/Core.h"
+; CHECK-NOT: SMTLIB/BitVector.h
+; CHECK-NOT: SMTLIB/Float.h
+(declare-fun a () Bool)
+(declare-fun b () Bool)
+(assert (or a b))
+(check-sat)
@@ -0,0 +1,17 @@
+; RUN: %jfs-smt2cxx -trace-fp-cmp %s > %t.cpp
+; RUN: %cxx-rt-syntax %t.cpp
+; RUN: %FileCheck -input-file=%t.cpp %s
+(declare-fun a () (_ FloatingPoint 8 24))
+(declare-fun b () (_ FloatingPoint 11 53))
+(declare-fun c () (_ FloatingPoint 11 53))
+(assert (fp.lt a (fp #b0 #x7f #b10000000000000000000000)))
+(assert (= b (fp.abs c)))
+(assert (fp.eq b (fp.neg c)))
+(check-sat)
+; CHECK: #include "SMTLIB/TraceCmp.h"
+; CHECK: jfs_trace_fp_cmp([[A:[a-z0-9_]+]], [[K:[a-z0-9_]+]]);
+; CHECK-NEXT: bool {{[a-z0-9_]+}} = [[A]].fplt([[K]]);
+; CHECK: jfs_trace_fp_cmp([[B:[a-z0-9_]+]], [[AC:[a-z0-9_]+]]);
+; CHECK-NEXT: bool {{[a-z0-9_]+}} = [[B]] == [[AC]];
+; CHECK: jfs_trace_fp_cmp([[B]], [[NC:[a-z0-9_]+]]);
+; CHECK-NEXT: bool {{[a-z0-9_]+}} = [[B]].ieeeEquals([[NC]]);
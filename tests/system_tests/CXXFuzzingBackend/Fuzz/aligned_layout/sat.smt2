@@ -0,0 +1,15 @@
+; RUN: rm -f %t.yml
+; RUN: %jfs -cxx -sort-free-variable-strategy=aligned -stats-file=%t.yml %s | %FileCheck %s
+; RUN: %yaml-syntax-check %t.yml
+; RUN: %FileCheck -check-prefix=CHECK-STATS -input-file=%t.yml %s
+(declare-fun p () Bool)
+(declare-fun x () (_ BitVec 3))
+(declare-fun y () (_ BitVec 16))
+(assert (xor p (bvugt x #b101)))
+(assert (bvugt y #x1000))
+(check-sat)
+; CHECK: {{^sat$}}
+; CHECK-STATS: name: FreeVariableToBufferAssignmentPass
+; CHECK-STATS-NEXT: num_elements: 3
+; CHECK-STATS-NEXT: width_in_bits: 25
+; CHECK-STATS-NEXT: packed_width_in_bits: 20
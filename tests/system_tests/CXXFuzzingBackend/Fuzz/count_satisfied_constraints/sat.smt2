@@ -0,0 +1,13 @@
+; RUN: %jfs -cxx -cxx-count-satisfied-constraints %s | %FileCheck %s
+; RUN: %jfs -cxx -cxx-count-satisfied-constraints -libfuzzer-in-process %s | %FileCheck %s
+; RUN: %jfs -cxx -cxx-count-satisfied-constraints -cxx-constraint-partitions=2 %s | %FileCheck %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(declare-fun c () (_ FloatingPoint 8 24))
+(assert (bvugt a #x00001000))
+(assert (bvult a b))
+(assert (bvult b #x00100000))
+(assert (fp.isNormal c))
+(assert (fp.isNegative c))
+(check-sat)
+; CHECK: {{^sat$}}
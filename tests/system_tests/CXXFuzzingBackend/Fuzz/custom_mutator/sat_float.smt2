@@ -0,0 +1,9 @@
+; RUN: %jfs -cxx -cxx-custom-mutator %s | %FileCheck %s
+; RUN: %jfs -cxx -cxx-custom-mutator -libfuzzer-in-process %s | %FileCheck %s
+(declare-fun a () (_ FloatingPoint 8 24))
+(declare-fun b () (_ BitVec 32))
+(assert (fp.isInfinite a))
+(assert (fp.isNegative a))
+(assert (bvuge b #xfffffff0))
+(check-sat)
+; CHECK: {{^sat$}}
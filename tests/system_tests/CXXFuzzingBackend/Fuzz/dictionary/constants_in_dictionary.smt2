@@ -0,0 +1,26 @@
+; RUN: rm -rf %t.wd %t.yml
+; RUN: %jfs -cxx -cxx-dictionary -v=1 -output-dir=%t.wd -keep-output-dir -stats-file=%t.yml %s > %t.out 2>&1
+; RUN: %FileCheck -check-prefix=CHECK-ARGS -input-file=%t.out %s
+; RUN: %FileCheck -check-prefix=CHECK-DICT -input-file=%t.wd/fuzzer.dict %s
+; RUN: %yaml-syntax-check %t.yml
+; RUN: %FileCheck -check-prefix=CHECK-STATS -input-file=%t.yml %s
+; RUN: rm -rf %t.wd
+; RUN: %jfs -cxx -v=1 %s 2>&1 | %FileCheck -check-prefix=CHECK-NO-DICT %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 16))
+(assert (bvugt a #x12345678))
+(assert (bvult a #x12345680))
+(assert (bvuge b #x0102))
+(check-sat)
+; CHECK-ARGS: "-dict={{.+}}/fuzzer.dict"
+; CHECK-ARGS: {{^sat$}}
+; CHECK-DICT-DAG: "\x78\x56\x34\x12"
+; CHECK-DICT-DAG: "\x80\x56\x34\x12"
+; CHECK-DICT-DAG: "\x02\x01"
+; CHECK-STATS: name: CXXProgramBuilderPassImpl
+; CHECK-STATS: num_dictionary_entries: {{[1-9][0-9]*}}
+; CHECK-STATS: name: CXXFuzzingSolverDictionary
+; CHECK-STATS-NEXT: num_entries: {{[1-9][0-9]*}}
+; CHECK-STATS-NEXT: num_used_entries: {{[0-9]+}}
+; CHECK-NO-DICT-NOT: -dict=
+; CHECK-NO-DICT: {{^sat$}}
@@ -0,0 +1,8 @@
+; RUN: %jfs -cxx -cxx-distance-feedback %s | %FileCheck %s
+; RUN: %jfs -cxx -cxx-distance-feedback -libfuzzer-in-process %s | %FileCheck %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ FloatingPoint 8 24))
+(assert (= a #x12345678))
+(assert (fp.geq b (fp #b0 #x88 #b11110100000000000000000)))
+(check-sat)
+; CHECK: {{^sat$}}
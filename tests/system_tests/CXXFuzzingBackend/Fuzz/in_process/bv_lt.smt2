@@ -0,0 +1,7 @@
+; RUN: %jfs -cxx -libfuzzer-in-process -max-time=10 %s | %FileCheck %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvult a b))
+(assert (bvugt a #x00001000))
+(check-sat)
+; CHECK: {{^sat$}}
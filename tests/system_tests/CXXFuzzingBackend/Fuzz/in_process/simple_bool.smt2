@@ -0,0 +1,7 @@
+; RUN: %jfs -cxx -libfuzzer-in-process %s | %FileCheck %s
+(declare-fun buffer_0 () Bool)
+(declare-fun buffer_1 () Bool)
+(declare-fun buffer_2 () Bool)
+(assert (or buffer_0 (or buffer_1 buffer_2)))
+(check-sat)
+; CHECK: {{^sat$}}
@@ -0,0 +1,20 @@
+; RUN: rm -f %t.yml
+; RUN: %jfs -cxx -narrow-bv-intervals -stats-file=%t.yml %s | %FileCheck %s
+; RUN: %yaml-syntax-check %t.yml
+; RUN: %FileCheck -check-prefix=CHECK-STATS -input-file=%t.yml %s
+(declare-fun x () (_ BitVec 32))
+(declare-fun y () (_ BitVec 32))
+(assert (bvule x #x000003e8))
+(assert (bvuge x #x00000064))
+(assert (bvult y #x00000bb9))
+(assert (bvugt y #x000007cf))
+(assert (bvugt (bvadd x y) #x00000f00))
+(check-sat)
+; CHECK: {{^sat$}}
+; CHECK-STATS: name: FreeVariableToBufferAssignmentPass
+; CHECK-STATS-NEXT: num_elements: 2
+; CHECK-STATS-NEXT: width_in_bits: 20
+; CHECK-STATS-NEXT: packed_width_in_bits: 20
+; CHECK-STATS-NEXT: num_dead_bits: 0
+; CHECK-STATS-NEXT: num_narrowed_elements: 2
+; CHECK-STATS-NEXT: num_narrowed_bits: 44
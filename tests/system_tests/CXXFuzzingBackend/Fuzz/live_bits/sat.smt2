@@ -0,0 +1,16 @@
+; RUN: rm -f %t.yml
+; RUN: %jfs -cxx -stats-file=%t.yml %s | %FileCheck %s
+; RUN: %yaml-syntax-check %t.yml
+; RUN: %FileCheck -check-prefix=CHECK-STATS -input-file=%t.yml %s
+(declare-fun x () (_ BitVec 64))
+(declare-fun y () (_ BitVec 32))
+(assert (= ((_ extract 15 8) x) #x41))
+(assert (bvugt ((_ extract 31 16) x) #xff00))
+(assert (bvult ((_ extract 7 0) y) #x03))
+(check-sat)
+; CHECK: {{^sat$}}
+; CHECK-STATS: name: FreeVariableToBufferAssignmentPass
+; CHECK-STATS-NEXT: num_elements: 2
+; CHECK-STATS-NEXT: width_in_bits: 32
+; CHECK-STATS-NEXT: packed_width_in_bits: 32
+; CHECK-STATS-NEXT: num_dead_bits: 64
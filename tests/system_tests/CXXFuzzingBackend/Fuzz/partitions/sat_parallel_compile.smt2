@@ -0,0 +1,14 @@
+; RUN: %jfs -cxx -v=1 -cxx-constraint-partitions=3 %s > %t.out 2>&1
+; RUN: %FileCheck -check-prefix=CHECK-ARGS -input-file=%t.out %s
+; RUN: %FileCheck -input-file=%t.out %s
+; RUN: %jfs -cxx -cxx-constraint-partitions=3 -cxx-pipe-source -libfuzzer-in-process %s | %FileCheck %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvugt a #x00001000))
+(assert (bvult a b))
+(assert (bvult b #x00100000))
+(check-sat)
+; CHECK-ARGS-DAG: "{{.+}}/program.0.cpp", "-c", "-o", "{{.+}}/fuzzer.0.o"
+; CHECK-ARGS-DAG: "{{.+}}/program.3.cpp", "-c", "-o", "{{.+}}/fuzzer.3.o"
+; CHECK-ARGS: "{{.+}}/fuzzer.0.o", "{{.+}}/fuzzer.1.o", "{{.+}}/fuzzer.2.o", "{{.+}}/fuzzer.3.o"
+; CHECK: {{^sat$}}
@@ -0,0 +1,14 @@
+; RUN: %jfs -cxx -cxx-profile-warm-up=1 %s | %FileCheck %s
+; RUN: %jfs -cxx -cxx-profile-warm-up=1 -cxx-profile-warm-up-pgo %s | %FileCheck %s
+; RUN: %jfs -cxx -cxx-profile-warm-up=1 -libfuzzer-in-process %s | %FileCheck %s
+; RUN: %jfs -cxx -cxx-profile-warm-up=1 -cxx-constraint-partitions=2 %s | %FileCheck %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(declare-fun c () (_ FloatingPoint 8 24))
+(assert (bvugt a #x00001000))
+(assert (bvult a b))
+(assert (bvult b #x00100000))
+(assert (fp.isNormal c))
+(assert (fp.isNegative c))
+(check-sat)
+; CHECK: {{^sat$}}
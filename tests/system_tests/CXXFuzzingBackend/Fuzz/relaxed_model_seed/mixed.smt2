@@ -0,0 +1,13 @@
+; RUN: %jfs -cxx -cxx-relaxed-model-seed-timeout=5000 -v=1 %s 2>&1 | %FileCheck -check-prefix=CHECK-Z3 %s
+; RUN: %jfs -cxx -cxx-relaxed-model-seed-timeout=5000 %s | %FileCheck %s
+; RUN: %jfs -cxx -cxx-relaxed-model-seed-timeout=5000 -libfuzzer-in-process %s | %FileCheck %s
+; The bitvector constraint is hard to hit by fuzzing but easy for Z3.
+(declare-fun a () (_ BitVec 32))
+(declare-fun f () (_ FloatingPoint 8 24))
+(assert (= (bvmul a #x0001003f) #x12345679))
+(assert (fp.isNegative f))
+(check-sat)
+; CHECK-Z3: (RelaxedModelSeedGenerator kept 1 of 2 constraints)
+; CHECK-Z3: (RelaxedModelSeedGenerator relaxed query is sat)
+; CHECK-Z3: {{^sat$}}
+; CHECK: {{^sat$}}
@@ -0,0 +1,21 @@
+; RUN: rm -rf %t.wd
+; RUN: %jfs -cxx -v=1 -output-dir=%t.wd -keep-output-dir %s 2>&1 | %FileCheck -check-prefix=CHECK-SEEDS %s
+; RUN: test -e %t.wd/corpus/extraSeed0
+; RUN: rm -rf %t.wd
+; RUN: %jfs -cxx -libfuzzer-sort-aware-seeds=0 -v=1 %s 2>&1 | %FileCheck -check-prefix=CHECK-NO-SEEDS %s
+; RUN: %jfs -cxx %s | %FileCheck %s
+; RUN: %jfs -cxx -libfuzzer-in-process %s | %FileCheck %s
+; Every variable takes its special value from a seed where they are all
+; special.
+(declare-fun a () (_ FloatingPoint 11 53))
+(declare-fun b () (_ FloatingPoint 8 24))
+(declare-fun c () (_ BitVec 32))
+(assert (fp.isInfinite a))
+(assert (fp.isNegative a))
+(assert (fp.isInfinite b))
+(assert (fp.isNegative b))
+(assert (= c #x80000000))
+(check-sat)
+; CHECK-SEEDS: (LibFuzzerInvocationManager Adding extraSeed0seed)
+; CHECK-NO-SEEDS-NOT: extraSeed
+; CHECK: {{^sat$}}
@@ -0,0 +1,8 @@
+; RUN: %jfs -cxx -cxx-trace-fp-cmp %s | %FileCheck %s
+; RUN: %jfs -cxx -cxx-trace-fp-cmp -libfuzzer-in-process %s | %FileCheck %s
+(declare-fun a () (_ FloatingPoint 8 24))
+(declare-fun b () (_ FloatingPoint 11 53))
+(assert (fp.eq a (fp #b0 #x80 #b10010010000111111011011)))
+(assert (fp.eq b (fp #b1 #b10000000101 #x0c83126e978d5)))
+(check-sat)
+; CHECK: {{^sat$}}
@@ -0,0 +1,13 @@
+; RUN: rm -f %t.yml
+; RUN: %jfs -cxx -fuzz-workers=2 -stats-file=%t.yml %s | %FileCheck %s
+; RUN: %yaml-syntax-check %t.yml
+; RUN: %FileCheck -check-prefix=CHECK-STATS -input-file=%t.yml %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvult a b))
+(assert (bvugt a #x00001000))
+(check-sat)
+; CHECK: {{^sat$}}
+; CHECK-STATS: name: CXXFuzzingSolverWorkers
+; CHECK-STATS-NEXT: num_workers: 2
+; CHECK-STATS-NEXT: winning_worker: {{[01]}}
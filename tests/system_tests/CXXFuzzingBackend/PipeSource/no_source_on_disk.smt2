@@ -0,0 +1,15 @@
+; REQUIRES: dev-shm
+; RUN: rm -rf %t.wd
+; RUN: %jfs -cxx -cxx-pipe-source -v=1 -output-dir=%t.wd -keep-output-dir %s 2>&1 | %FileCheck -check-prefix=CHECK-ARGS %s
+; RUN: %jfs -cxx -cxx-pipe-source %s | %FileCheck %s
+; RUN: test ! -e %t.wd/program.cpp
+; RUN: test ! -e %t.wd/fuzzer
+; RUN: rm -rf %t.wd
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvult a b))
+(assert (bvugt a #x00001000))
+(check-sat)
+; CHECK-ARGS: "-x", "c++", "-", "-x", "none"
+; CHECK-ARGS: "-o", "{{.*}}/jfs-compile-{{[0-9]+}}/fuzzer"
+; CHECK: {{^sat$}}
@@ -0,0 +1,22 @@
+; RUN: %jfs -cxx -v=1 -debug-stop-after-compile %s 2>&1 | %FileCheck -check-prefix=CHECK-PCH %s
+; RUN: %jfs -cxx -v=1 -debug-stop-after-compile -O2 %s 2>&1 | %FileCheck -check-prefix=CHECK-PCH-OPT %s
+; RUN: %jfs -cxx -v=1 -debug-stop-after-compile -libfuzzer-in-process %s 2>&1 | %FileCheck -check-prefix=CHECK-PCH-PIC %s
+; RUN: %jfs -cxx -v=1 -debug-stop-after-compile -runtime-pch=0 %s 2>&1 | %FileCheck -check-prefix=CHECK-NO-PCH %s
+; RUN: %jfs -cxx -runtime-pch %s | %FileCheck %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvult a b))
+(assert (bvugt a #x00001000))
+(check-sat)
+; The PCH is checked once with an empty source file before it is used.
+; CHECK-PCH: "-include-pch", "{{.+}}/pch/Runtime_O0.h.pch", "-fsyntax-only", "-x", "c++", "/dev/null"
+; CHECK-PCH-NOT: rejected precompiled runtime header
+; CHECK-PCH: "-include-pch", "{{.+}}/pch/Runtime_O0.h.pch"
+; CHECK-PCH-OPT: "-include-pch", "{{.+}}/pch/Runtime_O1.h.pch", "-fsyntax-only", "-x", "c++", "/dev/null"
+; CHECK-PCH-OPT-NOT: rejected precompiled runtime header
+; CHECK-PCH-OPT: "-include-pch", "{{.+}}/pch/Runtime_O1.h.pch"
+; CHECK-PCH-PIC: "-include-pch", "{{.+}}/pch/Runtime_O0_PIC.h.pch", "-fsyntax-only", "-x", "c++", "/dev/null"
+; CHECK-PCH-PIC-NOT: rejected precompiled runtime header
+; CHECK-PCH-PIC: "-include-pch", "{{.+}}/pch/Runtime_O0_PIC.h.pch"
+; CHECK-NO-PCH-NOT: -include-pch
+; CHECK: {{^sat$}}
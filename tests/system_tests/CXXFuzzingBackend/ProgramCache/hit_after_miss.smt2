@@ -0,0 +1,21 @@
+; RUN: rm -rf %t.cache %t.1.yml %t.2.yml
+; RUN: %jfs -cxx -cxx-program-cache-dir=%t.cache -stats-file=%t.1.yml %s | %FileCheck %s
+; RUN: %jfs -cxx -cxx-program-cache-dir=%t.cache -stats-file=%t.2.yml %s | %FileCheck %s
+; RUN: %yaml-syntax-check %t.1.yml
+; RUN: %yaml-syntax-check %t.2.yml
+; RUN: %FileCheck -check-prefix=CHECK-MISS -input-file=%t.1.yml %s
+; RUN: %FileCheck -check-prefix=CHECK-HIT -input-file=%t.2.yml %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvult a b))
+(assert (bvugt a #x00001000))
+(check-sat)
+; CHECK: {{^sat$}}
+; CHECK-MISS: name: CXXProgramCache
+; CHECK-MISS-NEXT: hits: 0
+; CHECK-MISS-NEXT: misses: 1
+; CHECK-MISS-NEXT: bytes_saved: 0
+; CHECK-HIT: name: CXXProgramCache
+; CHECK-HIT-NEXT: hits: 1
+; CHECK-HIT-NEXT: misses: 0
+; CHECK-HIT-NEXT: bytes_saved: {{[1-9][0-9]*}}
@@ -0,0 +1,15 @@
+; Queries that only differ in their constants should share a program.
+; RUN: rm -rf %t.cache %t.yml
+; RUN: sed -e 's/#x00001000/#x00000100/' %s > %t.variant.smt2
+; RUN: %jfs -cxx -cxx-lift-constants -cxx-program-cache-dir=%t.cache %s | %FileCheck %s
+; RUN: %jfs -cxx -cxx-lift-constants -cxx-program-cache-dir=%t.cache -stats-file=%t.yml %t.variant.smt2 | %FileCheck %s
+; RUN: %yaml-syntax-check %t.yml
+; RUN: %FileCheck -check-prefix=CHECK-HIT -input-file=%t.yml %s
+(declare-fun a () (_ BitVec 32))
+(declare-fun b () (_ BitVec 32))
+(assert (bvult a b))
+(assert (bvugt a #x00001000))
+(check-sat)
+; CHECK: {{^sat$}}
+; CHECK-HIT: name: CXXProgramCache
+; CHECK-HIT-NEXT: hits: 1
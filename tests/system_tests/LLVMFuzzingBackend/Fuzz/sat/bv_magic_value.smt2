@@ -0,0 +1,7 @@
+; RUN: %jfs -jit -jit-opt-level=0 -jit-max-runs=1000000 %s | %FileCheck %s
+; RUN: %jfs -jit -jit-opt-level=2 -jit-max-runs=1000000 %s | %FileCheck %s
+; Needs the traced comparisons to find the values.
+(declare-fun a () (_ BitVec 64))
+(assert (or (= a #xdeadbeefcafebabe) (= a #x0123456789abcdef)))
+(check-sat)
+; CHECK: {{^sat$}}
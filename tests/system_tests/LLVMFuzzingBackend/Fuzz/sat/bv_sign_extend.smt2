@@ -0,0 +1,9 @@
+; RUN: %jfs -jit -jit-opt-level=0 %s | %FileCheck %s
+; RUN: %jfs -jit -jit-opt-level=2 %s | %FileCheck %s
+(declare-fun buffer_0 () (_ BitVec 8))
+(declare-fun buffer_1 () (_ BitVec 8))
+(assert (bvsle (_ bv48 32) ((_ sign_extend 24) buffer_0)))
+(assert (bvsle ((_ sign_extend 24) buffer_0) (_ bv57 32)))
+(assert (not (= (concat buffer_0 buffer_1) (_ bv0 16))))
+(check-sat)
+; CHECK: {{^sat$}}
@@ -0,0 +1,7 @@
+; RUN: %jfs -jit %s | %FileCheck %s
+(declare-fun a () (_ FloatingPoint 8 24))
+(declare-fun b () (_ FloatingPoint 11 53))
+(assert (fp.lt a (fp #b0 #x86 #b00000000000000000000000)))
+(assert (fp.gt ((_ to_fp 11 53) RNE a) b))
+(check-sat)
+; CHECK: {{^sat$}}
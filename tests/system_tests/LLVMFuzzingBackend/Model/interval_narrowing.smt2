@@ -0,0 +1,13 @@
+; RUN: %jfs -jit -narrow-bv-intervals -get-model %s | %FileCheck %s
+; x is only bounded so it isn't in the buffer once its bounds are removed.
+(declare-fun x () (_ BitVec 32))
+(declare-fun y () (_ BitVec 8))
+(assert (bvuge x #x00000064))
+(assert (bvule x #x000003e8))
+(assert (distinct (bvadd y #x01) #x00))
+(check-sat)
+; CHECK: {{^sat$}}
+; CHECK-NEXT: (model
+; CHECK-NEXT: (define-fun x () (_ BitVec 32) #x00000064)
+; CHECK-NEXT: (define-fun y () (_ BitVec 8) #x{{[0-9a-f]+}})
+; CHECK-NEXT: )
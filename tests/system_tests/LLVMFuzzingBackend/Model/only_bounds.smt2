@@ -0,0 +1,10 @@
+; RUN: %jfs -jit -narrow-bv-intervals -get-model %s | %FileCheck %s
+; Nothing is left to fuzz once the bounds are removed.
+(declare-fun x () (_ BitVec 32))
+(assert (bvuge x #x00000064))
+(assert (bvule x #x000003e8))
+(check-sat)
+; CHECK: {{^sat$}}
+; CHECK-NEXT: (model
+; CHECK-NEXT: (define-fun x () (_ BitVec 32) #x00000064)
+; CHECK-NEXT: )
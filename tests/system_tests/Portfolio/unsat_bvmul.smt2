@@ -0,0 +1,10 @@
+; Either member may answer first (e.g. the fuzzing solver can report unsat
+; without fuzzing) so only check that some member won.
+; RUN: %jfs -portfolio -v=1 %s > %t.stdout 2> %t.stderr
+; RUN: %FileCheck -input-file=%t.stdout %s
+; RUN: %FileCheck -check-prefix=CHECK-WINNER -input-file=%t.stderr %s
+(declare-fun x () (_ BitVec 16))
+(assert (= (bvmul x #x0002) #x0001))
+(check-sat)
+; CHECK: {{^unsat$}}
+; CHECK-WINNER: (PortfolioSolver {{[A-Za-z]+}} won)
@@ -0,0 +1,108 @@
+#include "jfs/FuzzingCommon/BufferAssignmentModel.h"
+#include "jfs/Core/SMTLIB2Parser.h"
+#include "jfs/Transform/QueryPassManager.h"
+#include "gtest/gtest.h"
+#include <memory>
+
+using namespace jfs::core;
+using namespace jfs::fuzzingCommon;
+
+namespace {
+
+class ParserHelper {
+private:
+  std::unique_ptr<JFSContext> ctx;
+  std::unique_ptr<SMTLIB2Parser> parser;
+
+public:
+  ParserHelper() {
+    JFSContextConfig ctxCfg;
+    ctx.reset(new JFSContext(ctxCfg));
+    parser.reset(new SMTLIB2Parser(*ctx));
+  }
+  JFSContext &getContext() { return *ctx; }
+  SMTLIB2Parser &getParser() { return *parser; }
+};
+
+Z3FuncDeclHandle getDecl(JFSContext &ctx, const char *name, Z3_sort sort) {
+  Z3_context z3Ctx = ctx.getZ3Ctx();
+  return Z3FuncDeclHandle(
+      ::Z3_mk_func_decl(z3Ctx, ::Z3_mk_string_symbol(z3Ctx, name), 0, nullptr,
+                        sort),
+      z3Ctx);
+}
+
+uint64_t getBitVectorValue(Z3ASTHandle value) {
+  uint64_t result = 0;
+  EXPECT_TRUE(::Z3_get_numeral_uint64(value.getContext(), value, &result));
+  return result;
+}
+}
+
+TEST(BufferAssignmentModel, decodeAndEqualities) {
+  ParserHelper h;
+  auto query = h.getParser().parseStr(
+      R"(
+    (declare-const a (_ BitVec 8))
+    (declare-const b (_ BitVec 8))
+    (declare-const c (_ BitVec 8))
+    (declare-const d Bool)
+    (assert (= a b))
+    (assert (= c #x07))
+    (assert (distinct (bvadd a #x01) #x00))
+    )");
+  ASSERT_EQ(h.getParser().getErrorCount(), 0UL);
+  ASSERT_NE(query.get(), nullptr);
+  FuzzingAnalysisInfo info;
+  jfs::transform::QueryPassManager pm;
+  info.addTo(pm);
+  pm.run(*query);
+  ASSERT_EQ(info.freeVariableAssignment->bufferAssignment->computeWidth(),
+            8U);
+
+  BufferAssignmentModel model(info, std::vector<uint8_t>{0x2a});
+  JFSContext &ctx = h.getContext();
+  Z3_sort bv8 = ::Z3_mk_bv_sort(ctx.getZ3Ctx(), 8);
+  // Decoded from the buffer
+  ASSERT_EQ(getBitVectorValue(model.getAssignment(getDecl(ctx, "a", bv8))),
+            0x2aUL);
+  // Equal to a
+  ASSERT_EQ(getBitVectorValue(model.getAssignment(getDecl(ctx, "b", bv8))),
+            0x2aUL);
+  // Equal to a constant
+  ASSERT_EQ(getBitVectorValue(model.getAssignment(getDecl(ctx, "c", bv8))),
+            0x07UL);
+  // Unconstrained
+  Z3ASTHandle d = model.getAssignment(
+      getDecl(ctx, "d", ::Z3_mk_bool_sort(ctx.getZ3Ctx())));
+  ASSERT_TRUE(d.isFalse());
+}
+
+TEST(BufferAssignmentModel, decodeFloat) {
+  ParserHelper h;
+  auto query = h.getParser().parseStr(
+      R"(
+    (declare-const f Float32)
+    (assert (fp.isNormal f))
+    )");
+  ASSERT_EQ(h.getParser().getErrorCount(), 0UL);
+  ASSERT_NE(query.get(), nullptr);
+  FuzzingAnalysisInfo info;
+  jfs::transform::QueryPassManager pm;
+  info.addTo(pm);
+  pm.run(*query);
+  ASSERT_EQ(info.freeVariableAssignment->bufferAssignment->computeWidth(),
+            32U);
+
+  // 1.5f
+  BufferAssignmentModel model(info,
+                              std::vector<uint8_t>{0x00, 0x00, 0xc0, 0x3f});
+  JFSContext &ctx = h.getContext();
+  Z3_context z3Ctx = ctx.getZ3Ctx();
+  Z3_sort float32 = ::Z3_mk_fpa_sort_32(z3Ctx);
+  Z3ASTHandle f = model.getAssignment(getDecl(ctx, "f", float32));
+  Z3ASTHandle expected(::Z3_mk_fpa_numeral_float(z3Ctx, 1.5f, float32), z3Ctx);
+  Z3ASTHandle isEqual(
+      ::Z3_simplify(z3Ctx, ::Z3_mk_fpa_eq(z3Ctx, f, expected)), z3Ctx);
+  ASSERT_TRUE(isEqual.isTrue());
+}
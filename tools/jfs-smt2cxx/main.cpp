@@ -41,6 +41,60 @@ llvm::cl::opt<std::string>
     OutputFile("o", llvm::cl::desc("Output file (default stdout)"),
                llvm::cl::init("-"));
 
+llvm::cl::opt<bool> LiftConstants(
+    "lift-constants",
+    llvm::cl::desc("Read constants from a table loaded at start up "
+                   "(default false)"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<unsigned> ConstraintPartitions(
+    "constraint-partitions",
+    llvm::cl::desc("Split the constraints into this many functions each in "
+                   "their own translation unit (default 1)"),
+    llvm::cl::init(1));
+
+llvm::cl::opt<bool> CustomMutator(
+    "custom-mutator",
+    llvm::cl::desc("Define LibFuzzer custom mutators that mutate one free "
+                   "variable at a time (default false)"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> DistanceFeedback(
+    "distance-feedback",
+    llvm::cl::desc("Record how close the input is to satisfying each "
+                   "comparison in LibFuzzer extra counters (default false)"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> TraceFloatComparisons(
+    "trace-fp-cmp",
+    llvm::cl::desc("Trace the raw bits of floating point comparison operands "
+                   "using SanitizerCoverage's trace-cmp hooks (default false)"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> CountSatisfiedConstraints(
+    "count-satisfied-constraints",
+    llvm::cl::desc("Evaluate every constraint and record which ones are "
+                   "satisfied in LibFuzzer extra counters (default false)"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> OrderConstraints(
+    "order-constraints",
+    llvm::cl::desc("Check constraints that are cheap and likely to be false "
+                   "first instead of in query order (default false)"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> RecordRejections(
+    "record-rejections",
+    llvm::cl::desc("Count how many inputs each constraint rejects and write "
+                   "the counts out when the program exits (default false)"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> LazyDecoding(
+    "lazy-decoding",
+    llvm::cl::desc("Decode each free variable right before the first "
+                   "constraint that uses it (default false)"),
+    llvm::cl::init(false));
+
 void printVersion(llvm::raw_ostream& os) {
   os << jfs::support::getVersionString() << "\n";
   os << "\n";
@@ -78,9 +132,20 @@ int main(int argc, char** argv) {
   }
 
   QueryPassManager pm;
-  auto info = std::make_shared<FuzzingAnalysisInfo>();
+  auto info = std::make_shared<FuzzingAnalysisInfo>(OrderConstraints);
   info->addTo(pm);
-  auto programBuilder = std::make_shared<CXXProgramBuilderPass>(info, ctx);
+  CXXProgramBuilderOptions pbOptions;
+  pbOptions.liftConstants = LiftConstants;
+  pbOptions.numConstraintPartitions = ConstraintPartitions;
+  pbOptions.customMutator = CustomMutator;
+  pbOptions.distanceFeedback = DistanceFeedback;
+  pbOptions.traceFloatComparisons = TraceFloatComparisons;
+  pbOptions.countSatisfiedConstraints = CountSatisfiedConstraints;
+  pbOptions.orderConstraintsByCost = OrderConstraints;
+  pbOptions.recordRejections = RecordRejections;
+  pbOptions.lazyDecoding = LazyDecoding;
+  auto programBuilder =
+      std::make_shared<CXXProgramBuilderPass>(info, &pbOptions, ctx);
   pm.add(programBuilder);
   pm.run(*query);
 
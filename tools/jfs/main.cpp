@@ -16,11 +16,15 @@
 #include "jfs/Core/IfVerbose.h"
 #include "jfs/Core/JFSContext.h"
 #include "jfs/Core/JFSTimerMacros.h"
+#include "jfs/Core/PortfolioSolver.h"
 #include "jfs/Core/SMTLIB2Parser.h"
 #include "jfs/Core/ScopedJFSContextErrorHandler.h"
 #include "jfs/Core/ToolErrorHandler.h"
 #include "jfs/FuzzingCommon/CmdLine/LibFuzzerOptionsBuilder.h"
 #include "jfs/FuzzingCommon/DummyFuzzingSolver.h"
+#include "jfs/LLVMFuzzingBackend/CmdLine/LLVMFuzzingSolverOptionsBuilder.h"
+#include "jfs/LLVMFuzzingBackend/LLVMFuzzingSolver.h"
+#include "jfs/LLVMFuzzingBackend/LLVMFuzzingSolverOptions.h"
 #include "jfs/Support/ErrorMessages.h"
 #include "jfs/Support/ScopedTimer.h"
 #include "jfs/Support/StatisticsManager.h"
@@ -73,6 +77,11 @@ llvm::cl::opt<bool> DisableStandardPasses(
     llvm::cl::desc("Do not run standard passes (default false)"),
     llvm::cl::Hidden);
 
+llvm::cl::opt<bool> GetModel(
+    "get-model", llvm::cl::init(false),
+    llvm::cl::desc("Print a model when the query is sat. Only variables left "
+                   "after the standard passes are printed (default false)"));
+
 enum RedirectOutputTy {
   WHEN_NOT_VERBOSE, // Legacy
   REDIRECT,
@@ -99,10 +108,115 @@ llvm::cl::opt<RedirectOutputTy> LibFuzzerOutputRedirect(
     llvm::cl::init(WHEN_NOT_VERBOSE),
     llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
 
+llvm::cl::opt<unsigned> FuzzWorkers(
+    "fuzz-workers",
+    llvm::cl::desc("Number of LibFuzzer instances to run concurrently with "
+                   "different seeds and a shared corpus (default: 1)"),
+    llvm::cl::init(1), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+llvm::cl::opt<bool> FuzzWorkersVaryStrategy(
+    "fuzz-workers-vary-strategy",
+    llvm::cl::desc("Also vary mutation depth and cross over between fuzzing "
+                   "workers (default: false)"),
+    llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<std::string> ProgramCacheDir(
+    "cxx-program-cache-dir",
+    llvm::cl::desc("Directory used to cache compiled fuzzing programs between "
+                   "runs (default: no cache)"),
+    llvm::cl::init(""), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> PipeSourceToClang(
+    "cxx-pipe-source",
+    llvm::cl::desc("Pipe the fuzzing program to Clang instead of writing it to "
+                   "the working directory and keep the compiled program in "
+                   "memory (default: false)"),
+    llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<unsigned> RelaxedModelSeedTimeout(
+    "cxx-relaxed-model-seed-timeout",
+    llvm::cl::desc("Milliseconds Z3 is given to solve the query without its "
+                   "floating point constraints. The model is added to the "
+                   "corpus. 0 disables this (default: 0)"),
+    llvm::cl::init(0), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> LiftConstants(
+    "cxx-lift-constants",
+    llvm::cl::desc("Load constants from a table at fuzzer start up so that "
+                   "queries that only differ in their constants share a "
+                   "program (default: false)"),
+    llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<unsigned> ConstraintPartitions(
+    "cxx-constraint-partitions",
+    llvm::cl::desc("Split the constraints into this many functions, each in "
+                   "its own translation unit, that are compiled concurrently "
+                   "(default: 1)"),
+    llvm::cl::init(1), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> CustomMutator(
+    "cxx-custom-mutator",
+    llvm::cl::desc("Mutate the fuzzing input one free variable at a time "
+                   "using mutations suited to the variable's sort "
+                   "(default: false)"),
+    llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> FuzzingDictionary(
+    "cxx-dictionary",
+    llvm::cl::desc("Give LibFuzzer a dictionary built from the constants in "
+                   "the query (default: false)"),
+    llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> DistanceFeedback(
+    "cxx-distance-feedback",
+    llvm::cl::desc("Report how close the input is to satisfying each "
+                   "bitvector/floating point comparison to LibFuzzer as "
+                   "coverage (default: false)"),
+    llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> TraceFloatComparisons(
+    "cxx-trace-fp-cmp",
+    llvm::cl::desc("Pass the raw bits of floating point comparison operands "
+                   "to LibFuzzer's comparison tracing (default: false)"),
+    llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> CountSatisfiedConstraints(
+    "cxx-count-satisfied-constraints",
+    llvm::cl::desc("Evaluate every constraint and report which ones are "
+                   "satisfied to LibFuzzer as coverage, rather than stopping "
+                   "at the first unsatisfied constraint (default: false)"),
+    llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> OrderConstraints(
+    "cxx-order-constraints",
+    llvm::cl::desc("Check constraints that are cheap and likely to be false "
+                   "first (default: false)"),
+    llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> LazyDecoding(
+    "cxx-lazy-decoding",
+    llvm::cl::desc("Decode each free variable right before the first "
+                   "constraint that uses it (default: false)"),
+    llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<unsigned> ProfileWarmUpTime(
+    "cxx-profile-warm-up",
+    llvm::cl::desc("Seconds to fuzz while counting how many inputs each "
+                   "constraint rejects before rebuilding the program with the "
+                   "constraints reordered. 0 disables this (default: 0)"),
+    llvm::cl::init(0), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
+llvm::cl::opt<bool> ProfileWarmUpPGO(
+    "cxx-profile-warm-up-pgo",
+    llvm::cl::desc("Optimize the rebuilt program with a Clang PGO profile "
+                   "collected during the warm up (default: false)"),
+    llvm::cl::init(false), llvm::cl::cat(jfs::cxxfb::cl::CommandLineCategory));
+
 enum BackendTy {
   DUMMY_FUZZING_SOLVER,
   Z3_SOLVER,
   CXX_FUZZING_SOLVER,
+  LLVM_FUZZING_SOLVER,
+  PORTFOLIO_SOLVER,
 };
 
 llvm::cl::opt<BackendTy> SolverBackend(
@@ -110,7 +224,12 @@ llvm::cl::opt<BackendTy> SolverBackend(
     llvm::cl::values(clEnumValN(DUMMY_FUZZING_SOLVER, "dummy", "dummy solver"),
                      clEnumValN(Z3_SOLVER, "z3", "Z3 backend"),
                      clEnumValN(CXX_FUZZING_SOLVER, "cxx",
-                                "CXX fuzzing backend (default)")),
+                                "CXX fuzzing backend (default)"),
+                     clEnumValN(LLVM_FUZZING_SOLVER, "jit",
+                                "LLVM JIT in-process fuzzing backend"),
+                     clEnumValN(PORTFOLIO_SOLVER, "portfolio",
+                                "Race the Z3 backend against the CXX fuzzing "
+                                "backend")),
     llvm::cl::init(CXX_FUZZING_SOLVER));
 }
 
@@ -167,10 +286,60 @@ bool shouldRedirectOutput(RedirectOutputTy rot, JFSContext& ctx) {
   }
 }
 
+std::unique_ptr<Solver> makeCXXFuzzingSolver(
+    JFSContext& ctx,
+    std::unique_ptr<jfs::fuzzingCommon::WorkingDirectoryManager> wdm,
+    llvm::StringRef pathToExecutable) {
+  // Tell ClangOptions to try and infer all paths
+  auto clangOptions =
+      jfs::cxxfb::cl::buildClangOptionsFromCmdLine(pathToExecutable);
+  IF_VERB(ctx, clangOptions->print(ctx.getDebugStream()));
+
+  auto libFuzzerOptions =
+      jfs::fuzzingCommon::cl::buildLibFuzzerOptionsFromCmdLine();
+
+  std::unique_ptr<jfs::cxxfb::CXXProgramBuilderOptions> pbOptions(
+      new jfs::cxxfb::CXXProgramBuilderOptions());
+  pbOptions->liftConstants = LiftConstants;
+  pbOptions->numConstraintPartitions = ConstraintPartitions;
+  pbOptions->customMutator = CustomMutator;
+  pbOptions->buildDictionary = FuzzingDictionary;
+  pbOptions->distanceFeedback = DistanceFeedback;
+  pbOptions->traceFloatComparisons = TraceFloatComparisons;
+  pbOptions->countSatisfiedConstraints = CountSatisfiedConstraints;
+  pbOptions->orderConstraintsByCost = OrderConstraints;
+  pbOptions->lazyDecoding = LazyDecoding;
+
+  std::unique_ptr<jfs::cxxfb::CXXFuzzingSolverOptions> solverOptions(
+      new jfs::cxxfb::CXXFuzzingSolverOptions(std::move(clangOptions),
+                                              std::move(libFuzzerOptions),
+                                              std::move(pbOptions)));
+  // Decide if the clang/LibFuzzer stdout/stderr should be redirected
+  solverOptions->redirectClangOutput =
+      shouldRedirectOutput(ClangOutputRedirect, ctx);
+  solverOptions->redirectLibFuzzerOutput =
+      shouldRedirectOutput(LibFuzzerOutputRedirect, ctx);
+  if (FuzzWorkers == 0) {
+    ctx.getErrorStream() << "(error -fuzz-workers must be at least 1)\n";
+    exit(1);
+  }
+  solverOptions->numFuzzingWorkers = FuzzWorkers;
+  solverOptions->varyFuzzingWorkerStrategy = FuzzWorkersVaryStrategy;
+  solverOptions->programCacheDir = ProgramCacheDir;
+  solverOptions->pipeSourceToClang = PipeSourceToClang;
+  solverOptions->relaxedModelSeedTimeout = RelaxedModelSeedTimeout;
+  solverOptions->profileWarmUpTime = ProfileWarmUpTime;
+  solverOptions->profileWarmUpPGO = ProfileWarmUpPGO;
+
+  return std::unique_ptr<Solver>(new jfs::cxxfb::CXXFuzzingSolver(
+      std::move(solverOptions), std::move(wdm), ctx));
+}
+
 std::unique_ptr<Solver>
 makeSolver(JFSContext& ctx,
            std::unique_ptr<jfs::fuzzingCommon::WorkingDirectoryManager> wdm,
-           llvm::StringRef pathToExecutable) {
+           llvm::StringRef pathToExecutable,
+           JFSContextErrorHandler* errorHandler) {
   std::unique_ptr<Solver> solver;
   switch (SolverBackend) {
   case DUMMY_FUZZING_SOLVER: {
@@ -185,25 +354,38 @@ makeSolver(JFSContext& ctx,
     break;
   }
   case CXX_FUZZING_SOLVER: {
-    // Tell ClangOptions to try and infer all paths
-    auto clangOptions =
-        jfs::cxxfb::cl::buildClangOptionsFromCmdLine(pathToExecutable);
-    IF_VERB(ctx, clangOptions->print(ctx.getDebugStream()));
-
+    solver = makeCXXFuzzingSolver(ctx, std::move(wdm), pathToExecutable);
+    break;
+  }
+  case PORTFOLIO_SOLVER: {
+    std::unique_ptr<SolverOptions> solverOptions(new SolverOptions());
+    std::unique_ptr<PortfolioSolver> portfolio(
+        new PortfolioSolver(std::move(solverOptions), ctx));
+    portfolio->addSolver(
+        makeCXXFuzzingSolver(ctx, std::move(wdm), pathToExecutable),
+        /*solverCtx=*/nullptr);
+    // Z3 contexts are not thread safe so Z3 gets its own context. Statistics
+    // are only gathered from the fuzzing solver's context.
+    JFSContextConfig z3CtxCfg = ctx.getConfig();
+    z3CtxCfg.gathericStatistics = false;
+    std::unique_ptr<JFSContext> z3Ctx(new JFSContext(z3CtxCfg));
+    z3Ctx->registerErrorHandler(errorHandler);
+    std::unique_ptr<SolverOptions> z3SolverOptions(new SolverOptions());
+    std::unique_ptr<Solver> z3Solver(
+        new jfs::z3Backend::Z3Solver(std::move(z3SolverOptions), *z3Ctx));
+    portfolio->addSolver(std::move(z3Solver), std::move(z3Ctx));
+    solver = std::move(portfolio);
+    break;
+  }
+  case LLVM_FUZZING_SOLVER: {
     auto libFuzzerOptions =
         jfs::fuzzingCommon::cl::buildLibFuzzerOptionsFromCmdLine();
-
-    std::unique_ptr<jfs::cxxfb::CXXFuzzingSolverOptions> solverOptions(
-        new jfs::cxxfb::CXXFuzzingSolverOptions(std::move(clangOptions),
-                                                std::move(libFuzzerOptions)));
-    // Decide if the clang/LibFuzzer stdout/stderr should be redirected
-    solverOptions->redirectClangOutput =
-        shouldRedirectOutput(ClangOutputRedirect, ctx);
-    solverOptions->redirectLibFuzzerOutput =
-        shouldRedirectOutput(LibFuzzerOutputRedirect, ctx);
-
-    solver.reset(new jfs::cxxfb::CXXFuzzingSolver(std::move(solverOptions),
-                                                  std::move(wdm), ctx));
+    auto solverOptions =
+        jfs::llvmfb::cl::buildLLVMFuzzingSolverOptionsFromCmdLine(
+            pathToExecutable, std::move(libFuzzerOptions));
+    IF_VERB(ctx, solverOptions->print(ctx.getDebugStream()));
+    solver.reset(new jfs::llvmfb::LLVMFuzzingSolver(std::move(solverOptions),
+                                                    std::move(wdm), ctx));
     break;
   }
   default:
@@ -212,6 +394,17 @@ makeSolver(JFSContext& ctx,
   return solver;
 }
 
+// Print `model` in the style of SMT-LIB's `(get-model)`.
+void printModel(const Query& q, Model& model, llvm::raw_ostream& os) {
+  os << "(model\n";
+  for (const auto& decl : q.getFreeVariables()) {
+    os << "  (define-fun " << decl.getName() << " () "
+       << decl.getSort().toStr() << " " << model.getAssignment(decl).toStr()
+       << ")\n";
+  }
+  os << ")\n";
+}
+
 std::function<void(void)> cancelFn;
 
 void handleInterrupt() {
@@ -265,7 +458,8 @@ int main(int argc, char** argv) {
   std::string pathToExecutable = llvm::sys::fs::getMainExecutable(
       argv[0], reinterpret_cast<void*>(reinterpret_cast<intptr_t>(main)));
   std::unique_ptr<Solver> solver(
-      makeSolver(ctx, makeWorkingDirectory(ctx), pathToExecutable));
+      makeSolver(ctx, makeWorkingDirectory(ctx), pathToExecutable,
+                 &toolHandler));
 
   // Now set up cancel/interrupt handlers. We do this now so that all the
   // objects we need to interact with at cancellation time can be captured in
@@ -328,8 +522,22 @@ int main(int argc, char** argv) {
   if (Verbosity > 0)
     ctx.getDebugStream() << "(using solver \"" << solver->getName() << "\")\n";
 
-  auto response = solver->solve(*query, /*produceModel=*/false);
+  auto response = solver->solve(*query, /*produceModel=*/GetModel);
+  if (!response) {
+    ctx.getErrorStream() << "(error solver \"" << solver->getName()
+                         << "\" failed)\n";
+    return 1;
+  }
   llvm::outs() << SolverResponse::getSatString(response->sat) << "\n";
+  if (GetModel && response->sat == SolverResponse::SAT) {
+    auto model = response->getModel();
+    if (model) {
+      printModel(*query, *model, llvm::outs());
+    } else {
+      ctx.getErrorStream() << "(error solver \"" << solver->getName()
+                           << "\" did not produce a model)\n";
+    }
+  }
 
   // Write statistics out
   if (StatsFilename != "") {